@@ -5,13 +5,15 @@ void UTestUserWidget::NativeConstruct()
 {
     Super::NativeConstruct();
 
-    observable_ = UNRX4Observable::fromEvent(action_);
+    //Rebuild the pipeline in the arena, the previous one is released at once
+    arena_.release();
+    observable_ = UNRX4Observable::fromMulticastDelegate(arena_, onClickDelegate_);
     observable_->subscribe(&observer_);
 }
 
 void UTestUserWidget::invokeClick(int32 id)
 {
-    action_(id);
+    onClickDelegate_.Broadcast(id);
 }
 
 void UTestUserWidget::onClick(int32 id)
@@ -5,8 +5,11 @@
 #include "UNRX4/UNRX4.h"
 #include "UNRX4/UNRX4IObservable.h"
 #include "UNRX4/UNRX4IObserver.h"
+#include "UNRX4/UNRX4PipelineArena.h"
 #include "TestUserWidget.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FUNRX4OnClickMulticastDelegate, int32);
+
 class FuncTestObserver: public UNRX4IObserver<int32>
 {
 public:
@@ -41,8 +44,8 @@ public:
 private:
     void onClick(int32 id);
 
-    UNRX4Function<void(int32)> action_;
-    TArray<FUNRX4OnClickDelegate> onClickDelegates_;
-    unrx4_unique_ptr<UNRX4IObservable<int32>> observable_;
+    FUNRX4OnClickMulticastDelegate onClickDelegate_;
+    UNRX4PipelineArena arena_;
+    UNRX4IObservable<int32>* observable_ = nullptr;
     FuncTestObserver observer_;
 };
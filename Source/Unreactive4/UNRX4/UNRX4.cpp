@@ -17,6 +17,7 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  */
 // clang-format on
 #include "UNRX4.h"
+#include "UNRX4PipelineArena.h"
 #include "UNRX4System.h"
 
 //-------------------
@@ -30,6 +31,16 @@ void unrx4_free(void* ptr)
     UNRX4System::getInstance().deallocate(ptr);
 }
 
+void* unrx4_transient_malloc(size_t size)
+{
+    return UNRX4System::getInstance().allocateTransient(size);
+}
+
+void* unrx4_arena_malloc(UNRX4PipelineArena& arena, size_t size)
+{
+    return arena.allocate(size);
+}
+
 //-------------------
 UNRX4SmallAllocater::UNRX4SmallAllocater()
     : chunkTable_{}
@@ -42,13 +53,14 @@ UNRX4SmallAllocater::~UNRX4SmallAllocater()
     Page* page = pages_;
     while(nullptr != page) {
         Page* nextPage = page->next_;
-        unrx4_free(page);
+        FMemory::Free(page);
         page = nextPage;
     }
 }
 
 void* UNRX4SmallAllocater::allocate(unrx4::size_t size)
 {
+    //The size is in multiples of 32, which leaves unrx4::BlockTag::General in the low bits of the header
     size += Padding;
     unrx4::size_t padded = (size + 31U) & ~31U;
     unrx4::u8* ptr;
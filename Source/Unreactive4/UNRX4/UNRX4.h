@@ -32,16 +32,24 @@ using time_point = FDateTime;
 using s8 = int8;
 using s16 = int16;
 using s32 = int32;
+using s64 = int64;
 
 using u8 = uint8;
 using u16 = uint16;
 using u32 = uint32;
+using u64 = uint64;
 
 using size_t = SIZE_T;
 
 using uintptr_t = UPTRINT;
 } // namespace unrx4
 
+/**
+ * @brief Batch of values which is valid only while being called
+ */
+template<class T>
+using UNRX4Batch = TArrayView<const T>;
+
 //-------------------
 /**
  * @brief Allocate a memory block. This is malloc as default.
@@ -53,6 +61,54 @@ void* unrx4_malloc(size_t size);
 */
 void unrx4_free(void* ptr);
 
+/**
+ * @brief Allocate a memory block which is valid until the end of the frame. Freeing it is a no-op.
+*/
+void* unrx4_transient_malloc(size_t size);
+
+class UNRX4PipelineArena;
+
+/**
+ * @brief Allocate a memory block which is valid until the arena is released. Freeing it is a no-op.
+*/
+void* unrx4_arena_malloc(UNRX4PipelineArena& arena, size_t size);
+
+/**
+ * @brief Tag to construct objects in the frame arena
+*/
+struct unrx4_transient_t
+{
+    explicit unrx4_transient_t() = default;
+};
+constexpr unrx4_transient_t unrx4_transient{};
+
+namespace unrx4
+{
+/**
+ * @brief Kind of a block, which the allocators of the system write in the word just before the block
+ *
+ * The small allocater writes the size of a block there in multiples of 32, so the low bits are zero for its blocks.
+ */
+enum class BlockTag : size_t
+{
+    General = 0,
+    Pipeline = 1,
+    Transient = 2,
+    Heap = 3,
+};
+constexpr size_t BlockTagMask = 31;
+
+inline BlockTag getBlockTag(const void* ptr)
+{
+    return static_cast<BlockTag>(reinterpret_cast<const size_t*>(ptr)[-1] & BlockTagMask);
+}
+
+inline void setBlockTag(void* ptr, BlockTag tag)
+{
+    reinterpret_cast<size_t*>(ptr)[-1] = static_cast<size_t>(tag);
+}
+} // namespace unrx4
+
 //-------------------
 /**
 * @brief Allocate a memory chunk for the reactive system
@@ -105,6 +161,17 @@ T* unrx4_construct(Args&&... args)
     return new(ptr) T(std::forward<Args>(args)...);
 }
 
+/**
+ * @brief Construct a payload in the frame arena, which is never destructed
+*/
+template<class T, class... Args>
+T* unrx4_transient_construct(Args&&... args)
+{
+    static_assert(std::is_trivially_destructible<T>::value, "Transient payloads are not destructed.");
+    void* ptr = unrx4_transient_malloc(sizeof(T));
+    return new(ptr) T(std::forward<Args>(args)...);
+}
+
 template<class T>
 void unrx4_destruct(T* ptr)
 {
@@ -188,6 +255,36 @@ public:
     {
     }
 
+    /**
+     * @brief Construct the holder in the frame arena, for callbacks which finish within the frame
+    */
+    template<class F>
+    UNRX4Function(unrx4_transient_t, F f)
+        : holder_(allocateTransient(f))
+    {
+    }
+
+    /**
+     * @brief Construct the holder in a pipeline arena, for callbacks of a graph which is released with the arena
+    */
+    template<class F>
+    UNRX4Function(UNRX4PipelineArena& arena, F f)
+        : holder_(allocate(arena, f))
+    {
+    }
+
+    template<class F>
+    class node;
+
+    /**
+     * @brief Refer to a node owned by another object, which is neither allocated nor freed by this function
+    */
+    template<class F>
+    explicit UNRX4Function(node<F>& n)
+        : holder_(reinterpret_cast<holder*>(reinterpret_cast<unrx4::uintptr_t>(&n.holder_) | Unowned))
+    {
+    }
+
     ~UNRX4Function()
     {
         deallocate();
@@ -266,6 +363,22 @@ private:
         return new(ptr) function_holder_type(f);
     }
 
+    template<class F>
+    static holder* allocateTransient(F f)
+    {
+        using function_holder_type = function_holder<F>;
+        void* ptr = unrx4_transient_malloc(sizeof(function_holder_type));
+        return new(ptr) function_holder_type(f);
+    }
+
+    template<class F>
+    static holder* allocate(UNRX4PipelineArena& arena, F f)
+    {
+        using function_holder_type = function_holder<F>;
+        void* ptr = unrx4_arena_malloc(arena, sizeof(function_holder_type));
+        return new(ptr) function_holder_type(f);
+    }
+
     template<class R, class T, class... Args>
     static holder* allocate(T* target, R (T::*f)(Args...))
     {
@@ -274,16 +387,47 @@ private:
         return new(ptr) member_holder_type(target, f);
     }
 
+    //Holders are aligned, then the lowest bit of a pointer marks a holder in a node
+    static constexpr unrx4::uintptr_t Unowned = 1;
+
+    holder* get() const
+    {
+        return reinterpret_cast<holder*>(reinterpret_cast<unrx4::uintptr_t>(holder_) & ~Unowned);
+    }
+
     void deallocate();
 
     holder* holder_;
+
+public:
+    /**
+     * @brief Callback embedded in another object, for functions scheduled repeatedly without allocation
+     *
+     * The owner keeps a node alive while functions which refer to it are pending.
+    */
+    template<class F>
+    class node
+    {
+    public:
+        explicit node(F f)
+            : holder_(f)
+        {
+        }
+
+    private:
+        node(const node&) = delete;
+        node& operator=(const node&) = delete;
+
+        friend this_type;
+        function_holder<F> holder_;
+    };
 };
 
 template<class R, class... Args>
 R UNRX4Function<R(Args...)>::operator()(Args... args) const
 {
     UNRX4_ASSERT(nullptr != holder_);
-    return holder_->invoke(std::forward<Args>(args)...);
+    return get()->invoke(std::forward<Args>(args)...);
 }
 
 template<class R, class... Args>
@@ -310,7 +454,9 @@ UNRX4Function<R(Args...)>& UNRX4Function<R(Args...)>::operator=(std::nullptr_t)
 template<class R, class... Args>
 void UNRX4Function<R(Args...)>::deallocate()
 {
-    unrx4_destruct(holder_);
+    if(0 == (reinterpret_cast<unrx4::uintptr_t>(holder_) & Unowned)) {
+        unrx4_destruct(holder_);
+    }
     holder_ = nullptr;
 }
 
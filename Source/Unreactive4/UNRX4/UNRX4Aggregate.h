@@ -0,0 +1,304 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Aggregate.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <Async/ParallelFor.h>
+#include "UNRX4Container.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4IScheduler.h"
+#include "UNRX4ISizedObservable.h"
+
+namespace unrx4
+{
+namespace parallel
+{
+    constexpr unrx4::size_t MinChunkSize = 1024;
+    constexpr unrx4::size_t MaxChunks = 64;
+
+    /**
+     * @brief Chunks depend only on the size, then results do not depend on the number of workers
+     */
+    inline unrx4::size_t chunkSize(unrx4::size_t size)
+    {
+        unrx4::size_t chunk = (size + MaxChunks - 1) / MaxChunks;
+        return chunk < MinChunkSize ? MinChunkSize : chunk;
+    }
+
+    inline unrx4::size_t numChunks(unrx4::size_t size)
+    {
+        unrx4::size_t chunk = chunkSize(size);
+        return (size + chunk - 1) / chunk;
+    }
+
+    /**
+     * @brief Call f(chunkIndex, offset, values) for each chunk on worker threads
+     */
+    template<class T, class F>
+    void forEachChunk(const UNRX4ISizedObservable<T>& source, F f)
+    {
+        unrx4::size_t size = source.size();
+        if(size <= 0) {
+            return;
+        }
+        unrx4::size_t chunk = chunkSize(size);
+        unrx4::size_t chunks = (size + chunk - 1) / chunk;
+        ParallelFor(
+            static_cast<int32>(chunks), [&source, &f, size, chunk](int32 index) {
+                unrx4::size_t offset = static_cast<unrx4::size_t>(index) * chunk;
+                unrx4::size_t count = (size - offset) < chunk ? (size - offset) : chunk;
+                UNRX4SizedScratch<T> scratch;
+                UNRX4Batch<T> values = source.read(offset, count, scratch.prepare(source, count));
+                f(index, offset, values);
+                scratch.release(values);
+            },
+            chunks <= 1);
+    }
+
+    /**
+     * @brief Fold each chunk from the seed, then combine partial results in the order of chunks
+     * @param seed ... The identity of combine, because every chunk starts from it
+     */
+    template<class T, class A, class F, class C>
+    A aggregate(const UNRX4ISizedObservable<T>& source, const A& seed, F accumulate, C combine)
+    {
+        TArray<A> partials;
+        partials.Init(seed, static_cast<int32>(numChunks(source.size())));
+        forEachChunk(source, [&partials, &seed, &accumulate](int32 index, unrx4::size_t, const UNRX4Batch<T>& values) {
+            A result = seed;
+            for(const T& value: values) {
+                result = accumulate(result, value);
+            }
+            partials[index] = MoveTemp(result);
+        });
+        A result = seed;
+        for(const A& partial: partials) {
+            result = combine(result, partial);
+        }
+        return result;
+    }
+
+    template<class T, class F>
+    TOptional<T> reduce(const UNRX4ISizedObservable<T>& source, F f)
+    {
+        TArray<TOptional<T>> partials;
+        partials.SetNum(static_cast<int32>(numChunks(source.size())));
+        forEachChunk(source, [&partials, &f](int32 index, unrx4::size_t, const UNRX4Batch<T>& values) {
+            T result = values[0];
+            for(int32 i = 1; i < values.Num(); ++i) {
+                result = f(result, values[i]);
+            }
+            partials[index].Emplace(MoveTemp(result));
+        });
+        TOptional<T> result;
+        for(const TOptional<T>& partial: partials) {
+            if(result.IsSet()) {
+                result.Emplace(f(result.GetValue(), partial.GetValue()));
+            } else {
+                result = partial;
+            }
+        }
+        return result;
+    }
+
+    template<class T>
+    TArray<T> toArray(const UNRX4ISizedObservable<T>& source)
+    {
+        TArray<T> result;
+        result.AddUninitialized(static_cast<int32>(source.size()));
+        T* items = result.GetData();
+        forEachChunk(source, [items](int32, unrx4::size_t offset, const UNRX4Batch<T>& values) {
+            for(int32 i = 0; i < values.Num(); ++i) {
+                new(&items[offset + i]) T(values[i]);
+            }
+        });
+        return result;
+    }
+} // namespace parallel
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Emit one result of a computation, then complete
+ *
+ * With a scheduler, the computation runs on it, and observers receive the result there.
+ * Sources should outlive scheduled computations.
+ */
+template<class A>
+class UNRX4ObservableTerminal: public UNRX4IObservable<A>
+{
+public:
+    using this_type = UNRX4ObservableTerminal<A>;
+    using observer_type = UNRX4IObserver<A>;
+    using compute_type = UNRX4Function<TOptional<A>()>;
+
+    UNRX4ObservableTerminal(compute_type&& compute, UNRX4IScheduler* scheduler);
+    virtual ~UNRX4ObservableTerminal();
+
+    virtual void subscribe(UNRX4IObserver<A>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<A>* observer) override;
+    virtual void next(A) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+private:
+    struct State
+    {
+        FCriticalSection lock_;
+        this_type* owner_;
+    };
+    using state_type = TSharedRef<State, ESPMode::ThreadSafe>;
+
+    void run(observer_type* observer);
+
+    state_type state_;
+    compute_type compute_;
+    UNRX4IScheduler* scheduler_;
+    UNRX4Array<observer_type*> pending_;
+};
+
+template<class A>
+UNRX4ObservableTerminal<A>::UNRX4ObservableTerminal(compute_type&& compute, UNRX4IScheduler* scheduler)
+    : state_(MakeShared<State, ESPMode::ThreadSafe>())
+    , compute_(std::move(compute))
+    , scheduler_(scheduler)
+{
+    state_->owner_ = this;
+}
+
+template<class A>
+UNRX4ObservableTerminal<A>::~UNRX4ObservableTerminal()
+{
+    //Wait for a running computation
+    FScopeLock lock(&state_->lock_);
+    state_->owner_ = nullptr;
+}
+
+template<class A>
+void UNRX4ObservableTerminal<A>::subscribe(UNRX4IObserver<A>* observer)
+{
+    if(nullptr == scheduler_) {
+        run(observer);
+        return;
+    }
+    {
+        FScopeLock lock(&state_->lock_);
+        pending_.push_back(observer);
+    }
+    scheduler_->schedule(UNRX4Action([state = state_, observer]() {
+        FScopeLock lock(&state->lock_);
+        if(nullptr == state->owner_) {
+            return;
+        }
+        this_type* owner = state->owner_;
+        unrx4::size_t size = owner->pending_.size();
+        owner->pending_.remove(observer);
+        if(size == owner->pending_.size()) {
+            return;
+        }
+        owner->run(observer);
+    }));
+}
+
+template<class A>
+void UNRX4ObservableTerminal<A>::unsubscribe(UNRX4IObserver<A>* observer)
+{
+    FScopeLock lock(&state_->lock_);
+    pending_.remove(observer);
+}
+
+template<class A>
+void UNRX4ObservableTerminal<A>::run(observer_type* observer)
+{
+    TOptional<A> result = compute_();
+    if(result.IsSet()) {
+        observer->next(result.GetValue());
+    }
+    observer->completed();
+}
+
+//-------------------
+/**
+ * @brief Terminal operators over sized sources, which split work into chunks for ParallelFor
+ *
+ * Functions should be associative, then partial results are combined in the order of chunks.
+ */
+class UNRX4Aggregate
+{
+public:
+    /**
+     * @param seed ... The identity of combine
+     */
+    template<class T, class A, class F, class C>
+    static unrx4_unique_ptr<UNRX4IObservable<A>> aggregate(UNRX4ISizedObservable<T>* source, A seed, F accumulate, C combine, UNRX4IScheduler* scheduler = nullptr);
+
+    /**
+     * @brief Emit nothing for an empty source
+     */
+    template<class T, class F>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> reduce(UNRX4ISizedObservable<T>* source, F f, UNRX4IScheduler* scheduler = nullptr);
+
+    template<class T, class P>
+    static unrx4_unique_ptr<UNRX4IObservable<unrx4::size_t>> count(UNRX4ISizedObservable<T>* source, P predicate, UNRX4IScheduler* scheduler = nullptr);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<TArray<T>>> toArray(UNRX4ISizedObservable<T>* source, UNRX4IScheduler* scheduler = nullptr);
+};
+
+template<class T, class A, class F, class C>
+unrx4_unique_ptr<UNRX4IObservable<A>> UNRX4Aggregate::aggregate(UNRX4ISizedObservable<T>* source, A seed, F accumulate, C combine, UNRX4IScheduler* scheduler)
+{
+    UNRX4_ASSERT(nullptr != source);
+    typename UNRX4ObservableTerminal<A>::compute_type compute([source, seed, accumulate, combine]() {
+        return TOptional<A>(unrx4::parallel::aggregate(*source, seed, accumulate, combine));
+    });
+    return unrx4_make_unique<UNRX4ObservableTerminal<A>>(std::move(compute), scheduler);
+}
+
+template<class T, class F>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Aggregate::reduce(UNRX4ISizedObservable<T>* source, F f, UNRX4IScheduler* scheduler)
+{
+    UNRX4_ASSERT(nullptr != source);
+    typename UNRX4ObservableTerminal<T>::compute_type compute([source, f]() {
+        return unrx4::parallel::reduce(*source, f);
+    });
+    return unrx4_make_unique<UNRX4ObservableTerminal<T>>(std::move(compute), scheduler);
+}
+
+template<class T, class P>
+unrx4_unique_ptr<UNRX4IObservable<unrx4::size_t>> UNRX4Aggregate::count(UNRX4ISizedObservable<T>* source, P predicate, UNRX4IScheduler* scheduler)
+{
+    return aggregate(
+        source, static_cast<unrx4::size_t>(0),
+        [predicate](unrx4::size_t count, const T& value) {
+            return predicate(value) ? count + 1 : count;
+        },
+        [](unrx4::size_t x0, unrx4::size_t x1) {
+            return x0 + x1;
+        },
+        scheduler);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<TArray<T>>> UNRX4Aggregate::toArray(UNRX4ISizedObservable<T>* source, UNRX4IScheduler* scheduler)
+{
+    UNRX4_ASSERT(nullptr != source);
+    typename UNRX4ObservableTerminal<TArray<T>>::compute_type compute([source]() {
+        return TOptional<TArray<T>>(unrx4::parallel::toArray(*source));
+    });
+    return unrx4_make_unique<UNRX4ObservableTerminal<TArray<T>>>(std::move(compute), scheduler);
+}
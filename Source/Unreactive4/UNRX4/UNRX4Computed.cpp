@@ -0,0 +1,410 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Computed.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Computed.h"
+#include "UNRX4System.h"
+#include "UNRX4Trace.h"
+
+namespace
+{
+    /**
+     * @brief The node computing on this thread, which reads record dependencies into
+     */
+    thread_local UNRX4SignalNode* unrx4_internal_computing_ = nullptr;
+
+    template<class T>
+    bool unrx4_internal_contains(const UNRX4Array<T*>& array, const T* value)
+    {
+        for(unrx4::size_t i = 0; i < array.size(); ++i) {
+            if(value == array[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+//-------------------
+UNRX4SignalNode::UNRX4SignalNode(bool source)
+    : changedAt_(0)
+    , computedAt_(0)
+    , verifiedAt_(0)
+    , emittedAt_(0)
+    , height_(0)
+    , necessary_(0)
+    , source_(source)
+    , queued_(false)
+    , computing_(false)
+{
+}
+
+UNRX4SignalNode::~UNRX4SignalNode()
+{
+    if(queued_) {
+        UNRX4System::getInstance().signalGraph().remove(this);
+    }
+    for(unrx4::size_t i = 0; i < dependencies_.size(); ++i) {
+        UNRX4SignalNode* dependency = dependencies_[i];
+        dependency->dependents_.remove(this);
+        if(0 < necessary_) {
+            dependency->removeNecessary();
+        }
+    }
+    for(unrx4::size_t i = 0; i < dependents_.size(); ++i) {
+        dependents_[i]->dependencies_.remove(this);
+    }
+}
+
+unrx4::u32 UNRX4SignalNode::height() const
+{
+    return height_;
+}
+
+bool UNRX4SignalNode::isNecessary() const
+{
+    return 0 < necessary_;
+}
+
+unrx4::size_t UNRX4SignalNode::numDependencies() const
+{
+    return dependencies_.size();
+}
+
+unrx4::size_t UNRX4SignalNode::numDependents() const
+{
+    return dependents_.size();
+}
+
+void UNRX4SignalNode::track()
+{
+    UNRX4SignalNode* computing = unrx4_internal_computing_;
+    if(nullptr != computing && this != computing) {
+        computing->addDependency(this);
+    }
+}
+
+void UNRX4SignalNode::update()
+{
+    unrx4::u64 stamp = UNRX4System::getInstance().signalGraph().stamp();
+    if(source_ || stamp == verifiedAt_) {
+        return;
+    }
+    //A node reading itself through its dependencies
+    UNRX4_ASSERT(!computing_);
+    bool stale = computedAt_ <= 0;
+    for(unrx4::size_t i = 0; !stale && i < dependencies_.size(); ++i) {
+        UNRX4SignalNode* dependency = dependencies_[i];
+        dependency->update();
+        stale = computedAt_ < dependency->changedAt_;
+    }
+    if(stale) {
+        evaluate();
+    }
+    verifiedAt_ = stamp;
+}
+
+void UNRX4SignalNode::changed()
+{
+    UNRX4SignalGraph& graph = UNRX4System::getInstance().signalGraph();
+    changedAt_ = graph.advance();
+    computedAt_ = changedAt_;
+    verifiedAt_ = changedAt_;
+    graph.enqueue(this);
+    graph.request();
+}
+
+void UNRX4SignalNode::observe()
+{
+    addNecessary();
+    update();
+    emittedAt_ = changedAt_;
+}
+
+void UNRX4SignalNode::unobserve()
+{
+    removeNecessary();
+}
+
+void UNRX4SignalNode::evaluate()
+{
+    UNRX4_TRACE_SCOPE("UNRX4SignalNode::evaluate");
+    unrx4::u64 stamp = UNRX4System::getInstance().signalGraph().stamp();
+    computing_ = true;
+    collecting_.clear();
+    UNRX4SignalNode* previous = unrx4_internal_computing_;
+    unrx4_internal_computing_ = this;
+    bool changed = recompute();
+    unrx4_internal_computing_ = previous;
+    computing_ = false;
+
+    //Dependencies can differ for each computation, e.g. branches
+    for(unrx4::size_t i = 0; i < dependencies_.size(); ++i) {
+        UNRX4SignalNode* dependency = dependencies_[i];
+        if(unrx4_internal_contains(collecting_, dependency)) {
+            continue;
+        }
+        dependency->dependents_.remove(this);
+        if(0 < necessary_) {
+            dependency->removeNecessary();
+        }
+    }
+    unrx4::u32 height = 0;
+    for(unrx4::size_t i = 0; i < collecting_.size(); ++i) {
+        UNRX4SignalNode* dependency = collecting_[i];
+        height = height <= dependency->height_ ? dependency->height_ + 1 : height;
+        if(unrx4_internal_contains(dependencies_, dependency)) {
+            continue;
+        }
+        dependency->dependents_.push_back(this);
+        if(0 < necessary_) {
+            dependency->addNecessary();
+        }
+    }
+    std::swap(dependencies_, collecting_);
+    raiseHeight(height);
+
+    computedAt_ = stamp;
+    if(changed) {
+        changedAt_ = stamp;
+    }
+}
+
+void UNRX4SignalNode::addDependency(UNRX4SignalNode* node)
+{
+    if(!unrx4_internal_contains(collecting_, node)) {
+        collecting_.push_back(node);
+    }
+}
+
+void UNRX4SignalNode::addNecessary()
+{
+    if(1 != ++necessary_) {
+        return;
+    }
+    for(unrx4::size_t i = 0; i < dependencies_.size(); ++i) {
+        dependencies_[i]->addNecessary();
+    }
+}
+
+void UNRX4SignalNode::removeNecessary()
+{
+    UNRX4_ASSERT(0 < necessary_);
+    if(0 != --necessary_) {
+        return;
+    }
+    for(unrx4::size_t i = 0; i < dependencies_.size(); ++i) {
+        dependencies_[i]->removeNecessary();
+    }
+}
+
+void UNRX4SignalNode::raiseHeight(unrx4::u32 height)
+{
+    //Heights never decrease, queued entries of old heights are requeued when popped
+    if(height <= height_) {
+        return;
+    }
+    UNRX4_ASSERT(height < MaxHeight);
+    height_ = height;
+    for(unrx4::size_t i = 0; i < dependents_.size(); ++i) {
+        dependents_[i]->raiseHeight(height + 1);
+    }
+}
+
+//-------------------
+UNRX4SignalGraph::UNRX4SignalGraph()
+    : stamp_(1)
+    , batch_(0)
+    , scheduled_(false)
+    , propagating_(false)
+    , scheduler_(nullptr)
+{
+}
+
+UNRX4SignalGraph::~UNRX4SignalGraph()
+{
+    clear();
+}
+
+void UNRX4SignalGraph::setScheduler(UNRX4IScheduler* scheduler)
+{
+    scheduler_ = scheduler;
+}
+
+unrx4::size_t UNRX4SignalGraph::propagate()
+{
+    if(propagating_) {
+        return 0;
+    }
+    UNRX4_TRACE_SCOPE("UNRX4SignalGraph::propagate");
+    propagating_ = true;
+    unrx4::size_t count = 0;
+    while(0 < heap_.size()) {
+        Entry entry = pop();
+        UNRX4SignalNode* node = entry.node_;
+        if(nullptr == node) {
+            continue;
+        }
+        if(entry.height_ != node->height_) {
+            push({node->height_, node});
+            continue;
+        }
+        node->queued_ = false;
+        if(node->necessary_ <= 0) {
+            continue;
+        }
+        node->update();
+        ++count;
+        //Observers may have pulled the node already, then it is emitted here once
+        if(node->emittedAt_ < node->changedAt_) {
+            node->emittedAt_ = node->changedAt_;
+            for(unrx4::size_t i = 0; i < node->dependents_.size(); ++i) {
+                enqueue(node->dependents_[i]);
+            }
+            node->emit();
+        }
+    }
+    propagating_ = false;
+    return count;
+}
+
+void UNRX4SignalGraph::beginBatch()
+{
+    ++batch_;
+}
+
+void UNRX4SignalGraph::endBatch()
+{
+    UNRX4_ASSERT(0 < batch_);
+    if(0 == --batch_ && 0 < heap_.size()) {
+        request();
+    }
+}
+
+unrx4::u64 UNRX4SignalGraph::stamp() const
+{
+    return stamp_;
+}
+
+void UNRX4SignalGraph::clear()
+{
+    for(unrx4::size_t i = 0; i < heap_.size(); ++i) {
+        if(nullptr != heap_[i].node_) {
+            heap_[i].node_->queued_ = false;
+        }
+    }
+    heap_.clear();
+    heap_.shrink_to_fit();
+}
+
+unrx4::u64 UNRX4SignalGraph::advance()
+{
+    return ++stamp_;
+}
+
+void UNRX4SignalGraph::enqueue(UNRX4SignalNode* node)
+{
+    if(node->queued_ || node->necessary_ <= 0) {
+        return;
+    }
+    node->queued_ = true;
+    push({node->height_, node});
+}
+
+void UNRX4SignalGraph::remove(UNRX4SignalNode* node)
+{
+    //Leave a hole, which is skipped when popped
+    for(unrx4::size_t i = 0; i < heap_.size(); ++i) {
+        if(node == heap_[i].node_) {
+            heap_[i].node_ = nullptr;
+        }
+    }
+    node->queued_ = false;
+}
+
+void UNRX4SignalGraph::request()
+{
+    if(0 < batch_ || propagating_) {
+        return;
+    }
+    if(nullptr == scheduler_) {
+        propagate();
+        return;
+    }
+    if(scheduled_) {
+        return;
+    }
+    scheduled_ = true;
+    scheduler_->schedule(UNRX4Action([this]() {
+        scheduled_ = false;
+        propagate();
+    }));
+}
+
+void UNRX4SignalGraph::push(const Entry& entry)
+{
+    heap_.push_back(entry);
+    unrx4::size_t index = heap_.size() - 1;
+    while(0 < index) {
+        unrx4::size_t parent = (index - 1) >> 1;
+        if(heap_[parent].height_ <= entry.height_) {
+            break;
+        }
+        heap_[index] = heap_[parent];
+        index = parent;
+    }
+    heap_[index] = entry;
+}
+
+UNRX4SignalGraph::Entry UNRX4SignalGraph::pop()
+{
+    Entry top = heap_[0];
+    Entry last = heap_[heap_.size() - 1];
+    heap_.pop_back();
+    unrx4::size_t size = heap_.size();
+    if(size <= 0) {
+        return top;
+    }
+    unrx4::size_t index = 0;
+    for(;;) {
+        unrx4::size_t child = (index << 1) + 1;
+        if(size <= child) {
+            break;
+        }
+        if((child + 1) < size && heap_[child + 1].height_ < heap_[child].height_) {
+            ++child;
+        }
+        if(last.height_ <= heap_[child].height_) {
+            break;
+        }
+        heap_[index] = heap_[child];
+        index = child;
+    }
+    heap_[index] = last;
+    return top;
+}
+
+//-------------------
+UNRX4SignalBatch::UNRX4SignalBatch()
+{
+    UNRX4System::getInstance().signalGraph().beginBatch();
+}
+
+UNRX4SignalBatch::~UNRX4SignalBatch()
+{
+    UNRX4System::getInstance().signalGraph().endBatch();
+}
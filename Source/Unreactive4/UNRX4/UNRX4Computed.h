@@ -0,0 +1,466 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Computed.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4Distinct.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4IScheduler.h"
+
+class UNRX4SignalGraph;
+
+//-------------------
+/**
+ * @brief A vertex of the signal graph
+ *
+ * Dependencies are recorded while a node computes, by reading other nodes with get.
+ * Each node has a height greater than its dependencies, so propagation in order of heights recomputes a node after all of its inputs.
+ * Nodes which are observed, or on which observed nodes depend, are necessary and recomputed eagerly.
+ * Other nodes are only marked by the global stamp, and recompute when read.
+ * Dependents should be destroyed before their dependencies.
+ */
+UNREACTIVE4_API
+class UNRX4SignalNode
+{
+public:
+    static constexpr unrx4::u32 MaxHeight = 1024;
+
+    unrx4::u32 height() const;
+    bool isNecessary() const;
+    unrx4::size_t numDependencies() const;
+    unrx4::size_t numDependents() const;
+
+protected:
+    friend class UNRX4SignalGraph;
+
+    explicit UNRX4SignalNode(bool source);
+    virtual ~UNRX4SignalNode();
+
+    /**
+     * @brief Record this node as a dependency of the node computing on this thread
+     */
+    void track();
+
+    /**
+     * @brief Bring this node up to date, recompute only if a dependency has changed since the last computation
+     */
+    void update();
+
+    /**
+     * @brief A source has been written, schedule propagation to necessary dependents
+     */
+    void changed();
+
+    /**
+     * @brief Become necessary while observed, then compute at once to know dependencies
+     */
+    void observe();
+    void unobserve();
+
+    /**
+     * @return Whether the value has changed
+     */
+    virtual bool recompute() = 0;
+
+    /**
+     * @brief Notify observers of the current value
+     */
+    virtual void emit() = 0;
+
+private:
+    UNRX4SignalNode(const UNRX4SignalNode&) = delete;
+    UNRX4SignalNode& operator=(const UNRX4SignalNode&) = delete;
+
+    void evaluate();
+    void addDependency(UNRX4SignalNode* node);
+    void addNecessary();
+    void removeNecessary();
+    void raiseHeight(unrx4::u32 height);
+
+    UNRX4Array<UNRX4SignalNode*> dependencies_;
+    UNRX4Array<UNRX4SignalNode*> dependents_;
+    UNRX4Array<UNRX4SignalNode*> collecting_;
+    unrx4::u64 changedAt_;
+    unrx4::u64 computedAt_;
+    unrx4::u64 verifiedAt_;
+    unrx4::u64 emittedAt_;
+    unrx4::u32 height_;
+    unrx4::s32 necessary_;
+    bool source_;
+    bool queued_;
+    bool computing_;
+};
+
+//-------------------
+/**
+ * @brief Queue of necessary nodes ordered by heights, which UNRX4System owns
+ *
+ * Propagation runs at the end of a write, at the end of the outermost UNRX4SignalBatch, or as one action of the scheduler if one is set.
+ * The graph should be used on one thread, typically the game thread.
+ */
+UNREACTIVE4_API
+class UNRX4SignalGraph
+{
+public:
+    UNRX4SignalGraph();
+    ~UNRX4SignalGraph();
+
+    /**
+     * @brief Defer propagation to actions of a scheduler, e.g. the current thread scheduler, or nullptr to propagate at once
+     */
+    void setScheduler(UNRX4IScheduler* scheduler);
+
+    /**
+     * @brief Recompute and emit queued nodes in order of heights
+     * @return The number of updated nodes
+     */
+    unrx4::size_t propagate();
+
+    void beginBatch();
+    void endBatch();
+
+    /**
+     * @brief Incremented at each write of a source
+     */
+    unrx4::u64 stamp() const;
+
+    void clear();
+
+private:
+    friend class UNRX4SignalNode;
+
+    UNRX4SignalGraph(const UNRX4SignalGraph&) = delete;
+    UNRX4SignalGraph& operator=(const UNRX4SignalGraph&) = delete;
+
+    struct Entry
+    {
+        unrx4::u32 height_;
+        UNRX4SignalNode* node_;
+    };
+
+    unrx4::u64 advance();
+    void enqueue(UNRX4SignalNode* node);
+    void remove(UNRX4SignalNode* node);
+    void request();
+    void push(const Entry& entry);
+    Entry pop();
+
+    unrx4::u64 stamp_;
+    unrx4::s32 batch_;
+    bool scheduled_;
+    bool propagating_;
+    UNRX4IScheduler* scheduler_;
+    UNRX4Array<Entry> heap_;
+};
+
+//-------------------
+/**
+ * @brief Defer propagation until the end of the scope, then dependents recompute once for all writes
+ */
+UNREACTIVE4_API
+class UNRX4SignalBatch
+{
+public:
+    UNRX4SignalBatch();
+    ~UNRX4SignalBatch();
+
+private:
+    UNRX4SignalBatch(const UNRX4SignalBatch&) = delete;
+    UNRX4SignalBatch& operator=(const UNRX4SignalBatch&) = delete;
+};
+
+//-------------------
+/**
+ * @brief A writable source of the signal graph
+ */
+template<class T, class Equal = UNRX4EqualTo<T>>
+class UNRX4Signal: public UNRX4IObservable<T>, public UNRX4SignalNode
+{
+public:
+    using observer_type = UNRX4IObserver<T>;
+
+    explicit UNRX4Signal(const T& value = T(), Equal equal = Equal());
+    virtual ~UNRX4Signal();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+
+    /**
+     * @brief Same as set
+     */
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Read the value, and depend on this signal if called while computing
+     */
+    const T& get();
+
+    /**
+     * @brief Write a value, equal values are ignored
+     */
+    void set(T value);
+
+private:
+    virtual bool recompute() override;
+    virtual void emit() override;
+
+    UNRX4Array<observer_type*> observers_;
+    T value_;
+    Equal equal_;
+};
+
+//-------------------
+/**
+ * @brief A value derived from signals and other computed values
+ */
+template<class T, class Equal = UNRX4EqualTo<T>>
+class UNRX4Computed: public UNRX4IObservable<T>, public UNRX4SignalNode
+{
+public:
+    using observer_type = UNRX4IObserver<T>;
+    using compute_type = UNRX4Function<T()>;
+
+    explicit UNRX4Computed(compute_type compute, Equal equal = Equal());
+    virtual ~UNRX4Computed();
+
+    /**
+     * @brief Observers make this node necessary, and receive values which have changed
+     */
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+
+    /**
+     * @brief Ignored, computed values are only derived from their dependencies
+     */
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Read the value after recomputing it if stale, and depend on this node if called while computing
+     */
+    const T& get();
+
+private:
+    virtual bool recompute() override;
+    virtual void emit() override;
+
+    UNRX4Array<observer_type*> observers_;
+    compute_type compute_;
+    TOptional<T> value_;
+    Equal equal_;
+};
+
+//-------------------
+template<class T, class Equal>
+UNRX4Signal<T, Equal>::UNRX4Signal(const T& value, Equal equal)
+    : UNRX4SignalNode(true)
+    , value_(value)
+    , equal_(std::move(equal))
+{
+}
+
+template<class T, class Equal>
+UNRX4Signal<T, Equal>::~UNRX4Signal()
+{
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::subscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.push_back(observer);
+    if(1 == observers_.size()) {
+        observe();
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    unrx4::size_t size = observers_.size();
+    observers_.remove(observer);
+    if(observers_.size() != size && observers_.size() <= 0) {
+        unobserve();
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::next(T value)
+{
+    set(std::move(value));
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::error(unrx4::error_code_type errorCode)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::completed()
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+const T& UNRX4Signal<T, Equal>::get()
+{
+    track();
+    return value_;
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::set(T value)
+{
+    if(equal_(value, value_)) {
+        return;
+    }
+    value_ = std::move(value);
+    changed();
+}
+
+template<class T, class Equal>
+bool UNRX4Signal<T, Equal>::recompute()
+{
+    return false;
+}
+
+template<class T, class Equal>
+void UNRX4Signal<T, Equal>::emit()
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(value_);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+//-------------------
+template<class T, class Equal>
+UNRX4Computed<T, Equal>::UNRX4Computed(compute_type compute, Equal equal)
+    : UNRX4SignalNode(false)
+    , compute_(std::move(compute))
+    , equal_(std::move(equal))
+{
+}
+
+template<class T, class Equal>
+UNRX4Computed<T, Equal>::~UNRX4Computed()
+{
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::subscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.push_back(observer);
+    if(1 == observers_.size()) {
+        observe();
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    unrx4::size_t size = observers_.size();
+    observers_.remove(observer);
+    if(observers_.size() != size && observers_.size() <= 0) {
+        unobserve();
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::next(T)
+{
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::error(unrx4::error_code_type errorCode)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::completed()
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+const T& UNRX4Computed<T, Equal>::get()
+{
+    update();
+    track();
+    return value_.GetValue();
+}
+
+template<class T, class Equal>
+bool UNRX4Computed<T, Equal>::recompute()
+{
+    T value = compute_();
+    if(value_.IsSet() && equal_(value, value_.GetValue())) {
+        return false;
+    }
+    value_ = std::move(value);
+    return true;
+}
+
+template<class T, class Equal>
+void UNRX4Computed<T, Equal>::emit()
+{
+    const T& value = value_.GetValue();
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(value);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
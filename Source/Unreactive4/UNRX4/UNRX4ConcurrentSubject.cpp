@@ -0,0 +1,133 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ConcurrentSubject.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4ConcurrentSubject.h"
+#if !UE_BUILD_SHIPPING
+#    include <Async/Async.h>
+#    include <HAL/IConsoleManager.h>
+
+namespace
+{
+    /**
+     * @brief Count calls, and calls which break the contract of the subject
+     */
+    class UNRX4StressObserver: public UNRX4IObserver<unrx4::s32>
+    {
+    public:
+        UNRX4StressObserver()
+            : subscribed_(false)
+            , terminated_(false)
+            , count_(0)
+            , violations_(0)
+        {
+        }
+
+        virtual void next(unrx4::s32) override
+        {
+            if(!subscribed_.load(std::memory_order_acquire) || terminated_.load(std::memory_order_relaxed)) {
+                violations_.fetch_add(1, std::memory_order_relaxed);
+            }
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        virtual void error(unrx4::error_code_type) override
+        {
+            terminated_.store(true, std::memory_order_relaxed);
+        }
+
+        virtual void completed() override
+        {
+            if(terminated_.exchange(true, std::memory_order_relaxed)) {
+                violations_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<bool> subscribed_;
+        std::atomic<bool> terminated_;
+        std::atomic<unrx4::u64> count_;
+        std::atomic<unrx4::u64> violations_;
+    };
+
+    /**
+     * @brief Producers race a thread which subscribes and unsubscribes, then one of them completes while the others push
+     */
+    FAutoConsoleCommand unrx4_internal_stressConcurrentCommand_(
+        TEXT("unrx4.Stress.ConcurrentSubject"),
+        TEXT("Race producers against subscribe and unsubscribe, run it in a sanitizer build. unrx4.Stress.ConcurrentSubject [producers=8] [events=100000]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+            unrx4::s32 producers = 8;
+            unrx4::s32 events = 100000;
+            if(0 < args.Num()) {
+                producers = FMath::Max(FCString::Atoi(*args[0]), 1);
+            }
+            if(1 < args.Num()) {
+                events = FMath::Max(FCString::Atoi(*args[1]), 1);
+            }
+            UNRX4ConcurrentSubject<unrx4::s32> subject(64);
+            UNRX4StressObserver permanent;
+            permanent.subscribed_.store(true, std::memory_order_release);
+            subject.subscribe(&permanent);
+
+            static constexpr unrx4::s32 NumChurns = 4;
+            UNRX4StressObserver churns[NumChurns];
+            std::atomic<unrx4::s32> running(producers);
+            TArray<TFuture<void>> futures;
+            futures.Add(Async(EAsyncExecution::Thread, [&subject, &running, &churns]() {
+                for(unrx4::u32 i = 0; 0 < running.load(std::memory_order_acquire); ++i) {
+                    UNRX4StressObserver& observer = churns[i % NumChurns];
+                    if(observer.subscribed_.load(std::memory_order_relaxed)) {
+                        subject.unsubscribe(&observer);
+                        observer.subscribed_.store(false, std::memory_order_release);
+                    } else {
+                        observer.subscribed_.store(true, std::memory_order_release);
+                        subject.subscribe(&observer);
+                    }
+                }
+            }));
+            for(unrx4::s32 i = 0; i < producers; ++i) {
+                futures.Add(Async(EAsyncExecution::Thread, [&subject, &running, events, i]() {
+                    for(unrx4::s32 j = 0; j < events; ++j) {
+                        subject.next(j);
+                        if(0 == i && (events / 2) == j) {
+                            subject.completed();
+                        }
+                    }
+                    running.fetch_sub(1, std::memory_order_release);
+                }));
+            }
+            for(TFuture<void>& future: futures) {
+                future.Wait();
+            }
+            unrx4::u64 violations = permanent.violations_.load(std::memory_order_relaxed);
+            for(UNRX4StressObserver& observer: churns) {
+                subject.unsubscribe(&observer);
+                violations += observer.violations_.load(std::memory_order_relaxed);
+            }
+            subject.unsubscribe(&permanent);
+            bool terminated = permanent.terminated_.load(std::memory_order_relaxed);
+            UE_LOG(LogTemp, Log, TEXT("unrx4.Stress.ConcurrentSubject producers:%d delivered:%llu completed:%d violations:%llu"),
+                   producers,
+                   permanent.count_.load(std::memory_order_relaxed),
+                   terminated ? 1 : 0,
+                   violations);
+            if(!terminated || 0 < violations) {
+                UE_LOG(LogTemp, Error, TEXT("unrx4.Stress.ConcurrentSubject failed"));
+            }
+        }));
+} // namespace
+#endif
@@ -0,0 +1,407 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ConcurrentSubject.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4Trace.h"
+#include <atomic>
+
+//-------------------
+/**
+ * @brief Subject which many threads can call next concurrently
+ *
+ * Producers push events into a bounded multi-producer ring buffer without locks.
+ * Delivery is serialized, the producer which wins the drain flag delivers all pending events,
+ * or the owner calls drain if delivery on producers is disabled.
+ * Observers are kept in immutable snapshots, and subscribe replaces the snapshot.
+ * Old snapshots are reclaimed by epochs, then producers and delivery never wait for subscribe and unsubscribe.
+ * unsubscribe waits for the delivery of the current event on another thread, then the observer is not called after it returns.
+ * Events pushed after a terminal event are dropped at delivery.
+ * A full buffer makes producers wait, an observer calling next more than the capacity in a callback never returns.
+ */
+template<class T>
+class UNRX4ConcurrentSubject: public UNRX4IObservable<T>
+{
+public:
+    using observer_type = UNRX4IObserver<T>;
+    static constexpr unrx4::size_t DefaultCapacity = 1024;
+
+    /**
+     * @param capacity ... The number of pending events, rounded up to a power of two
+     * @param deliverOnProducer ... Whether producers deliver, or drain should be called
+     */
+    explicit UNRX4ConcurrentSubject(unrx4::size_t capacity = DefaultCapacity, bool deliverOnProducer = true);
+    virtual ~UNRX4ConcurrentSubject();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Deliver pending events, unless another thread is delivering
+     */
+    void drain();
+
+    unrx4::size_t numObservers() const;
+
+private:
+    UNRX4ConcurrentSubject(const UNRX4ConcurrentSubject&) = delete;
+    UNRX4ConcurrentSubject& operator=(const UNRX4ConcurrentSubject&) = delete;
+
+    static constexpr unrx4::u64 Quiescent = 0;
+
+    enum class Kind : unrx4::u8
+    {
+        Next,
+        Error,
+        Completed,
+    };
+
+    struct Cell
+    {
+        std::atomic<unrx4::size_t> sequence_;
+        Kind kind_;
+        unrx4::error_code_type errorCode_;
+        alignas(T) unrx4::u8 value_[sizeof(T)];
+    };
+
+    struct Snapshot
+    {
+        Snapshot* retired_;
+        unrx4::u64 epoch_;
+        unrx4::size_t size_;
+        observer_type* observers_[1];
+    };
+
+    template<class F>
+    void push(F construct);
+    bool empty() const;
+    void deliver();
+
+    static Snapshot* createSnapshot(unrx4::size_t size);
+
+    /**
+     * @return The epoch which retired the old snapshot
+     */
+    unrx4::u64 publish(Snapshot* snapshot);
+    void reclaim(bool force);
+
+    Cell* cells_;
+    unrx4::size_t mask_;
+    bool deliverOnProducer_;
+    alignas(64) std::atomic<unrx4::size_t> enqueue_;
+    alignas(64) std::atomic<unrx4::size_t> dequeue_;
+    std::atomic<bool> draining_;
+    std::atomic<bool> terminated_;
+    std::atomic<unrx4::u32> drainer_;
+    bool stopped_;
+
+    alignas(64) std::atomic<Snapshot*> snapshot_;
+    std::atomic<unrx4::u64> epoch_;
+    std::atomic<unrx4::u64> readerEpoch_;
+    FCriticalSection writerLock_;
+    Snapshot* retired_;
+};
+
+template<class T>
+UNRX4ConcurrentSubject<T>::UNRX4ConcurrentSubject(unrx4::size_t capacity, bool deliverOnProducer)
+    : cells_(nullptr)
+    , mask_(0)
+    , deliverOnProducer_(deliverOnProducer)
+    , enqueue_(0)
+    , dequeue_(0)
+    , draining_(false)
+    , terminated_(false)
+    , drainer_(0)
+    , stopped_(false)
+    , snapshot_(createSnapshot(0))
+    , epoch_(1)
+    , readerEpoch_(Quiescent)
+    , retired_(nullptr)
+{
+    unrx4::size_t size = 2;
+    while(size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_ = reinterpret_cast<Cell*>(unrx4_malloc(sizeof(Cell) * size));
+    for(unrx4::size_t i = 0; i < size; ++i) {
+        new(&cells_[i].sequence_) std::atomic<unrx4::size_t>(i);
+    }
+}
+
+template<class T>
+UNRX4ConcurrentSubject<T>::~UNRX4ConcurrentSubject()
+{
+    //Destroy events which were not delivered
+    unrx4::size_t position = dequeue_.load(std::memory_order_relaxed);
+    for(;; ++position) {
+        Cell& cell = cells_[position & mask_];
+        if(cell.sequence_.load(std::memory_order_acquire) != (position + 1)) {
+            break;
+        }
+        if(Kind::Next == cell.kind_) {
+            reinterpret_cast<T*>(cell.value_)->~T();
+        }
+    }
+    unrx4_free(cells_);
+    FScopeLock lock(&writerLock_);
+    reclaim(true);
+    unrx4_free(snapshot_.load(std::memory_order_relaxed));
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    FScopeLock lock(&writerLock_);
+    Snapshot* current = snapshot_.load(std::memory_order_relaxed);
+    Snapshot* snapshot = createSnapshot(current->size_ + 1);
+    for(unrx4::size_t i = 0; i < current->size_; ++i) {
+        snapshot->observers_[i] = current->observers_[i];
+    }
+    snapshot->observers_[current->size_] = observer;
+    publish(snapshot);
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    unrx4::u64 retired;
+    {
+        FScopeLock lock(&writerLock_);
+        Snapshot* current = snapshot_.load(std::memory_order_relaxed);
+        unrx4::size_t index = 0;
+        for(; index < current->size_; ++index) {
+            if(observer == current->observers_[index]) {
+                break;
+            }
+        }
+        if(current->size_ <= index) {
+            return;
+        }
+        Snapshot* snapshot = createSnapshot(current->size_ - 1);
+        unrx4::size_t size = 0;
+        for(unrx4::size_t i = 0; i < current->size_; ++i) {
+            if(i != index) {
+                snapshot->observers_[size++] = current->observers_[i];
+            }
+        }
+        retired = publish(snapshot);
+    }
+    //The drainer can hold the old snapshot until it finishes the current event. Observers unsubscribing in callbacks are never called again.
+    if(FPlatformTLS::GetCurrentThreadId() == drainer_.load(std::memory_order_acquire)) {
+        return;
+    }
+    for(;;) {
+        unrx4::u64 reader = readerEpoch_.load();
+        if(Quiescent == reader || retired < reader) {
+            break;
+        }
+        FPlatformProcess::Yield();
+    }
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::next(T value)
+{
+    if(terminated_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    push([&value](Cell& cell) {
+        cell.kind_ = Kind::Next;
+        new(cell.value_) T(std::move(value));
+    });
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::error(unrx4::error_code_type errorCode)
+{
+    if(terminated_.exchange(true)) {
+        return;
+    }
+    push([errorCode](Cell& cell) {
+        cell.kind_ = Kind::Error;
+        cell.errorCode_ = errorCode;
+    });
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::completed()
+{
+    if(terminated_.exchange(true)) {
+        return;
+    }
+    push([](Cell& cell) {
+        cell.kind_ = Kind::Completed;
+    });
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::drain()
+{
+    for(;;) {
+        bool expected = false;
+        if(!draining_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return;
+        }
+        drainer_.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_release);
+        deliver();
+        drainer_.store(0, std::memory_order_release);
+        draining_.store(false, std::memory_order_release);
+        //Events pushed while releasing the flag would be left without this
+        if(empty()) {
+            return;
+        }
+    }
+}
+
+template<class T>
+unrx4::size_t UNRX4ConcurrentSubject<T>::numObservers() const
+{
+    return snapshot_.load(std::memory_order_acquire)->size_;
+}
+
+template<class T>
+template<class F>
+void UNRX4ConcurrentSubject<T>::push(F construct)
+{
+    //Vyukov's bounded queue, a cell is free for the position when its sequence equals to the position
+    unrx4::size_t position = enqueue_.load(std::memory_order_relaxed);
+    for(;;) {
+        Cell& cell = cells_[position & mask_];
+        unrx4::size_t sequence = cell.sequence_.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if(0 == diff) {
+            if(enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                construct(cell);
+                cell.sequence_.store(position + 1, std::memory_order_release);
+                break;
+            }
+        } else if(diff < 0) {
+            //Full
+            if(deliverOnProducer_) {
+                drain();
+            }
+            FPlatformProcess::Yield();
+            position = enqueue_.load(std::memory_order_relaxed);
+        } else {
+            position = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+    if(deliverOnProducer_) {
+        drain();
+    }
+}
+
+template<class T>
+bool UNRX4ConcurrentSubject<T>::empty() const
+{
+    unrx4::size_t position = dequeue_.load(std::memory_order_relaxed);
+    return cells_[position & mask_].sequence_.load(std::memory_order_acquire) != (position + 1);
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::deliver()
+{
+    UNRX4_TRACE_DRAIN("UNRX4ConcurrentSubject::deliver", this, enqueue_.load(std::memory_order_relaxed) - dequeue_.load(std::memory_order_relaxed));
+    //Enter the epoch before reading the snapshot
+    readerEpoch_.store(epoch_.load());
+    Snapshot* snapshot = snapshot_.load();
+    unrx4::size_t position = dequeue_.load(std::memory_order_relaxed);
+    for(;; ++position) {
+        Cell& cell = cells_[position & mask_];
+        if(cell.sequence_.load(std::memory_order_acquire) != (position + 1)) {
+            break;
+        }
+        //A producer can pass the check of terminated_ in next before another one terminates, then its event comes after the terminal one
+        switch(cell.kind_) {
+        case Kind::Next: {
+            T* value = reinterpret_cast<T*>(cell.value_);
+            if(!stopped_) {
+                for(unrx4::size_t i = 0; i < snapshot->size_; ++i) {
+                    snapshot->observers_[i]->next(*value);
+                }
+            }
+            value->~T();
+        } break;
+        case Kind::Error:
+            stopped_ = true;
+            for(unrx4::size_t i = 0; i < snapshot->size_; ++i) {
+                snapshot->observers_[i]->error(cell.errorCode_);
+            }
+            break;
+        case Kind::Completed:
+            stopped_ = true;
+            for(unrx4::size_t i = 0; i < snapshot->size_; ++i) {
+                snapshot->observers_[i]->completed();
+            }
+            break;
+        }
+        //Release the cell for the next round
+        cell.sequence_.store(position + mask_ + 1, std::memory_order_release);
+        dequeue_.store(position + 1, std::memory_order_relaxed);
+        //Pick up snapshots published by observers in callbacks
+        readerEpoch_.store(epoch_.load());
+        snapshot = snapshot_.load();
+    }
+    readerEpoch_.store(Quiescent);
+}
+
+template<class T>
+typename UNRX4ConcurrentSubject<T>::Snapshot* UNRX4ConcurrentSubject<T>::createSnapshot(unrx4::size_t size)
+{
+    unrx4::size_t bytes = sizeof(Snapshot) + sizeof(observer_type*) * (0 < size ? size - 1 : 0);
+    Snapshot* snapshot = reinterpret_cast<Snapshot*>(unrx4_malloc(bytes));
+    snapshot->retired_ = nullptr;
+    snapshot->epoch_ = 0;
+    snapshot->size_ = size;
+    return snapshot;
+}
+
+template<class T>
+unrx4::u64 UNRX4ConcurrentSubject<T>::publish(Snapshot* snapshot)
+{
+    Snapshot* old = snapshot_.exchange(snapshot);
+    unrx4::u64 epoch = epoch_.fetch_add(1);
+    old->epoch_ = epoch;
+    old->retired_ = retired_;
+    retired_ = old;
+    reclaim(false);
+    return epoch;
+}
+
+template<class T>
+void UNRX4ConcurrentSubject<T>::reclaim(bool force)
+{
+    //A snapshot retired at an epoch is unreachable once the reader is quiescent or in a later epoch
+    unrx4::u64 reader = readerEpoch_.load();
+    Snapshot** link = &retired_;
+    while(nullptr != *link) {
+        Snapshot* snapshot = *link;
+        if(force || Quiescent == reader || snapshot->epoch_ < reader) {
+            *link = snapshot->retired_;
+            unrx4_free(snapshot);
+        } else {
+            link = &snapshot->retired_;
+        }
+    }
+}
@@ -39,6 +39,11 @@ public:
     */
     explicit UNRX4Array(unrx4::size_t capacity);
 
+    /**
+     * @brief Construct with a buffer in a pipeline arena, then buffers left by growing stay there until the arena is released
+    */
+    explicit UNRX4Array(UNRX4PipelineArena& arena);
+
     UNRX4Array(UNRX4Array&& other);
     ~UNRX4Array();
 
@@ -48,6 +53,21 @@ public:
     unrx4::size_t size() const;
     void clear();
 
+    /**
+     * @brief Reduce the capacity to the size
+    */
+    void shrink_to_fit();
+
+    /**
+     * @brief Expand the capacity, never shrink
+    */
+    void reserve(unrx4::size_t capacity);
+
+    /**
+     * @brief Change the size, new elements are default constructed
+    */
+    void resize(unrx4::size_t size);
+
     void push_back(const T& x);
     void push_back(T&& x);
 
@@ -68,10 +88,11 @@ private:
     UNRX4Array(const UNRX4Array&) = delete;
     UNRX4Array& operator=(const UNRX4Array&) = delete;
 
-    void resize(unrx4::size_t capacity);
+    void reallocate(unrx4::size_t capacity);
     unrx4::size_t capacity_;
     unrx4::size_t size_;
     T* items_;
+    UNRX4PipelineArena* arena_;
 };
 
 template<class T>
@@ -79,6 +100,7 @@ UNRX4Array<T>::UNRX4Array()
     : capacity_(0)
     , size_(0)
     , items_(nullptr)
+    , arena_(nullptr)
 {
 }
 
@@ -87,8 +109,18 @@ UNRX4Array<T>::UNRX4Array(unrx4::size_t capacity)
     : capacity_(0)
     , size_(0)
     , items_(nullptr)
+    , arena_(nullptr)
+{
+    reallocate(capacity);
+}
+
+template<class T>
+UNRX4Array<T>::UNRX4Array(UNRX4PipelineArena& arena)
+    : capacity_(0)
+    , size_(0)
+    , items_(nullptr)
+    , arena_(&arena)
 {
-    resize(capacity);
 }
 
 template<class T>
@@ -96,6 +128,7 @@ UNRX4Array<T>::UNRX4Array(UNRX4Array&& other)
     : capacity_(other.capacity_)
     , size_(other.size_)
     , items_(other.items_)
+    , arena_(other.arena_)
 {
     other.capacity_ = 0;
     other.size_ = 0;
@@ -106,7 +139,7 @@ template<class T>
 UNRX4Array<T>::~UNRX4Array()
 {
     clear();
-    FMemory::Free(items_);
+    unrx4_free(items_);
     capacity_ = 0;
     size_ = 0;
     items_ = nullptr;
@@ -119,10 +152,11 @@ UNRX4Array<T>& UNRX4Array<T>::operator=(UNRX4Array<T>&& other)
         return *this;
     }
     clear();
-    FMemory::Free(items_);
+    unrx4_free(items_);
     capacity_ = other.capacity_;
     size_ = other.size_;
     items_ = other.items_;
+    arena_ = other.arena_;
     other.capacity_ = 0;
     other.size_ = 0;
     other.items_ = nullptr;
@@ -150,11 +184,48 @@ void UNRX4Array<T>::clear()
     size_ = 0;
 }
 
+template<class T>
+void UNRX4Array<T>::shrink_to_fit()
+{
+    if(capacity_ == size_) {
+        return;
+    }
+    if(size_ <= 0) {
+        unrx4_free(items_);
+        capacity_ = 0;
+        items_ = nullptr;
+        return;
+    }
+    reallocate(size_);
+}
+
+template<class T>
+void UNRX4Array<T>::reserve(unrx4::size_t capacity)
+{
+    if(capacity <= capacity_) {
+        return;
+    }
+    reallocate(capacity);
+}
+
+template<class T>
+void UNRX4Array<T>::resize(unrx4::size_t size)
+{
+    reserve(size);
+    for(unrx4::size_t i = size; i < size_; ++i) {
+        items_[i].~T();
+    }
+    for(unrx4::size_t i = size_; i < size; ++i) {
+        new(&items_[i]) T();
+    }
+    size_ = size;
+}
+
 template<class T>
 void UNRX4Array<T>::push_back(const T& x)
 {
     if(capacity_ <= size_) {
-        resize(capacity_ + Expand);
+        reallocate(capacity_ + Expand);
     }
     new(&items_[size_]) T(x);
     ++size_;
@@ -164,7 +235,7 @@ template<class T>
 void UNRX4Array<T>::push_back(T&& x)
 {
     if(capacity_ <= size_) {
-        resize(capacity_ + Expand);
+        reallocate(capacity_ + Expand);
     }
     new(&items_[size_]) T(std::move(x));
     ++size_;
@@ -250,14 +321,186 @@ T* UNRX4Array<T>::end()
 }
 
 template<class T>
-void UNRX4Array<T>::resize(unrx4::size_t capacity)
+void UNRX4Array<T>::reallocate(unrx4::size_t capacity)
 {
-    T* items = reinterpret_cast<T*>(FMemory::Malloc(capacity * sizeof(T)));
-    for(unrx4::size_t i = 0; i < size_; ++i) {
+    UNRX4_ASSERT(size_ <= capacity);
+    T* items = reinterpret_cast<T*>(nullptr != arena_ ? unrx4_arena_malloc(*arena_, capacity * sizeof(T)) : unrx4_malloc(capacity * sizeof(T)));
+    unrx4::size_t size = size_;
+    for(unrx4::size_t i = 0; i < size; ++i) {
         new(&items[i]) T(std::move(items_[i]));
     }
     clear();
-    FMemory::Free(items_);
+    unrx4_free(items_);
     capacity_ = capacity;
+    size_ = size;
     items_ = items;
 }
+
+//-------------------
+/**
+ * @brief Fixed capacity ring buffer with using this lib's specific allocator, which can be used as a deque.
+ * @tparam T ... Element type
+*/
+template<class T>
+class UNRX4RingBuffer
+{
+public:
+    UNRX4RingBuffer();
+    explicit UNRX4RingBuffer(unrx4::size_t capacity);
+    ~UNRX4RingBuffer();
+
+    unrx4::size_t capacity() const;
+    unrx4::size_t size() const;
+    bool empty() const;
+    bool full() const;
+    void clear();
+
+    /**
+     * @brief Change the capacity, elements are cleared
+    */
+    void reset(unrx4::size_t capacity);
+
+    void push_back(const T& x);
+    void pop_back();
+    void pop_front();
+
+    const T& front() const;
+    const T& back() const;
+
+    /**
+     * @param index ... Index from the front
+    */
+    const T& operator[](unrx4::size_t index) const;
+
+private:
+    UNRX4RingBuffer(const UNRX4RingBuffer&) = delete;
+    UNRX4RingBuffer& operator=(const UNRX4RingBuffer&) = delete;
+
+    unrx4::size_t capacity_;
+    unrx4::size_t size_;
+    unrx4::size_t head_;
+    T* items_;
+};
+
+template<class T>
+UNRX4RingBuffer<T>::UNRX4RingBuffer()
+    : capacity_(0)
+    , size_(0)
+    , head_(0)
+    , items_(nullptr)
+{
+}
+
+template<class T>
+UNRX4RingBuffer<T>::UNRX4RingBuffer(unrx4::size_t capacity)
+    : capacity_(0)
+    , size_(0)
+    , head_(0)
+    , items_(nullptr)
+{
+    reset(capacity);
+}
+
+template<class T>
+UNRX4RingBuffer<T>::~UNRX4RingBuffer()
+{
+    clear();
+    unrx4_free(items_);
+    capacity_ = 0;
+    items_ = nullptr;
+}
+
+template<class T>
+unrx4::size_t UNRX4RingBuffer<T>::capacity() const
+{
+    return capacity_;
+}
+
+template<class T>
+unrx4::size_t UNRX4RingBuffer<T>::size() const
+{
+    return size_;
+}
+
+template<class T>
+bool UNRX4RingBuffer<T>::empty() const
+{
+    return size_ <= 0;
+}
+
+template<class T>
+bool UNRX4RingBuffer<T>::full() const
+{
+    return capacity_ <= size_;
+}
+
+template<class T>
+void UNRX4RingBuffer<T>::clear()
+{
+    while(0 < size_) {
+        pop_front();
+    }
+    head_ = 0;
+}
+
+template<class T>
+void UNRX4RingBuffer<T>::reset(unrx4::size_t capacity)
+{
+    clear();
+    unrx4_free(items_);
+    capacity_ = capacity;
+    items_ = 0 < capacity ? reinterpret_cast<T*>(unrx4_malloc(capacity * sizeof(T))) : nullptr;
+}
+
+template<class T>
+void UNRX4RingBuffer<T>::push_back(const T& x)
+{
+    UNRX4_ASSERT(size_ < capacity_);
+    unrx4::size_t index = head_ + size_;
+    index = capacity_ <= index ? index - capacity_ : index;
+    new(&items_[index]) T(x);
+    ++size_;
+}
+
+template<class T>
+void UNRX4RingBuffer<T>::pop_back()
+{
+    UNRX4_ASSERT(0 < size_);
+    --size_;
+    unrx4::size_t index = head_ + size_;
+    index = capacity_ <= index ? index - capacity_ : index;
+    items_[index].~T();
+}
+
+template<class T>
+void UNRX4RingBuffer<T>::pop_front()
+{
+    UNRX4_ASSERT(0 < size_);
+    items_[head_].~T();
+    --size_;
+    ++head_;
+    head_ = capacity_ <= head_ ? 0 : head_;
+}
+
+template<class T>
+const T& UNRX4RingBuffer<T>::front() const
+{
+    UNRX4_ASSERT(0 < size_);
+    return items_[head_];
+}
+
+template<class T>
+const T& UNRX4RingBuffer<T>::back() const
+{
+    UNRX4_ASSERT(0 < size_);
+    return (*this)[size_ - 1];
+}
+
+template<class T>
+const T& UNRX4RingBuffer<T>::operator[](unrx4::size_t index) const
+{
+    UNRX4_ASSERT(index < size_);
+    index += head_;
+    index = capacity_ <= index ? index - capacity_ : index;
+    return items_[index];
+}
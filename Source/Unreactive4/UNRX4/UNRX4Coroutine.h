@@ -0,0 +1,920 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Coroutine.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4IScheduler.h"
+
+/**
+ * @brief Coroutines are available only if the compiler supports C++20 coroutines
+ *
+ * The module builds with the engine's default standard, then this header is empty there.
+ * Modules which use coroutines set CppStandard = CppStandardVersion.Latest in their own Build.cs.
+ */
+#ifndef UNRX4_COROUTINE_ENABLED
+#    if defined(__cpp_impl_coroutine) && defined(__has_include)
+#        if __has_include(<coroutine>)
+#            define UNRX4_COROUTINE_ENABLED 1
+#        endif
+#    endif
+#endif
+#ifndef UNRX4_COROUTINE_ENABLED
+#    define UNRX4_COROUTINE_ENABLED 0
+#endif
+
+#if UNRX4_COROUTINE_ENABLED
+#    include <coroutine>
+#    include <type_traits>
+#    include <Containers/Ticker.h>
+
+//-------------------
+/**
+ * @brief Allocate coroutine frames with this lib's allocator
+ */
+struct UNRX4PromiseAllocator
+{
+    static void* operator new(size_t size)
+    {
+        return unrx4_malloc(size);
+    }
+
+    static void operator delete(void* ptr)
+    {
+        unrx4_free(ptr);
+    }
+};
+
+//-------------------
+/**
+ * @brief Shared by a coroutine frame and resumptions queued on schedulers, which do nothing after the frame is destroyed
+ */
+class UNRX4ResumeToken
+{
+public:
+    static UNRX4ResumeToken* create(std::coroutine_handle<> handle)
+    {
+        return unrx4_construct<UNRX4ResumeToken>(handle);
+    }
+
+    explicit UNRX4ResumeToken(std::coroutine_handle<> handle)
+        : handle_(handle)
+        , references_(1)
+        , resumption_(Resumption{this})
+    {
+    }
+
+    void acquire()
+    {
+        references_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release()
+    {
+        if(1 == references_.fetch_sub(1, std::memory_order_acq_rel)) {
+            unrx4_destruct(this);
+        }
+    }
+
+    /**
+     * @brief Called when the frame is destroyed, waits for a resumption running on another thread
+     */
+    void cancel()
+    {
+        FScopeLock lock(&lock_);
+        handle_ = nullptr;
+    }
+
+    void resume()
+    {
+        //The lock is recursive, then the coroutine can destroy its own frame while running
+        FScopeLock lock(&lock_);
+        if(nullptr != handle_) {
+            handle_.resume();
+        }
+    }
+
+    /**
+     * @brief An action which resumes and releases once, acquire the token before scheduling it
+     */
+    UNRX4Action resumption()
+    {
+        return UNRX4Action(resumption_);
+    }
+
+private:
+    struct Resumption
+    {
+        void operator()() const
+        {
+            token_->resume();
+            token_->release();
+        }
+
+        UNRX4ResumeToken* token_;
+    };
+
+    FCriticalSection lock_;
+    std::coroutine_handle<> handle_;
+    std::atomic<unrx4::s32> references_;
+    //Queued resumptions refer to this, then a resumption does not allocate
+    UNRX4Action::node<Resumption> resumption_;
+};
+
+/**
+ * @brief Base of promises of this lib, which own the resume token of their frame
+ */
+struct UNRX4Promise: public UNRX4PromiseAllocator
+{
+    UNRX4Promise()
+        : token_(nullptr)
+    {
+    }
+
+    ~UNRX4Promise()
+    {
+        if(nullptr != token_) {
+            token_->cancel();
+            token_->release();
+        }
+    }
+
+    /**
+     * @brief The token is created at the first resumption through a scheduler, and reused for the rest of the coroutine
+     */
+    UNRX4ResumeToken* resumeToken(std::coroutine_handle<> handle)
+    {
+        if(nullptr == token_) {
+            token_ = UNRX4ResumeToken::create(handle);
+        }
+        return token_;
+    }
+
+    UNRX4ResumeToken* token_;
+};
+
+namespace unrx4
+{
+    /**
+     * @brief The resume token of a frame, or null for promises of other libraries
+     */
+    template<class P>
+    UNRX4ResumeToken* resumeToken(std::coroutine_handle<P> handle)
+    {
+        if constexpr(std::is_base_of<UNRX4Promise, P>::value) {
+            return handle.promise().resumeToken(handle);
+        } else {
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Resume a coroutine on a scheduler, or immediately if the scheduler is null
+     *
+     * A queued resumption holds the token instead of the frame, then cancelling a task while it is queued is safe.
+     */
+    inline void resumeOn(UNRX4IScheduler* scheduler, std::coroutine_handle<> handle, UNRX4ResumeToken* token)
+    {
+        if(nullptr == scheduler) {
+            handle.resume();
+            return;
+        }
+        if(nullptr == token) {
+            scheduler->schedule(UNRX4Action([handle]() { handle.resume(); }));
+            return;
+        }
+        token->acquire();
+        scheduler->schedule(token->resumption());
+    }
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Coroutine which owns its frame. Destroying a task cancels the coroutine.
+ */
+class UNRX4Task
+{
+public:
+    struct promise_type: public UNRX4Promise
+    {
+        struct final_awaiter
+        {
+            bool await_ready() noexcept
+            {
+                //A detached coroutine runs off the end and frees the frame by itself
+                return detached_;
+            }
+            void await_suspend(std::coroutine_handle<>) noexcept {}
+            void await_resume() noexcept {}
+
+            bool detached_;
+        };
+
+        UNRX4Task get_return_object()
+        {
+            return UNRX4Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        final_awaiter final_suspend() noexcept
+        {
+            return {detached_};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception()
+        {
+            UNRX4_ASSERT(false);
+        }
+
+        bool detached_ = false;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    UNRX4Task()
+        : handle_(nullptr)
+    {
+    }
+
+    UNRX4Task(UNRX4Task&& other)
+        : handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    ~UNRX4Task()
+    {
+        cancel();
+    }
+
+    UNRX4Task& operator=(UNRX4Task&& other)
+    {
+        if(this == &other) {
+            return *this;
+        }
+        cancel();
+        handle_ = other.handle_;
+        other.handle_ = nullptr;
+        return *this;
+    }
+
+    bool done() const
+    {
+        return nullptr == handle_ || handle_.done();
+    }
+
+    /**
+     * @brief Destroy the coroutine frame, every awaiting subscription is released
+     */
+    void cancel()
+    {
+        if(nullptr != handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    /**
+     * @brief Let the coroutine free itself when it finishes
+     */
+    void detach()
+    {
+        if(nullptr == handle_) {
+            return;
+        }
+        if(handle_.done()) {
+            handle_.destroy();
+        } else {
+            handle_.promise().detached_ = true;
+        }
+        handle_ = nullptr;
+    }
+
+private:
+    UNRX4Task(const UNRX4Task&) = delete;
+    UNRX4Task& operator=(const UNRX4Task&) = delete;
+
+    explicit UNRX4Task(handle_type handle)
+        : handle_(handle)
+    {
+    }
+
+    handle_type handle_;
+};
+
+//-------------------
+/**
+ * @brief Await the next value of an observable, which lives in the coroutine frame so that awaiting allocates nothing
+ */
+template<class T>
+class UNRX4NextAwaiter: public UNRX4IObserver<T>
+{
+public:
+    UNRX4NextAwaiter(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler)
+        : observable_(&observable)
+        , scheduler_(scheduler)
+        , token_(nullptr)
+        , subscribed_(false)
+        , suspended_(false)
+        , finished_(false)
+    {
+    }
+
+    virtual ~UNRX4NextAwaiter()
+    {
+        release();
+    }
+
+    bool await_ready() const
+    {
+        return false;
+    }
+
+    template<class P>
+    bool await_suspend(std::coroutine_handle<P> handle)
+    {
+        handle_ = handle;
+        token_ = unrx4::resumeToken(handle);
+        subscribed_ = true;
+        observable_->subscribe(this);
+        //Cold observables might have finished while subscribing
+        suspended_ = !finished_;
+        return suspended_;
+    }
+
+    /**
+     * @return The value, or nothing if the observable completed or failed
+     */
+    TOptional<T> await_resume()
+    {
+        release();
+        return MoveTemp(value_);
+    }
+
+    virtual void next(T value) override
+    {
+        if(finished_) {
+            return;
+        }
+        value_.Emplace(value);
+        finish();
+    }
+
+    virtual void error(unrx4::error_code_type /*errorCode*/) override
+    {
+        finish();
+    }
+
+    virtual void completed() override
+    {
+        finish();
+    }
+
+private:
+    void finish()
+    {
+        if(finished_) {
+            return;
+        }
+        finished_ = true;
+        release();
+        if(suspended_) {
+            unrx4::resumeOn(scheduler_, handle_, token_);
+        }
+    }
+
+    void release()
+    {
+        if(subscribed_) {
+            subscribed_ = false;
+            observable_->unsubscribe(this);
+        }
+    }
+
+    UNRX4IObservable<T>* observable_;
+    UNRX4IScheduler* scheduler_;
+    std::coroutine_handle<> handle_;
+    UNRX4ResumeToken* token_;
+    TOptional<T> value_;
+    bool subscribed_;
+    bool suspended_;
+    bool finished_;
+};
+
+//-------------------
+/**
+ * @brief Await completion of an observable
+ */
+template<class T>
+class UNRX4CompletedAwaiter: public UNRX4IObserver<T>
+{
+public:
+    UNRX4CompletedAwaiter(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler)
+        : observable_(&observable)
+        , scheduler_(scheduler)
+        , token_(nullptr)
+        , subscribed_(false)
+        , suspended_(false)
+        , finished_(false)
+    {
+    }
+
+    virtual ~UNRX4CompletedAwaiter()
+    {
+        release();
+    }
+
+    bool await_ready() const
+    {
+        return false;
+    }
+
+    template<class P>
+    bool await_suspend(std::coroutine_handle<P> handle)
+    {
+        handle_ = handle;
+        token_ = unrx4::resumeToken(handle);
+        subscribed_ = true;
+        observable_->subscribe(this);
+        suspended_ = !finished_;
+        return suspended_;
+    }
+
+    /**
+     * @return Nothing if completed, or the error code
+     */
+    TOptional<unrx4::error_code_type> await_resume()
+    {
+        release();
+        return errorCode_;
+    }
+
+    virtual void next(T) override
+    {
+    }
+
+    virtual void error(unrx4::error_code_type errorCode) override
+    {
+        if(finished_) {
+            return;
+        }
+        errorCode_ = errorCode;
+        finish();
+    }
+
+    virtual void completed() override
+    {
+        finish();
+    }
+
+private:
+    void finish()
+    {
+        if(finished_) {
+            return;
+        }
+        finished_ = true;
+        release();
+        if(suspended_) {
+            unrx4::resumeOn(scheduler_, handle_, token_);
+        }
+    }
+
+    void release()
+    {
+        if(subscribed_) {
+            subscribed_ = false;
+            observable_->unsubscribe(this);
+        }
+    }
+
+    UNRX4IObservable<T>* observable_;
+    UNRX4IScheduler* scheduler_;
+    std::coroutine_handle<> handle_;
+    UNRX4ResumeToken* token_;
+    TOptional<unrx4::error_code_type> errorCode_;
+    bool subscribed_;
+    bool suspended_;
+    bool finished_;
+};
+
+//-------------------
+/**
+ * @brief Keep a subscription across awaits, so that no value is lost between them
+ */
+template<class T>
+class UNRX4AwaitableStream: public UNRX4IObserver<T>
+{
+public:
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(UNRX4AwaitableStream& stream)
+            : stream_(&stream)
+            , token_(nullptr)
+        {
+        }
+
+        ~Awaiter()
+        {
+            if(this == stream_->awaiter_) {
+                stream_->awaiter_ = nullptr;
+            }
+        }
+
+        bool await_ready() const
+        {
+            return stream_->ready();
+        }
+
+        template<class P>
+        void await_suspend(std::coroutine_handle<P> handle)
+        {
+            UNRX4_ASSERT(nullptr == stream_->awaiter_);
+            handle_ = handle;
+            token_ = unrx4::resumeToken(handle);
+            stream_->awaiter_ = this;
+        }
+
+        TOptional<T> await_resume()
+        {
+            return stream_->pop();
+        }
+
+    private:
+        friend class UNRX4AwaitableStream;
+        UNRX4AwaitableStream* stream_;
+        std::coroutine_handle<> handle_;
+        UNRX4ResumeToken* token_;
+    };
+
+    UNRX4AwaitableStream(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler)
+        : observable_(&observable)
+        , scheduler_(scheduler)
+        , awaiter_(nullptr)
+        , finished_(false)
+    {
+        observable_->subscribe(this);
+    }
+
+    virtual ~UNRX4AwaitableStream()
+    {
+        release();
+    }
+
+    /**
+     * @brief co_await stream.next() returns the next value, or nothing after completion
+     */
+    Awaiter next()
+    {
+        return Awaiter(*this);
+    }
+
+    virtual void next(T value) override
+    {
+        if(finished_) {
+            return;
+        }
+        values_.push_back(value);
+        wake();
+    }
+
+    virtual void error(unrx4::error_code_type /*errorCode*/) override
+    {
+        completed();
+    }
+
+    virtual void completed() override
+    {
+        if(finished_) {
+            return;
+        }
+        finished_ = true;
+        release();
+        wake();
+    }
+
+private:
+    UNRX4AwaitableStream(const UNRX4AwaitableStream&) = delete;
+    UNRX4AwaitableStream& operator=(const UNRX4AwaitableStream&) = delete;
+
+    bool ready() const
+    {
+        return finished_ || 0 < values_.size();
+    }
+
+    TOptional<T> pop()
+    {
+        if(values_.size() <= 0) {
+            return TOptional<T>();
+        }
+        TOptional<T> value(MoveTemp(values_[0]));
+        values_.pop_front();
+        return value;
+    }
+
+    void wake()
+    {
+        if(nullptr == awaiter_) {
+            return;
+        }
+        Awaiter* awaiter = awaiter_;
+        awaiter_ = nullptr;
+        unrx4::resumeOn(scheduler_, awaiter->handle_, awaiter->token_);
+    }
+
+    void release()
+    {
+        if(nullptr != observable_) {
+            observable_->unsubscribe(this);
+            observable_ = nullptr;
+        }
+    }
+
+    UNRX4IObservable<T>* observable_;
+    UNRX4IScheduler* scheduler_;
+    Awaiter* awaiter_;
+    UNRX4Array<T> values_;
+    bool finished_;
+};
+
+//-------------------
+/**
+ * @brief Await a delay, then resume on a scheduler
+ */
+class UNRX4DelayAwaiter
+{
+public:
+    UNRX4DelayAwaiter(float seconds, UNRX4IScheduler* scheduler)
+        : seconds_(seconds)
+        , scheduler_(scheduler)
+        , token_(nullptr)
+    {
+    }
+
+    ~UNRX4DelayAwaiter()
+    {
+        if(tickerHandle_.IsValid()) {
+            FTicker::GetCoreTicker().RemoveTicker(tickerHandle_);
+        }
+    }
+
+    bool await_ready() const
+    {
+        return seconds_ <= 0.0f;
+    }
+
+    template<class P>
+    void await_suspend(std::coroutine_handle<P> handle)
+    {
+        handle_ = handle;
+        token_ = unrx4::resumeToken(handle);
+        tickerHandle_ = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &UNRX4DelayAwaiter::tick), seconds_);
+    }
+
+    void await_resume() {}
+
+private:
+    bool tick(float /*deltaTime*/)
+    {
+        tickerHandle_.Reset();
+        unrx4::resumeOn(scheduler_, handle_, token_);
+        return false;
+    }
+
+    float seconds_;
+    UNRX4IScheduler* scheduler_;
+    std::coroutine_handle<> handle_;
+    UNRX4ResumeToken* token_;
+    FDelegateHandle tickerHandle_;
+};
+
+//-------------------
+/**
+ * @brief Coroutine which emits values with co_yield to its subscriber. It can co_await inside.
+ */
+template<class T>
+class UNRX4Generator
+{
+public:
+    struct promise_type: public UNRX4Promise
+    {
+        /**
+         * @brief Stop at a yield after the observer has unsubscribed, then the observable destroys the frame
+         */
+        struct yield_awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return !stopped_;
+            }
+            void await_suspend(std::coroutine_handle<>) noexcept {}
+            void await_resume() noexcept {}
+
+            bool stopped_;
+        };
+
+        UNRX4Generator get_return_object()
+        {
+            return UNRX4Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        yield_awaiter yield_value(T value)
+        {
+            if(nullptr != observer_) {
+                emitting_ = true;
+                observer_->next(value);
+                emitting_ = false;
+            }
+            return {nullptr == observer_};
+        }
+
+        void return_void()
+        {
+            if(nullptr != observer_) {
+                emitting_ = true;
+                observer_->completed();
+                emitting_ = false;
+            }
+        }
+
+        void unhandled_exception()
+        {
+            UNRX4_ASSERT(false);
+        }
+
+        UNRX4IObserver<T>* observer_ = nullptr;
+        bool emitting_ = false; //!< Whether the frame is running inside a call of the observer
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    UNRX4Generator(UNRX4Generator&& other)
+        : handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    ~UNRX4Generator()
+    {
+        if(nullptr != handle_) {
+            handle_.destroy();
+        }
+    }
+
+    handle_type release()
+    {
+        handle_type handle = handle_;
+        handle_ = nullptr;
+        return handle;
+    }
+
+private:
+    UNRX4Generator(const UNRX4Generator&) = delete;
+    UNRX4Generator& operator=(const UNRX4Generator&) = delete;
+    UNRX4Generator& operator=(UNRX4Generator&&) = delete;
+
+    explicit UNRX4Generator(handle_type handle)
+        : handle_(handle)
+    {
+    }
+
+    handle_type handle_;
+};
+
+/**
+ * @brief Run a generator when subscribed. A generator runs once, so only the first subscriber receives values.
+ */
+template<class T>
+class UNRX4ObservableGenerator: public UNRX4IObservable<T>
+{
+public:
+    using handle_type = typename UNRX4Generator<T>::handle_type;
+
+    explicit UNRX4ObservableGenerator(UNRX4Generator<T>&& generator)
+        : handle_(generator.release())
+        , subscribed_(false)
+    {
+    }
+
+    virtual ~UNRX4ObservableGenerator()
+    {
+        if(nullptr != handle_) {
+            handle_.destroy();
+        }
+    }
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+private:
+    handle_type handle_;
+    bool subscribed_;
+};
+
+template<class T>
+void UNRX4ObservableGenerator<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    if(nullptr == handle_ || handle_.done() || subscribed_) {
+        observer->completed();
+        return;
+    }
+    subscribed_ = true;
+    handle_.promise().observer_ = observer;
+    handle_.resume();
+}
+
+template<class T>
+void UNRX4ObservableGenerator<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    if(nullptr == handle_ || observer != handle_.promise().observer_) {
+        return;
+    }
+    handle_.promise().observer_ = nullptr;
+    //A frame running inside the observer stops at the yield, and is destroyed by the destructor
+    if(!handle_.promise().emitting_) {
+        handle_.destroy();
+        handle_ = nullptr;
+    }
+}
+
+//-------------------
+/**
+ * @brief Factories of awaitables. A null scheduler resumes a coroutine on the thread which emits an event.
+ */
+class UNRX4Coroutine
+{
+public:
+    /**
+     * @brief Subscribe and await the first value emitted after this call
+     */
+    template<class T>
+    static UNRX4NextAwaiter<T> first(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler = nullptr);
+
+    template<class T>
+    static UNRX4CompletedAwaiter<T> completed(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler = nullptr);
+
+    static UNRX4DelayAwaiter delay(float seconds, UNRX4IScheduler* scheduler = nullptr);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> toObservable(UNRX4Generator<T>&& generator);
+};
+
+template<class T>
+UNRX4NextAwaiter<T> UNRX4Coroutine::first(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler)
+{
+    return UNRX4NextAwaiter<T>(observable, scheduler);
+}
+
+template<class T>
+UNRX4CompletedAwaiter<T> UNRX4Coroutine::completed(UNRX4IObservable<T>& observable, UNRX4IScheduler* scheduler)
+{
+    return UNRX4CompletedAwaiter<T>(observable, scheduler);
+}
+
+inline UNRX4DelayAwaiter UNRX4Coroutine::delay(float seconds, UNRX4IScheduler* scheduler)
+{
+    return UNRX4DelayAwaiter(seconds, scheduler);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Coroutine::toObservable(UNRX4Generator<T>&& generator)
+{
+    return unrx4_make_unique<UNRX4ObservableGenerator<T>>(std::move(generator));
+}
+#endif
@@ -17,6 +17,7 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  */
 // clang-format on
 #include "UNRX4CurrentThreadScheduler.h"
+#include "UNRX4Trace.h"
 
 void UNRX4CurrentThreadScheduler::schedule(UNRX4Action action)
 {
@@ -24,14 +25,32 @@ void UNRX4CurrentThreadScheduler::schedule(UNRX4Action action)
         return;
     }
 
-    queue_.push_back(std::move(action));
+    Entry entry;
+    entry.action_ = std::move(action);
+#if UNRX4_PROFILER_ENABLED
+    entry.stream_ = UNRX4Profiler::currentStream();
+    if(UNRX4Profiler::InvalidStream == entry.stream_) {
+        entry.stream_ = profile_.id();
+    }
+    entry.scheduled_ = FPlatformTime::Cycles64();
+#endif
+    queue_.push_back(std::move(entry));
 }
 
 void UNRX4CurrentThreadScheduler::run()
 {
+    UNRX4_TRACE_DRAIN("UNRX4CurrentThreadScheduler::run", this, queue_.size());
     while(0<queue_.size()){
-        UNRX4Action action = std::move(queue_[0]);
+        Entry entry = std::move(queue_[0]);
         queue_.pop_front();
-        action();
+        UNRX4_TRACE_SCOPE("UNRX4CurrentThreadScheduler::action");
+#if UNRX4_PROFILER_ENABLED
+        UNRX4Profiler::recordLatency(entry.stream_, FPlatformTime::Cycles64() - entry.scheduled_);
+        unrx4::u32 previous = UNRX4Profiler::exchangeCurrentStream(entry.stream_);
+        entry.action_();
+        UNRX4Profiler::exchangeCurrentStream(previous);
+#else
+        entry.action_();
+#endif
     }
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
 // clang-format on
 #    include "UNRX4Container.h"
 #    include "UNRX4IScheduler.h"
+#    include "UNRX4Profiler.h"
 
 /**
  * @brief 
@@ -30,7 +31,26 @@ public:
     virtual ~UNRX4CurrentThreadScheduler() {}
     virtual void schedule(UNRX4Action action);
 
+    /**
+     * @brief Schedule an action held in the frame arena. The queue is drained at the end of every frame.
+     */
+    template<class F>
+    void scheduleTransient(F f)
+    {
+        schedule(UNRX4Action(unrx4_transient, f));
+    }
+
     void run();
 private:
-    UNRX4Array<UNRX4Action> queue_;
+    struct Entry
+    {
+        UNRX4Action action_;
+#if UNRX4_PROFILER_ENABLED
+        unrx4::u32 stream_;
+        unrx4::u64 scheduled_;
+#endif
+    };
+
+    UNRX4Array<Entry> queue_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4CurrentThreadScheduler");
 };
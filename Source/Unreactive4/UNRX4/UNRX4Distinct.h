@@ -0,0 +1,432 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Distinct.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Operator.h"
+
+//-------------------
+/**
+ * @brief Default equality of distinct operators
+ */
+template<class T>
+struct UNRX4EqualTo
+{
+    bool operator()(const T& x0, const T& x1) const
+    {
+        return x0 == x1;
+    }
+};
+
+/**
+ * @brief FText has no operator==, texts are equal if they display the same string
+ */
+template<>
+struct UNRX4EqualTo<FText>
+{
+    bool operator()(const FText& x0, const FText& x1) const
+    {
+        return x0.IdenticalTo(x1) || x0.ToString().Equals(x1.ToString(), ESearchCase::CaseSensitive);
+    }
+};
+
+/**
+ * @brief Default hash of distinct operators, GetTypeHash of the engine
+ */
+template<class T>
+struct UNRX4Hash
+{
+    unrx4::u32 operator()(const T& x) const
+    {
+        return GetTypeHash(x);
+    }
+};
+
+//-------------------
+/**
+ * @brief Suppress values which are equal to the previous one
+ */
+template<class T, class Equal = UNRX4EqualTo<T>>
+class UNRX4DistinctUntilChanged: public UNRX4Operator<UNRX4DistinctUntilChanged<T, Equal>, T>
+{
+    using base_type = UNRX4Operator<UNRX4DistinctUntilChanged<T, Equal>, T>;
+    friend base_type;
+
+public:
+    UNRX4DistinctUntilChanged(UNRX4IObservable<T>* source, Equal equal);
+
+private:
+    void onNext(const T& value);
+
+    Equal equal_;
+    TOptional<T> last_;
+};
+
+template<class T, class Equal>
+UNRX4DistinctUntilChanged<T, Equal>::UNRX4DistinctUntilChanged(UNRX4IObservable<T>* source, Equal equal)
+    : base_type(source)
+    , equal_(equal)
+{
+}
+
+template<class T, class Equal>
+void UNRX4DistinctUntilChanged<T, Equal>::onNext(const T& value)
+{
+    if(last_.IsSet() && equal_(last_.GetValue(), value)) {
+        return;
+    }
+    last_ = value;
+    this->emit(value);
+}
+
+//-------------------
+/**
+ * @brief Suppress values whose hash is equal to the previous one, keeping only the hash
+ *
+ * For large values, a changed value whose hash collides is suppressed too.
+ */
+template<class T, class Hash = UNRX4Hash<T>>
+class UNRX4DistinctUntilHashChanged: public UNRX4Operator<UNRX4DistinctUntilHashChanged<T, Hash>, T>
+{
+    using base_type = UNRX4Operator<UNRX4DistinctUntilHashChanged<T, Hash>, T>;
+    friend base_type;
+
+public:
+    UNRX4DistinctUntilHashChanged(UNRX4IObservable<T>* source, Hash hash);
+
+private:
+    void onNext(const T& value);
+
+    Hash hash_;
+    unrx4::u32 last_;
+    bool hasLast_;
+};
+
+template<class T, class Hash>
+UNRX4DistinctUntilHashChanged<T, Hash>::UNRX4DistinctUntilHashChanged(UNRX4IObservable<T>* source, Hash hash)
+    : base_type(source)
+    , hash_(hash)
+    , last_(0)
+    , hasLast_(false)
+{
+}
+
+template<class T, class Hash>
+void UNRX4DistinctUntilHashChanged<T, Hash>::onNext(const T& value)
+{
+    unrx4::u32 hash = hash_(value);
+    if(hasLast_ && last_ == hash) {
+        return;
+    }
+    last_ = hash;
+    hasLast_ = true;
+    this->emit(value);
+}
+
+//-------------------
+/**
+ * @brief Suppress values seen within the last capacity distinct values
+ *
+ * The window is a fixed-size hash table with linear probing over a LRU list of nodes, both allocated at construction.
+ */
+template<class T, class Hash = UNRX4Hash<T>, class Equal = UNRX4EqualTo<T>>
+class UNRX4DistinctWindow: public UNRX4Operator<UNRX4DistinctWindow<T, Hash, Equal>, T>
+{
+    using base_type = UNRX4Operator<UNRX4DistinctWindow<T, Hash, Equal>, T>;
+    friend base_type;
+
+public:
+    UNRX4DistinctWindow(UNRX4IObservable<T>* source, unrx4::size_t capacity, Hash hash, Equal equal);
+
+private:
+    static constexpr unrx4::s32 Invalid = -1;
+
+    struct Node
+    {
+        T value_;
+        unrx4::u32 hash_;
+        unrx4::s32 prev_;
+        unrx4::s32 next_;
+    };
+
+    void onNext(const T& value);
+
+    /**
+     * @return The slot which has the value, or the empty slot to insert it
+     */
+    unrx4::size_t find(const T& value, unrx4::u32 hash) const;
+    void erase(unrx4::size_t slot);
+    void link(unrx4::s32 node);
+    void unlink(unrx4::s32 node);
+
+    Hash hash_;
+    Equal equal_;
+    unrx4::size_t mask_;
+    unrx4::s32 size_;
+    unrx4::s32 head_;
+    unrx4::s32 tail_;
+    UNRX4Array<Node> nodes_;
+    UNRX4Array<unrx4::s32> slots_;
+};
+
+template<class T, class Hash, class Equal>
+UNRX4DistinctWindow<T, Hash, Equal>::UNRX4DistinctWindow(UNRX4IObservable<T>* source, unrx4::size_t capacity, Hash hash, Equal equal)
+    : base_type(source)
+    , hash_(hash)
+    , equal_(equal)
+    , mask_(0)
+    , size_(0)
+    , head_(Invalid)
+    , tail_(Invalid)
+{
+    capacity = 0 < capacity ? capacity : 1;
+    //Keep the load factor under one half
+    unrx4::size_t slots = 2;
+    while(slots < (capacity * 2)) {
+        slots <<= 1;
+    }
+    mask_ = slots - 1;
+    nodes_.resize(capacity);
+    slots_.resize(slots);
+    for(unrx4::size_t i = 0; i < slots; ++i) {
+        slots_[i] = Invalid;
+    }
+}
+
+template<class T, class Hash, class Equal>
+void UNRX4DistinctWindow<T, Hash, Equal>::onNext(const T& value)
+{
+    unrx4::u32 hash = hash_(value);
+    unrx4::size_t slot = find(value, hash);
+    if(Invalid != slots_[slot]) {
+        unrx4::s32 node = slots_[slot];
+        unlink(node);
+        link(node);
+        return;
+    }
+    unrx4::s32 node;
+    if(static_cast<unrx4::size_t>(size_) < nodes_.size()) {
+        node = size_;
+        ++size_;
+    } else {
+        //Evict the least recently seen
+        node = tail_;
+        unlink(node);
+        erase(find(nodes_[node].value_, nodes_[node].hash_));
+        slot = find(value, hash);
+    }
+    nodes_[node].value_ = value;
+    nodes_[node].hash_ = hash;
+    slots_[slot] = node;
+    link(node);
+    this->emit(value);
+}
+
+template<class T, class Hash, class Equal>
+unrx4::size_t UNRX4DistinctWindow<T, Hash, Equal>::find(const T& value, unrx4::u32 hash) const
+{
+    unrx4::size_t slot = hash & mask_;
+    while(Invalid != slots_[slot]) {
+        const Node& node = nodes_[slots_[slot]];
+        if(node.hash_ == hash && equal_(node.value_, value)) {
+            break;
+        }
+        slot = (slot + 1) & mask_;
+    }
+    return slot;
+}
+
+template<class T, class Hash, class Equal>
+void UNRX4DistinctWindow<T, Hash, Equal>::erase(unrx4::size_t slot)
+{
+    //Shift following entries back instead of leaving tombstones
+    unrx4::size_t next = slot;
+    for(;;) {
+        next = (next + 1) & mask_;
+        if(Invalid == slots_[next]) {
+            break;
+        }
+        unrx4::size_t home = nodes_[slots_[next]].hash_ & mask_;
+        bool movable = (slot < next) ? (home <= slot || next < home) : (home <= slot && next < home);
+        if(movable) {
+            slots_[slot] = slots_[next];
+            slot = next;
+        }
+    }
+    slots_[slot] = Invalid;
+}
+
+template<class T, class Hash, class Equal>
+void UNRX4DistinctWindow<T, Hash, Equal>::link(unrx4::s32 node)
+{
+    nodes_[node].prev_ = Invalid;
+    nodes_[node].next_ = head_;
+    if(Invalid != head_) {
+        nodes_[head_].prev_ = node;
+    }
+    head_ = node;
+    if(Invalid == tail_) {
+        tail_ = node;
+    }
+}
+
+template<class T, class Hash, class Equal>
+void UNRX4DistinctWindow<T, Hash, Equal>::unlink(unrx4::s32 node)
+{
+    unrx4::s32 prev = nodes_[node].prev_;
+    unrx4::s32 next = nodes_[node].next_;
+    if(Invalid != prev) {
+        nodes_[prev].next_ = next;
+    } else {
+        head_ = next;
+    }
+    if(Invalid != next) {
+        nodes_[next].prev_ = prev;
+    } else {
+        tail_ = prev;
+    }
+}
+
+//-------------------
+/**
+ * @brief Map values with a pure function, reusing results of repeated inputs
+ *
+ * Results are kept in a direct-mapped cache of fixed size, a colliding input replaces the entry.
+ */
+template<class In, class Out, class F, class Hash = UNRX4Hash<In>, class Equal = UNRX4EqualTo<In>>
+class UNRX4SelectCached: public UNRX4Operator<UNRX4SelectCached<In, Out, F, Hash, Equal>, In, Out>
+{
+    using base_type = UNRX4Operator<UNRX4SelectCached<In, Out, F, Hash, Equal>, In, Out>;
+    friend base_type;
+
+public:
+    UNRX4SelectCached(UNRX4IObservable<In>* source, unrx4::size_t capacity, F f, Hash hash, Equal equal);
+
+    unrx4::u64 hits() const;
+    unrx4::u64 misses() const;
+
+private:
+    struct Entry
+    {
+        TOptional<In> key_;
+        TOptional<Out> value_;
+    };
+
+    void onNext(const In& value);
+
+    F f_;
+    Hash hash_;
+    Equal equal_;
+    unrx4::size_t mask_;
+    unrx4::u64 hits_;
+    unrx4::u64 misses_;
+    UNRX4Array<Entry> entries_;
+};
+
+template<class In, class Out, class F, class Hash, class Equal>
+UNRX4SelectCached<In, Out, F, Hash, Equal>::UNRX4SelectCached(UNRX4IObservable<In>* source, unrx4::size_t capacity, F f, Hash hash, Equal equal)
+    : base_type(source)
+    , f_(f)
+    , hash_(hash)
+    , equal_(equal)
+    , mask_(0)
+    , hits_(0)
+    , misses_(0)
+{
+    unrx4::size_t size = 1;
+    while(size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    entries_.resize(size);
+}
+
+template<class In, class Out, class F, class Hash, class Equal>
+unrx4::u64 UNRX4SelectCached<In, Out, F, Hash, Equal>::hits() const
+{
+    return hits_;
+}
+
+template<class In, class Out, class F, class Hash, class Equal>
+unrx4::u64 UNRX4SelectCached<In, Out, F, Hash, Equal>::misses() const
+{
+    return misses_;
+}
+
+template<class In, class Out, class F, class Hash, class Equal>
+void UNRX4SelectCached<In, Out, F, Hash, Equal>::onNext(const In& value)
+{
+    Entry& entry = entries_[hash_(value) & mask_];
+    if(entry.key_.IsSet() && equal_(entry.key_.GetValue(), value)) {
+        ++hits_;
+    } else {
+        ++misses_;
+        entry.key_ = value;
+        entry.value_ = f_(value);
+    }
+    this->emit(entry.value_.GetValue());
+}
+
+//-------------------
+/**
+ * @brief Factories of operators which suppress redundant downstream work
+ */
+class UNRX4Distinct
+{
+public:
+    template<class T, class Equal = UNRX4EqualTo<T>>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> distinctUntilChanged(UNRX4IObservable<T>* source, Equal equal = Equal());
+
+    template<class T, class Hash = UNRX4Hash<T>>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> distinctUntilHashChanged(UNRX4IObservable<T>* source, Hash hash = Hash());
+
+    /**
+     * @param capacity ... The number of distinct values to remember
+     */
+    template<class T, class Hash = UNRX4Hash<T>, class Equal = UNRX4EqualTo<T>>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> distinct(UNRX4IObservable<T>* source, unrx4::size_t capacity, Hash hash = Hash(), Equal equal = Equal());
+
+    /**
+     * @param capacity ... The number of cache entries, rounded up to a power of two
+     */
+    template<class In, class F, class Hash = UNRX4Hash<In>, class Equal = UNRX4EqualTo<In>, class Out = typename std::decay<decltype(std::declval<F&>()(std::declval<const In&>()))>::type>
+    static unrx4_unique_ptr<UNRX4IObservable<Out>> selectCached(UNRX4IObservable<In>* source, unrx4::size_t capacity, F f, Hash hash = Hash(), Equal equal = Equal());
+};
+
+template<class T, class Equal>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Distinct::distinctUntilChanged(UNRX4IObservable<T>* source, Equal equal)
+{
+    return unrx4_make_unique<UNRX4DistinctUntilChanged<T, Equal>>(source, equal);
+}
+
+template<class T, class Hash>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Distinct::distinctUntilHashChanged(UNRX4IObservable<T>* source, Hash hash)
+{
+    return unrx4_make_unique<UNRX4DistinctUntilHashChanged<T, Hash>>(source, hash);
+}
+
+template<class T, class Hash, class Equal>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Distinct::distinct(UNRX4IObservable<T>* source, unrx4::size_t capacity, Hash hash, Equal equal)
+{
+    return unrx4_make_unique<UNRX4DistinctWindow<T, Hash, Equal>>(source, capacity, hash, equal);
+}
+
+template<class In, class F, class Hash, class Equal, class Out>
+unrx4_unique_ptr<UNRX4IObservable<Out>> UNRX4Distinct::selectCached(UNRX4IObservable<In>* source, unrx4::size_t capacity, F f, Hash hash, Equal equal)
+{
+    return unrx4_make_unique<UNRX4SelectCached<In, Out, F, Hash, Equal>>(source, capacity, f, hash, equal);
+}
@@ -0,0 +1,58 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4DynamicDelegate.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4DynamicDelegate.h"
+#include <UObject/Package.h>
+
+UUNRX4DynamicDelegateBridge* UUNRX4DynamicDelegateBridge::create(void* target, dispatch_type dispatch)
+{
+    UUNRX4DynamicDelegateBridge* bridge = NewObject<UUNRX4DynamicDelegateBridge>(GetTransientPackage());
+    bridge->AddToRoot();
+    bridge->target_ = target;
+    bridge->dispatch_ = dispatch;
+    return bridge;
+}
+
+void UUNRX4DynamicDelegateBridge::release()
+{
+    target_ = nullptr;
+    dispatch_ = nullptr;
+    RemoveFromRoot();
+    MarkPendingKill();
+}
+
+FName UUNRX4DynamicDelegateBridge::getEventName()
+{
+    return GET_FUNCTION_NAME_CHECKED(UUNRX4DynamicDelegateBridge, onEvent);
+}
+
+void UUNRX4DynamicDelegateBridge::ProcessEvent(UFunction* function, void* parameters)
+{
+    //The parameters are not of onEvent, then they never reach the script VM
+    if(getEventName() == function->GetFName()) {
+        if(nullptr != dispatch_) {
+            dispatch_(target_, parameters);
+        }
+        return;
+    }
+    Super::ProcessEvent(function, parameters);
+}
+
+void UUNRX4DynamicDelegateBridge::onEvent()
+{
+}
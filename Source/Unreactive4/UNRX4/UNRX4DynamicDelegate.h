@@ -0,0 +1,182 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4DynamicDelegate.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <UObject/Object.h>
+#include "UNRX4Observable.h"
+#include <type_traits>
+#include <utility>
+#include "UNRX4DynamicDelegate.generated.h"
+
+//-------------------
+/**
+ * @brief Object which dynamic delegates are bound to, then it forwards their parameters to an observable
+ *
+ * Dynamic delegates call only UFUNCTIONs, so they are bound to onEvent, and ProcessEvent takes the parameters before the function runs.
+ * The parameters are in the layout of the signature of the delegate.
+ */
+UCLASS(Transient)
+class UNREACTIVE4_API UUNRX4DynamicDelegateBridge: public UObject
+{
+    GENERATED_BODY()
+public:
+    using dispatch_type = void (*)(void* target, void* parameters);
+
+    /**
+     * @brief Create a rooted bridge, which lives until release
+     */
+    static UUNRX4DynamicDelegateBridge* create(void* target, dispatch_type dispatch);
+
+    /**
+     * @brief Stop forwarding, then let the garbage collector destroy this
+     */
+    void release();
+
+    static FName getEventName();
+
+    virtual void ProcessEvent(UFunction* function, void* parameters) override;
+
+private:
+    UFUNCTION()
+    void onEvent();
+
+    void* target_ = nullptr;
+    dispatch_type dispatch_ = nullptr;
+};
+
+namespace unrx4
+{
+namespace dynamic
+{
+    /**
+     * @brief Call next with parameters of a dynamic delegate, which lays them out in order like members of a struct
+     */
+    template<class... Args, std::size_t... I>
+    void call(UNRX4ObservableFromEvent<Args...>* observable, unrx4::u8* parameters, std::index_sequence<I...>)
+    {
+        unrx4::size_t offsets[sizeof...(Args) + 1] = {};
+        unrx4::size_t offset = 0;
+        unrx4::size_t index = 0;
+        using expand = int[];
+        (void)expand{0, (offset = (offset + alignof(typename std::decay<Args>::type) - 1) & ~(alignof(typename std::decay<Args>::type) - 1),
+                         offsets[index++] = offset,
+                         offset += sizeof(typename std::decay<Args>::type),
+                         0)...};
+        observable->next(*reinterpret_cast<typename std::decay<Args>::type*>(parameters + offsets[I])...);
+    }
+
+    template<class... Args>
+    void dispatchEvent(void* target, void* parameters)
+    {
+        call(static_cast<UNRX4ObservableFromEvent<Args...>*>(target), reinterpret_cast<unrx4::u8*>(parameters), std::index_sequence_for<Args...>());
+    }
+} // namespace dynamic
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Bind a dynamic delegate to an observable, the delegate should outlive the observable
+ */
+template<class... Args>
+class UNRX4ObservableFromDynamicDelegate: public UNRX4ObservableFromEvent<Args...>
+{
+public:
+    using base_type = UNRX4ObservableFromEvent<Args...>;
+    using delegate_type = TBaseDynamicDelegate<FWeakObjectPtr, void, Args...>;
+
+    explicit UNRX4ObservableFromDynamicDelegate(delegate_type& delegate)
+        : delegate_(&delegate)
+        , bridge_(UUNRX4DynamicDelegateBridge::create(static_cast<base_type*>(this), &unrx4::dynamic::dispatchEvent<Args...>))
+    {
+        UNRX4_ASSERT(!delegate.IsBound());
+        delegate.BindUFunction(bridge_, UUNRX4DynamicDelegateBridge::getEventName());
+    }
+
+    virtual ~UNRX4ObservableFromDynamicDelegate()
+    {
+        delegate_->Unbind();
+        bridge_->release();
+    }
+
+private:
+    delegate_type* delegate_;
+    UUNRX4DynamicDelegateBridge* bridge_;
+};
+
+//-------------------
+/**
+ * @brief Add an observable to a dynamic multicast delegate, other bindings are kept
+ */
+template<class... Args>
+class UNRX4ObservableFromDynamicMulticastDelegate: public UNRX4ObservableFromEvent<Args...>
+{
+public:
+    using base_type = UNRX4ObservableFromEvent<Args...>;
+    using delegate_type = TBaseDynamicMulticastDelegate<FWeakObjectPtr, void, Args...>;
+
+    explicit UNRX4ObservableFromDynamicMulticastDelegate(delegate_type& delegate)
+        : delegate_(&delegate)
+        , bridge_(UUNRX4DynamicDelegateBridge::create(static_cast<base_type*>(this), &unrx4::dynamic::dispatchEvent<Args...>))
+    {
+        FScriptDelegate binding;
+        binding.BindUFunction(bridge_, UUNRX4DynamicDelegateBridge::getEventName());
+        delegate.Add(binding);
+    }
+
+    virtual ~UNRX4ObservableFromDynamicMulticastDelegate()
+    {
+        delegate_->Remove(bridge_, UUNRX4DynamicDelegateBridge::getEventName());
+        bridge_->release();
+    }
+
+private:
+    delegate_type* delegate_;
+    UUNRX4DynamicDelegateBridge* bridge_;
+};
+
+//-------------------
+/**
+ * @brief Factories of observables from dynamic delegates, which are apart from UNRX4Observable because they need a UCLASS
+ */
+class UNRX4DynamicDelegate
+{
+public:
+    /**
+     * @brief Bind an unbound dynamic delegate to a new observable
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromDynamicDelegate(TBaseDynamicDelegate<FWeakObjectPtr, void, Args...>& delegate);
+
+    /**
+     * @brief Add a new observable to a dynamic multicast delegate
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromDynamicMulticastDelegate(TBaseDynamicMulticastDelegate<FWeakObjectPtr, void, Args...>& delegate);
+};
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4DynamicDelegate::fromDynamicDelegate(TBaseDynamicDelegate<FWeakObjectPtr, void, Args...>& delegate)
+{
+    return unrx4_make_unique<UNRX4ObservableFromDynamicDelegate<Args...>>(delegate);
+}
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4DynamicDelegate::fromDynamicMulticastDelegate(TBaseDynamicMulticastDelegate<FWeakObjectPtr, void, Args...>& delegate)
+{
+    return unrx4_make_unique<UNRX4ObservableFromDynamicMulticastDelegate<Args...>>(delegate);
+}
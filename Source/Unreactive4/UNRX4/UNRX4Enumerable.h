@@ -0,0 +1,378 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Enumerable.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include <type_traits>
+
+namespace unrx4
+{
+namespace enumerable
+{
+    //--- Cursors return a pointer to the next value, or nullptr at the end.
+    //--- Pointers are valid until the next call.
+
+    template<class T>
+    class ViewCursor
+    {
+    public:
+        using value_type = T;
+
+        ViewCursor(const T* begin, const T* end)
+            : current_(begin)
+            , end_(end)
+        {
+        }
+
+        const T* next()
+        {
+            return current_ < end_ ? current_++ : nullptr;
+        }
+
+    private:
+        const T* current_;
+        const T* end_;
+    };
+
+    template<class T>
+    class RangeCursor
+    {
+    public:
+        using value_type = T;
+
+        RangeCursor(T start, unrx4::u32 count)
+            : value_(start)
+            , count_(count)
+            , started_(false)
+        {
+        }
+
+        const T* next()
+        {
+            if(count_ <= 0) {
+                return nullptr;
+            }
+            if(started_) {
+                ++value_;
+            }
+            started_ = true;
+            --count_;
+            return &value_;
+        }
+
+    private:
+        T value_;
+        unrx4::u32 count_;
+        bool started_;
+    };
+
+    template<class Source, class P>
+    class WhereCursor
+    {
+    public:
+        using value_type = typename Source::value_type;
+
+        WhereCursor(const Source& source, const P& predicate)
+            : source_(source)
+            , predicate_(predicate)
+        {
+        }
+
+        const value_type* next()
+        {
+            while(const value_type* value = source_.next()) {
+                if(predicate_(*value)) {
+                    return value;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        Source source_;
+        P predicate_;
+    };
+
+    template<class Source, class F>
+    class SelectCursor
+    {
+    public:
+        using value_type = typename std::decay<decltype(std::declval<F&>()(std::declval<const typename Source::value_type&>()))>::type;
+
+        SelectCursor(const Source& source, const F& f)
+            : source_(source)
+            , f_(f)
+        {
+        }
+
+        const value_type* next()
+        {
+            const typename Source::value_type* value = source_.next();
+            if(nullptr == value) {
+                return nullptr;
+            }
+            current_.Emplace(f_(*value));
+            return &current_.GetValue();
+        }
+
+    private:
+        Source source_;
+        F f_;
+        TOptional<value_type> current_;
+    };
+
+    template<class Source>
+    class TakeCursor
+    {
+    public:
+        using value_type = typename Source::value_type;
+
+        TakeCursor(const Source& source, unrx4::size_t count)
+            : source_(source)
+            , count_(count)
+        {
+        }
+
+        const value_type* next()
+        {
+            //Never pull the source after the last one
+            if(count_ <= 0) {
+                return nullptr;
+            }
+            --count_;
+            return source_.next();
+        }
+
+    private:
+        Source source_;
+        unrx4::size_t count_;
+    };
+
+    template<class Source>
+    class SkipCursor
+    {
+    public:
+        using value_type = typename Source::value_type;
+
+        SkipCursor(const Source& source, unrx4::size_t count)
+            : source_(source)
+            , count_(count)
+        {
+        }
+
+        const value_type* next()
+        {
+            for(; 0 < count_; --count_) {
+                if(nullptr == source_.next()) {
+                    count_ = 0;
+                    return nullptr;
+                }
+            }
+            return source_.next();
+        }
+
+    private:
+        Source source_;
+        unrx4::size_t count_;
+    };
+} // namespace enumerable
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Lazy pull-based query, the interactive counterpart of observables
+ *
+ * Operators are fused into nested cursors without virtual calls, and nothing is evaluated until a terminal operator is called.
+ * An enumerable can be evaluated any number of times, each terminal operator starts from a copy of the cursor.
+ * @tparam T ... Element type
+ * @tparam Cursor ... Type of the fused cursor
+ */
+template<class T, class Cursor = unrx4::enumerable::ViewCursor<T>>
+class UNRX4Enumerable
+{
+public:
+    using value_type = T;
+    using cursor_type = Cursor;
+
+    explicit UNRX4Enumerable(const Cursor& cursor);
+
+    template<class P>
+    UNRX4Enumerable<T, unrx4::enumerable::WhereCursor<Cursor, P>> where(P predicate) const;
+
+    template<class F>
+    UNRX4Enumerable<typename unrx4::enumerable::SelectCursor<Cursor, F>::value_type, unrx4::enumerable::SelectCursor<Cursor, F>> select(F f) const;
+
+    UNRX4Enumerable<T, unrx4::enumerable::TakeCursor<Cursor>> take(unrx4::size_t count) const;
+    UNRX4Enumerable<T, unrx4::enumerable::SkipCursor<Cursor>> skip(unrx4::size_t count) const;
+
+    TOptional<T> first() const;
+    bool any() const;
+
+    template<class P>
+    bool any(P predicate) const;
+
+    unrx4::size_t count() const;
+    UNRX4Array<T> toArray() const;
+
+    /**
+     * @brief Call f for each value
+     */
+    template<class F>
+    void forEach(F f) const;
+
+private:
+    Cursor cursor_;
+};
+
+template<class T, class Cursor>
+UNRX4Enumerable<T, Cursor>::UNRX4Enumerable(const Cursor& cursor)
+    : cursor_(cursor)
+{
+}
+
+template<class T, class Cursor>
+template<class P>
+UNRX4Enumerable<T, unrx4::enumerable::WhereCursor<Cursor, P>> UNRX4Enumerable<T, Cursor>::where(P predicate) const
+{
+    return UNRX4Enumerable<T, unrx4::enumerable::WhereCursor<Cursor, P>>(unrx4::enumerable::WhereCursor<Cursor, P>(cursor_, predicate));
+}
+
+template<class T, class Cursor>
+template<class F>
+UNRX4Enumerable<typename unrx4::enumerable::SelectCursor<Cursor, F>::value_type, unrx4::enumerable::SelectCursor<Cursor, F>> UNRX4Enumerable<T, Cursor>::select(F f) const
+{
+    using cursor_type = unrx4::enumerable::SelectCursor<Cursor, F>;
+    return UNRX4Enumerable<typename cursor_type::value_type, cursor_type>(cursor_type(cursor_, f));
+}
+
+template<class T, class Cursor>
+UNRX4Enumerable<T, unrx4::enumerable::TakeCursor<Cursor>> UNRX4Enumerable<T, Cursor>::take(unrx4::size_t count) const
+{
+    return UNRX4Enumerable<T, unrx4::enumerable::TakeCursor<Cursor>>(unrx4::enumerable::TakeCursor<Cursor>(cursor_, count));
+}
+
+template<class T, class Cursor>
+UNRX4Enumerable<T, unrx4::enumerable::SkipCursor<Cursor>> UNRX4Enumerable<T, Cursor>::skip(unrx4::size_t count) const
+{
+    return UNRX4Enumerable<T, unrx4::enumerable::SkipCursor<Cursor>>(unrx4::enumerable::SkipCursor<Cursor>(cursor_, count));
+}
+
+template<class T, class Cursor>
+TOptional<T> UNRX4Enumerable<T, Cursor>::first() const
+{
+    Cursor cursor = cursor_;
+    const T* value = cursor.next();
+    return nullptr != value ? TOptional<T>(*value) : TOptional<T>();
+}
+
+template<class T, class Cursor>
+bool UNRX4Enumerable<T, Cursor>::any() const
+{
+    Cursor cursor = cursor_;
+    return nullptr != cursor.next();
+}
+
+template<class T, class Cursor>
+template<class P>
+bool UNRX4Enumerable<T, Cursor>::any(P predicate) const
+{
+    Cursor cursor = cursor_;
+    while(const T* value = cursor.next()) {
+        if(predicate(*value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class T, class Cursor>
+unrx4::size_t UNRX4Enumerable<T, Cursor>::count() const
+{
+    Cursor cursor = cursor_;
+    unrx4::size_t count = 0;
+    while(nullptr != cursor.next()) {
+        ++count;
+    }
+    return count;
+}
+
+template<class T, class Cursor>
+UNRX4Array<T> UNRX4Enumerable<T, Cursor>::toArray() const
+{
+    UNRX4Array<T> result;
+    Cursor cursor = cursor_;
+    while(const T* value = cursor.next()) {
+        result.push_back(*value);
+    }
+    return result;
+}
+
+template<class T, class Cursor>
+template<class F>
+void UNRX4Enumerable<T, Cursor>::forEach(F f) const
+{
+    Cursor cursor = cursor_;
+    while(const T* value = cursor.next()) {
+        f(*value);
+    }
+}
+
+//-------------------
+/**
+ * @brief Factories of enumerables, which read the memory of the caller without copying
+ */
+class UNRX4Interactive
+{
+public:
+    template<class T>
+    static UNRX4Enumerable<T> fromArray(const UNRX4Array<T>& values);
+
+    template<class T>
+    static UNRX4Enumerable<T> fromArray(TArrayView<const T> values);
+
+    template<class T>
+    static UNRX4Enumerable<T> fromRange(const T* begin, const T* end);
+
+    template<class T>
+    static UNRX4Enumerable<T, unrx4::enumerable::RangeCursor<T>> range(T start, unrx4::u32 count);
+};
+
+template<class T>
+UNRX4Enumerable<T> UNRX4Interactive::fromArray(const UNRX4Array<T>& values)
+{
+    return UNRX4Enumerable<T>(unrx4::enumerable::ViewCursor<T>(values.cbegin(), values.cend()));
+}
+
+template<class T>
+UNRX4Enumerable<T> UNRX4Interactive::fromArray(TArrayView<const T> values)
+{
+    return UNRX4Enumerable<T>(unrx4::enumerable::ViewCursor<T>(values.GetData(), values.GetData() + values.Num()));
+}
+
+template<class T>
+UNRX4Enumerable<T> UNRX4Interactive::fromRange(const T* begin, const T* end)
+{
+    UNRX4_ASSERT(begin <= end);
+    return UNRX4Enumerable<T>(unrx4::enumerable::ViewCursor<T>(begin, end));
+}
+
+template<class T>
+UNRX4Enumerable<T, unrx4::enumerable::RangeCursor<T>> UNRX4Interactive::range(T start, unrx4::u32 count)
+{
+    return UNRX4Enumerable<T, unrx4::enumerable::RangeCursor<T>>(unrx4::enumerable::RangeCursor<T>(start, count));
+}
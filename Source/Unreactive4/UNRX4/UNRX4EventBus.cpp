@@ -0,0 +1,112 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4EventBus.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4EventBus.h"
+#include "UNRX4Trace.h"
+
+UNRX4EventBus::UNRX4EventBus()
+{
+}
+
+UNRX4EventBus::~UNRX4EventBus()
+{
+    clear();
+}
+
+UNRX4ChannelId UNRX4EventBus::channel(FName name)
+{
+    //Comparison index and number identify a name exactly, and never reach the bit of type channels
+    return (static_cast<UNRX4ChannelId>(name.GetComparisonIndex().ToUnstableInt()) << 32) | static_cast<unrx4::u32>(name.GetNumber());
+}
+
+unrx4::size_t UNRX4EventBus::dispatch()
+{
+    UNRX4_TRACE_SCOPE("UNRX4EventBus::dispatch");
+    {
+        FScopeLock lock(&lock_);
+        for(unrx4::size_t i = 0; i < channels_.size(); ++i) {
+            channels_[i]->swap();
+        }
+    }
+    //Other threads can add channels while dispatching, then a channel can be visited twice but its events are dispatched once
+    unrx4::size_t count = 0;
+    for(unrx4::size_t i = 0;; ++i) {
+        Channel* channel;
+        {
+            FScopeLock lock(&lock_);
+            if(channels_.size() <= i) {
+                break;
+            }
+            channel = channels_[i];
+        }
+        count += channel->dispatch();
+    }
+    return count;
+}
+
+void UNRX4EventBus::clear()
+{
+    FScopeLock lock(&lock_);
+    for(unrx4::size_t i = 0; i < channels_.size(); ++i) {
+        unrx4_destruct(channels_[i]);
+    }
+    channels_.clear();
+    channels_.shrink_to_fit();
+}
+
+unrx4::size_t UNRX4EventBus::numChannels() const
+{
+    FScopeLock lock(&lock_);
+    return channels_.size();
+}
+
+unrx4::size_t UNRX4EventBus::numObservers(UNRX4ChannelId id) const
+{
+    FScopeLock lock(&lock_);
+    Channel* channel = find(id);
+    return nullptr != channel ? channel->numObservers() : 0;
+}
+
+unrx4::size_t UNRX4EventBus::pending(UNRX4ChannelId id) const
+{
+    FScopeLock lock(&lock_);
+    Channel* channel = find(id);
+    return nullptr != channel ? channel->pending() : 0;
+}
+
+unrx4::size_t UNRX4EventBus::lowerBound(UNRX4ChannelId id) const
+{
+    unrx4::size_t first = 0;
+    unrx4::size_t count = channels_.size();
+    while(0 < count) {
+        unrx4::size_t half = count >> 1;
+        if(channels_[first + half]->id_ < id) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+UNRX4EventBus::Channel* UNRX4EventBus::find(UNRX4ChannelId id) const
+{
+    unrx4::size_t index = lowerBound(id);
+    return (index < channels_.size() && id == channels_[index]->id_) ? channels_[index] : nullptr;
+}
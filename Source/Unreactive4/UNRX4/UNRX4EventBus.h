@@ -0,0 +1,292 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4EventBus.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4IObserver.h"
+
+#if defined(_MSC_VER)
+#    define UNRX4_FUNCTION_SIGNATURE __FUNCSIG__
+#else
+#    define UNRX4_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#endif
+
+using UNRX4ChannelId = unrx4::u64;
+
+namespace unrx4
+{
+namespace eventbus
+{
+    constexpr unrx4::u64 TypeChannelBit = 0x8000000000000000ULL;
+
+    constexpr unrx4::u64 hash(const char* str)
+    {
+        //FNV-1a
+        unrx4::u64 value = 0xCBF29CE484222325ULL;
+        for(; '\0' != *str; ++str) {
+            value = (value ^ static_cast<unrx4::u8>(*str)) * 0x100000001B3ULL;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Hash of the signature of this function, which names T and is the same in every module
+     */
+    template<class T>
+    constexpr unrx4::u64 typeId()
+    {
+        return hash(UNRX4_FUNCTION_SIGNATURE) | TypeChannelBit;
+    }
+} // namespace eventbus
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Channels of events identified by types or names, which systems subscribe to without knowing each other
+ *
+ * Published events are queued per channel, and dispatched channel by channel once per frame from UNRX4System::endFrame.
+ * Each channel keeps its observers and its pending events in contiguous arrays.
+ * Publishing is thread safe, but subscribing and dispatching must be on the game thread.
+ * Events published while dispatching are dispatched in the next frame.
+ */
+UNREACTIVE4_API
+class UNRX4EventBus
+{
+public:
+    UNRX4EventBus();
+    ~UNRX4EventBus();
+
+    /**
+     * @brief The channel of events of type T
+     */
+    template<class T>
+    static constexpr UNRX4ChannelId channel();
+
+    /**
+     * @brief The channel for a name, events of a named channel must be of one type
+     */
+    static UNRX4ChannelId channel(FName name);
+
+    template<class T>
+    void subscribe(UNRX4IObserver<T>* observer);
+    template<class T>
+    void subscribe(UNRX4ChannelId id, UNRX4IObserver<T>* observer);
+    template<class T>
+    void unsubscribe(UNRX4IObserver<T>* observer);
+    template<class T>
+    void unsubscribe(UNRX4ChannelId id, UNRX4IObserver<T>* observer);
+
+    /**
+     * @brief Queue an event to be dispatched at the end of the frame
+     */
+    template<class T>
+    void publish(T event);
+    template<class T>
+    void publish(UNRX4ChannelId id, T event);
+
+    /**
+     * @brief Dispatch all queued events, channel by channel
+     * @return The number of dispatched events
+     */
+    unrx4::size_t dispatch();
+
+    /**
+     * @brief Destroy all channels with their pending events
+     */
+    void clear();
+
+    unrx4::size_t numChannels() const;
+    unrx4::size_t numObservers(UNRX4ChannelId id) const;
+    unrx4::size_t pending(UNRX4ChannelId id) const;
+
+private:
+    UNRX4EventBus(const UNRX4EventBus&) = delete;
+    UNRX4EventBus& operator=(const UNRX4EventBus&) = delete;
+
+    class Channel
+    {
+    public:
+        Channel(UNRX4ChannelId id, unrx4::u64 type)
+            : id_(id)
+            , type_(type)
+        {
+        }
+        virtual ~Channel() {}
+
+        /**
+         * @brief Move queued events out under the lock of the bus
+         */
+        virtual void swap() = 0;
+
+        /**
+         * @brief Dispatch events moved out by swap
+         */
+        virtual unrx4::size_t dispatch() = 0;
+        virtual unrx4::size_t numObservers() const = 0;
+        virtual unrx4::size_t pending() const = 0;
+
+        UNRX4ChannelId id_;
+        unrx4::u64 type_;
+    };
+
+    template<class T>
+    class TypedChannel: public Channel
+    {
+    public:
+        using observer_type = UNRX4IObserver<T>;
+
+        explicit TypedChannel(UNRX4ChannelId id);
+        virtual void swap() override;
+        virtual unrx4::size_t dispatch() override;
+        virtual unrx4::size_t numObservers() const override;
+        virtual unrx4::size_t pending() const override;
+
+        UNRX4Array<observer_type*> observers_;
+        UNRX4Array<T> events_;
+        UNRX4Array<T> dispatching_;
+    };
+
+    /**
+     * @brief Binary search of the sorted channels
+     */
+    unrx4::size_t lowerBound(UNRX4ChannelId id) const;
+    Channel* find(UNRX4ChannelId id) const;
+
+    template<class T>
+    TypedChannel<T>* findOrAdd(UNRX4ChannelId id);
+
+    mutable FCriticalSection lock_;
+    UNRX4Array<Channel*> channels_;
+};
+
+template<class T>
+constexpr UNRX4ChannelId UNRX4EventBus::channel()
+{
+    return unrx4::eventbus::typeId<T>();
+}
+
+template<class T>
+void UNRX4EventBus::subscribe(UNRX4IObserver<T>* observer)
+{
+    subscribe(channel<T>(), observer);
+}
+
+template<class T>
+void UNRX4EventBus::subscribe(UNRX4ChannelId id, UNRX4IObserver<T>* observer)
+{
+    UNRX4_ASSERT(nullptr != observer);
+    FScopeLock lock(&lock_);
+    findOrAdd<T>(id)->observers_.push_back(observer);
+}
+
+template<class T>
+void UNRX4EventBus::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    unsubscribe(channel<T>(), observer);
+}
+
+template<class T>
+void UNRX4EventBus::unsubscribe(UNRX4ChannelId id, UNRX4IObserver<T>* observer)
+{
+    FScopeLock lock(&lock_);
+    Channel* channel = find(id);
+    if(nullptr == channel) {
+        return;
+    }
+    UNRX4_ASSERT(unrx4::eventbus::typeId<T>() == channel->type_);
+    static_cast<TypedChannel<T>*>(channel)->observers_.remove(observer);
+}
+
+template<class T>
+void UNRX4EventBus::publish(T event)
+{
+    publish(channel<T>(), std::move(event));
+}
+
+template<class T>
+void UNRX4EventBus::publish(UNRX4ChannelId id, T event)
+{
+    FScopeLock lock(&lock_);
+    findOrAdd<T>(id)->events_.push_back(std::move(event));
+}
+
+template<class T>
+UNRX4EventBus::TypedChannel<T>* UNRX4EventBus::findOrAdd(UNRX4ChannelId id)
+{
+    unrx4::size_t index = lowerBound(id);
+    if(index < channels_.size() && id == channels_[index]->id_) {
+        //A named channel carries one type
+        UNRX4_ASSERT(unrx4::eventbus::typeId<T>() == channels_[index]->type_);
+        return static_cast<TypedChannel<T>*>(channels_[index]);
+    }
+    TypedChannel<T>* channel = unrx4_construct<TypedChannel<T>>(id);
+    //Insert keeping the order of ids
+    channels_.push_back(channel);
+    for(unrx4::size_t i = channels_.size() - 1; index < i; --i) {
+        channels_[i] = channels_[i - 1];
+    }
+    channels_[index] = channel;
+    return channel;
+}
+
+//-------------------
+template<class T>
+UNRX4EventBus::TypedChannel<T>::TypedChannel(UNRX4ChannelId id)
+    : Channel(id, unrx4::eventbus::typeId<T>())
+{
+}
+
+template<class T>
+void UNRX4EventBus::TypedChannel<T>::swap()
+{
+    UNRX4Array<T> events(std::move(dispatching_));
+    dispatching_ = std::move(events_);
+    events_ = std::move(events);
+    events_.clear();
+}
+
+template<class T>
+unrx4::size_t UNRX4EventBus::TypedChannel<T>::dispatch()
+{
+    unrx4::size_t size = dispatching_.size();
+    for(unrx4::size_t e = 0; e < size; ++e) {
+        const T& event = dispatching_[e];
+        //An observer can unsubscribe itself while being called
+        for(unrx4::size_t i = 0; i < observers_.size();) {
+            observer_type* observer = observers_[i];
+            observer->next(event);
+            if(i < observers_.size() && observer == observers_[i]) {
+                ++i;
+            }
+        }
+    }
+    dispatching_.clear();
+    return size;
+}
+
+template<class T>
+unrx4::size_t UNRX4EventBus::TypedChannel<T>::numObservers() const
+{
+    return observers_.size();
+}
+
+template<class T>
+unrx4::size_t UNRX4EventBus::TypedChannel<T>::pending() const
+{
+    return events_.size();
+}
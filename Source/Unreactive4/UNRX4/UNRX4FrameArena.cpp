@@ -0,0 +1,136 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4FrameArena.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4FrameArena.h"
+
+UNRX4FrameArena::UNRX4FrameArena()
+    : memory_(nullptr)
+    , end_(nullptr)
+    , capacity_(0)
+    , used_{}
+    , top_(0)
+    , overflows_{}
+    , numOverflows_(0)
+{
+}
+
+UNRX4FrameArena::~UNRX4FrameArena()
+{
+    terminate();
+}
+
+void UNRX4FrameArena::initialize(unrx4::size_t capacity)
+{
+    terminate();
+    capacity_ = (capacity + Alignment - 1) & ~(Alignment - 1);
+    memory_ = reinterpret_cast<unrx4::u8*>(FMemory::Malloc(capacity_ * NumBuffers, Alignment));
+    end_ = memory_ + capacity_ * NumBuffers;
+    for(unrx4::size_t& size: used_) {
+        size = 0;
+    }
+    top_.store(0, std::memory_order_relaxed);
+#if UNRX4_FRAMEARENA_POISON
+    FMemory::Memset(memory_, PoisonPattern, capacity_ * NumBuffers);
+#endif
+}
+
+void UNRX4FrameArena::terminate()
+{
+    for(unrx4::size_t i = 0; i < NumBuffers; ++i) {
+        releaseOverflows(i);
+    }
+    FMemory::Free(memory_);
+    memory_ = nullptr;
+    end_ = nullptr;
+    capacity_ = 0;
+    top_.store(0, std::memory_order_relaxed);
+}
+
+void* UNRX4FrameArena::allocate(unrx4::size_t size)
+{
+    size = HeaderSize + ((size + Alignment - 1) & ~(Alignment - 1));
+    unrx4::u64 top = top_.fetch_add(size, std::memory_order_relaxed);
+    unrx4::size_t frame = static_cast<unrx4::size_t>(top >> FrameShift);
+    unrx4::size_t offset = static_cast<unrx4::size_t>(top & OffsetMask);
+    if(capacity_ < (offset + size)) {
+        return allocateOverflow(frame, size - HeaderSize);
+    }
+    unrx4::u8* ptr = memory_ + capacity_ * frame + offset + HeaderSize;
+    unrx4::setBlockTag(ptr, unrx4::BlockTag::Transient);
+    return ptr;
+}
+
+void UNRX4FrameArena::endFrame()
+{
+    unrx4::u64 top = top_.load(std::memory_order_relaxed);
+    unrx4::size_t current = static_cast<unrx4::size_t>(top >> FrameShift);
+    used_[current] = FMath::Min(static_cast<unrx4::size_t>(top & OffsetMask), capacity_);
+    current = (current + 1) % NumBuffers;
+#if UNRX4_FRAMEARENA_POISON
+    //The next frame reuses the buffer of NumBuffers-1 frames ago
+    if(nullptr != memory_) {
+        FMemory::Memset(memory_ + capacity_ * current, PoisonPattern, used_[current]);
+    }
+#endif
+    used_[current] = 0;
+    releaseOverflows(current);
+    top_.store(static_cast<unrx4::u64>(current) << FrameShift, std::memory_order_relaxed);
+}
+
+unrx4::size_t UNRX4FrameArena::capacity() const
+{
+    return capacity_;
+}
+
+unrx4::size_t UNRX4FrameArena::used() const
+{
+    return FMath::Min(static_cast<unrx4::size_t>(top_.load(std::memory_order_relaxed) & OffsetMask), capacity_);
+}
+
+unrx4::size_t UNRX4FrameArena::overflows() const
+{
+    return numOverflows_.load(std::memory_order_relaxed);
+}
+
+void* UNRX4FrameArena::allocateOverflow(unrx4::size_t frame, unrx4::size_t size)
+{
+    Overflow* overflow = reinterpret_cast<Overflow*>(FMemory::Malloc(sizeof(Overflow) + size, Alignment));
+    //The tag is the last word of the header, just before the block
+    overflow->tag_ = static_cast<unrx4::size_t>(unrx4::BlockTag::Transient);
+    FScopeLock lock(&overflowLock_);
+    overflow->next_ = overflows_[frame];
+    overflows_[frame] = overflow;
+    numOverflows_.fetch_add(1, std::memory_order_release);
+    return overflow + 1;
+}
+
+void UNRX4FrameArena::releaseOverflows(unrx4::size_t frame)
+{
+    Overflow* overflow;
+    {
+        FScopeLock lock(&overflowLock_);
+        overflow = overflows_[frame];
+        overflows_[frame] = nullptr;
+    }
+    while(nullptr != overflow) {
+        Overflow* next = overflow->next_;
+        FMemory::Free(overflow);
+        numOverflows_.fetch_sub(1, std::memory_order_relaxed);
+        overflow = next;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4FrameArena.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4.h"
+#include <atomic>
+
+/**
+ * @brief Set UNRX4_FRAMEARENA_POISON to 1 to fill released frames with a pattern, which catches use-after-frame
+ */
+#ifndef UNRX4_FRAMEARENA_POISON
+#    if !UE_BUILD_SHIPPING
+#        define UNRX4_FRAMEARENA_POISON 1
+#    else
+#        define UNRX4_FRAMEARENA_POISON 0
+#    endif
+#endif
+
+//-------------------
+/**
+ * @brief Bump allocator for transient objects, which is reset in bulk at the end of every frame
+ *
+ * Buffers rotate every frame, so a block stays valid until NumBuffers-1 frames have ended.
+ * Freeing a block is a no-op, and allocation is lock free until a frame is exhausted.
+ * Every block is tagged with unrx4::BlockTag::Transient, so that unrx4_free can skip it without a lookup.
+ * Allocations beyond the capacity of a frame go to heap blocks, which are released with the buffer of the frame.
+ */
+UNREACTIVE4_API
+class UNRX4FrameArena
+{
+public:
+    static constexpr unrx4::size_t NumBuffers = 3;
+    static constexpr unrx4::size_t Alignment = 16;
+    static constexpr unrx4::size_t DefaultCapacity = 64 * 1024;
+    static constexpr unrx4::u8 PoisonPattern = 0xDDU;
+
+    UNRX4FrameArena();
+    ~UNRX4FrameArena();
+
+    /**
+     * @brief Allocate all buffers in a contiguous region
+     * @param capacity ... Size of a buffer for one frame
+     */
+    void initialize(unrx4::size_t capacity);
+    void terminate();
+
+    /**
+     * @brief Allocate from the current frame, or from a heap block of the frame if it is exhausted
+     */
+    void* allocate(unrx4::size_t size);
+
+    /**
+     * @brief Whether a pointer is in the buffers of this arena. Heap blocks of exhausted frames are not included.
+     */
+    bool contains(const void* ptr) const;
+
+    /**
+     * @brief Rotate the buffers, and reset the oldest one with its heap blocks. Call this on one thread at a time.
+     */
+    void endFrame();
+
+    unrx4::size_t capacity() const;
+    unrx4::size_t used() const;
+
+    /**
+     * @brief The number of heap blocks of exhausted frames, which are not released yet
+     */
+    unrx4::size_t overflows() const;
+
+private:
+    UNRX4FrameArena(const UNRX4FrameArena&) = delete;
+    UNRX4FrameArena& operator=(const UNRX4FrameArena&) = delete;
+
+    //The frame is in the upper bits of top_, then an allocation reads the frame and the offset at once
+    static constexpr unrx4::u32 FrameShift = 48;
+    static constexpr unrx4::u64 OffsetMask = (static_cast<unrx4::u64>(1) << FrameShift) - 1;
+    //A tag before a block, which keeps the alignment
+    static constexpr unrx4::size_t HeaderSize = Alignment;
+
+    struct alignas(Alignment) Overflow
+    {
+        Overflow* next_;
+        unrx4::size_t tag_;
+    };
+
+    void* allocateOverflow(unrx4::size_t frame, unrx4::size_t size);
+    void releaseOverflows(unrx4::size_t frame);
+
+    unrx4::u8* memory_;
+    unrx4::u8* end_;
+    unrx4::size_t capacity_;
+    unrx4::size_t used_[NumBuffers];
+    std::atomic<unrx4::u64> top_;
+    FCriticalSection overflowLock_;
+    Overflow* overflows_[NumBuffers];
+    std::atomic<unrx4::size_t> numOverflows_;
+};
+
+FORCEINLINE bool UNRX4FrameArena::contains(const void* ptr) const
+{
+    const unrx4::u8* p = reinterpret_cast<const unrx4::u8*>(ptr);
+    return memory_ <= p && p < end_;
+}
@@ -20,78 +20,119 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
 #include "UNRX4Container.h"
 #include "UNRX4IObservable.h"
 #include "UNRX4IObserver.h"
+#include "UNRX4Trace.h"
+
+namespace unrx4
+{
+namespace group
+{
+    /**
+     * @brief Call a function for each observer, which can unsubscribe itself while being called
+     */
+    template<class T, class F>
+    void forEach(UNRX4Array<UNRX4IObserver<T>*>& observers, F f)
+    {
+        for(unrx4::size_t i = 0; i < observers.size();) {
+            UNRX4IObserver<T>* observer = observers[i];
+            f(observer);
+            if(i < observers.size() && observer == observers[i]) {
+                ++i;
+            }
+        }
+    }
+
+    template<class T, class F>
+    void forEach(UNRX4ObserverList<T>& observers, F f)
+    {
+        observers.forEach(f);
+    }
+} // namespace group
+} // namespace unrx4
 
 /**
+ * @brief Observable which forwards values to a group of observers
+ * @tparam T ... Type of values
+ * @tparam Observers ... UNRX4Array of observers as default, or UNRX4ObserverList<T> to link observers without allocation,
+ * then an observer can be in only one group at a time and groups are not movable
  */
-template<class T>
+template<class T, class Observers = UNRX4Array<UNRX4IObserver<T>*>>
 class UNRX4GroupObservable: public UNRX4IObservable<T>
 {
 public:
-    using pass_type = UNRX4IObservable<T>::pass_type;
     using observer_type = UNRX4IObserver<T>;
 
     UNRX4GroupObservable();
     UNRX4GroupObservable(UNRX4GroupObservable&& other);
     virtual ~UNRX4GroupObservable();
     virtual void subscribe(observer_type* observer) override;
-    virtual void dispatch(pass_type value) override;
-    virtual void dispatchError(unrx4::error_code_type errorCode) override;
+    virtual void unsubscribe(observer_type* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
     virtual void completed() override;
 
     UNRX4GroupObservable& operator=(UNRX4GroupObservable&& other);
 
 private:
-    UNRX4Array<observer_type*> observers_;
+    Observers observers_;
 };
 
-template<class T>
-UNRX4GroupObservable<T>::UNRX4GroupObservable()
+template<class T, class Observers>
+UNRX4GroupObservable<T, Observers>::UNRX4GroupObservable()
 {
 }
 
-template<class T>
-UNRX4GroupObservable<T>::UNRX4GroupObservable(UNRX4GroupObservable&& other)
+template<class T, class Observers>
+UNRX4GroupObservable<T, Observers>::UNRX4GroupObservable(UNRX4GroupObservable&& other)
     : observers_(std::move(other.observers_))
 {
 }
 
-template<class T>
-UNRX4GroupObservable<T>::~UNRX4GroupObservable()
+template<class T, class Observers>
+UNRX4GroupObservable<T, Observers>::~UNRX4GroupObservable()
 {
 }
 
-template<class T>
-void UNRX4GroupObservable<T>::subscribe(observer_type* observer)
+template<class T, class Observers>
+void UNRX4GroupObservable<T, Observers>::subscribe(observer_type* observer)
 {
     observers_.push_back(observer);
 }
 
-template<class T>
-void UNRX4GroupObservable<T>::dispatch(pass_type value)
+template<class T, class Observers>
+void UNRX4GroupObservable<T, Observers>::unsubscribe(observer_type* observer)
 {
-    for(observer_type* observer: observers_) {
+    observers_.remove(observer);
+}
+
+template<class T, class Observers>
+void UNRX4GroupObservable<T, Observers>::next(T value)
+{
+    UNRX4_TRACE_DISPATCH("UNRX4GroupObservable::next", this, observers_.size());
+    unrx4::group::forEach(observers_, [&value](observer_type* observer) {
         observer->next(value);
-    }
+    });
 }
 
-template<class T>
-void UNRX4GroupObservable<T>::dispatchError(unrx4::error_code_type errorCode)
+template<class T, class Observers>
+void UNRX4GroupObservable<T, Observers>::error(unrx4::error_code_type errorCode)
 {
-    for(observer_type* observer: observers_) {
+    UNRX4_TRACE_DISPATCH("UNRX4GroupObservable::error", this, observers_.size());
+    unrx4::group::forEach(observers_, [errorCode](observer_type* observer) {
         observer->error(errorCode);
-    }
+    });
 }
 
-template<class T>
-void UNRX4GroupObservable<T>::completed()
+template<class T, class Observers>
+void UNRX4GroupObservable<T, Observers>::completed()
 {
-    for(observer_type* observer: observers_) {
+    UNRX4_TRACE_DISPATCH("UNRX4GroupObservable::completed", this, observers_.size());
+    unrx4::group::forEach(observers_, [](observer_type* observer) {
         observer->completed();
-    }
+    });
 }
 
-template<class T>
-UNRX4GroupObservable<T>& UNRX4GroupObservable<T>::operator=(UNRX4GroupObservable<T>&& other)
+template<class T, class Observers>
+UNRX4GroupObservable<T, Observers>& UNRX4GroupObservable<T, Observers>::operator=(UNRX4GroupObservable&& other)
 {
     if(this == &other) {
         return *this;
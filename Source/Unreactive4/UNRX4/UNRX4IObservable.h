@@ -18,6 +18,7 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  */
 // clang-format on
 #include "Unreactive4.h"
+#include "UNRX4.h"
 
 template<class... Args>
 class UNRX4IObserver;
@@ -32,6 +33,27 @@ public:
     virtual ~UNRX4IObservable() {}
     virtual void subscribe(UNRX4IObserver<Args...>* observer) = 0;
     virtual void unsubscribe(UNRX4IObserver<Args...>* observer) = 0;
+
+    /**
+     * @brief Subscribe observers at once, observables can override this to apply structural changes in one pass
+     */
+    virtual void subscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count)
+    {
+        for(unrx4::size_t i = 0; i < count; ++i) {
+            subscribe(observers[i]);
+        }
+    }
+
+    /**
+     * @brief Unsubscribe observers at once, observables can override this to apply structural changes in one pass
+     */
+    virtual void unsubscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count)
+    {
+        for(unrx4::size_t i = 0; i < count; ++i) {
+            unsubscribe(observers[i]);
+        }
+    }
+
     virtual void next(Args... value) = 0;
     virtual void error(unrx4::error_code_type errorCode) = 0;
     virtual void completed() = 0;
@@ -18,6 +18,10 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  */
 // clang-format on
 #include "Unreactive4.h"
+#include "UNRX4.h"
+
+template<class... Args>
+class UNRX4ObserverList;
 
 /**
  * @brief Observing changes or events, and pass those events to subscribers
@@ -26,12 +30,182 @@ template<class... Args>
 class UNRX4IObserver
 {
 public:
-    virtual ~UNRX4IObserver() {}
+    virtual ~UNRX4IObserver();
     virtual void next(Args...) = 0;
     virtual void error(unrx4::error_code_type errorCode) = 0;
     virtual void completed() = 0;
 
 protected:
-    UNRX4IObserver(){}
+    UNRX4IObserver()
+        : prevObserver_(nullptr)
+        , nextObserver_(nullptr)
+        , observerList_(nullptr)
+    {
+    }
+
+    UNRX4IObserver(const UNRX4IObserver&)
+        : prevObserver_(nullptr)
+        , nextObserver_(nullptr)
+        , observerList_(nullptr)
+    {
+    }
+
+    UNRX4IObserver& operator=(const UNRX4IObserver&)
+    {
+        return *this;
+    }
+
+private:
+    friend class UNRX4ObserverList<Args...>;
+
+    //Hook of UNRX4ObserverList, an observer can be linked to one list at a time
+    UNRX4IObserver* prevObserver_;
+    UNRX4IObserver* nextObserver_;
+    UNRX4ObserverList<Args...>* observerList_;
 };
 
+//-------------------
+/**
+ * @brief Intrusive list of observers. Linking and unlinking are O(1) and allocate nothing.
+ *
+ * Observers can unsubscribe any observer, including themselves, while the list is being iterated.
+ * A destructed observer unlinks itself.
+ */
+template<class... Args>
+class UNRX4ObserverList
+{
+public:
+    using observer_type = UNRX4IObserver<Args...>;
+
+    UNRX4ObserverList();
+    ~UNRX4ObserverList();
+
+    unrx4::size_t size() const;
+    bool contains(const observer_type* observer) const;
+
+    void push_back(observer_type* observer);
+    void remove(observer_type* observer);
+    void clear();
+
+    /**
+     * @brief Call a function for each observer, which can unlink observers while iterating
+     */
+    template<class F>
+    void forEach(F f);
+
+private:
+    UNRX4ObserverList(const UNRX4ObserverList&) = delete;
+    UNRX4ObserverList& operator=(const UNRX4ObserverList&) = delete;
+
+    struct Iteration
+    {
+        observer_type* next_;
+        Iteration* outer_;
+    };
+
+    observer_type* head_;
+    observer_type* tail_;
+    Iteration* iteration_;
+    unrx4::size_t size_;
+};
+
+template<class... Args>
+UNRX4IObserver<Args...>::~UNRX4IObserver()
+{
+    if(nullptr != observerList_) {
+        observerList_->remove(this);
+    }
+}
+
+template<class... Args>
+UNRX4ObserverList<Args...>::UNRX4ObserverList()
+    : head_(nullptr)
+    , tail_(nullptr)
+    , iteration_(nullptr)
+    , size_(0)
+{
+}
+
+template<class... Args>
+UNRX4ObserverList<Args...>::~UNRX4ObserverList()
+{
+    clear();
+}
+
+template<class... Args>
+unrx4::size_t UNRX4ObserverList<Args...>::size() const
+{
+    return size_;
+}
+
+template<class... Args>
+bool UNRX4ObserverList<Args...>::contains(const observer_type* observer) const
+{
+    return this == observer->observerList_;
+}
+
+template<class... Args>
+void UNRX4ObserverList<Args...>::push_back(observer_type* observer)
+{
+    UNRX4_ASSERT(nullptr != observer);
+    UNRX4_ASSERT(nullptr == observer->observerList_);
+    observer->observerList_ = this;
+    observer->prevObserver_ = tail_;
+    observer->nextObserver_ = nullptr;
+    if(nullptr == tail_) {
+        head_ = observer;
+    } else {
+        tail_->nextObserver_ = observer;
+    }
+    tail_ = observer;
+    ++size_;
+}
+
+template<class... Args>
+void UNRX4ObserverList<Args...>::remove(observer_type* observer)
+{
+    if(this != observer->observerList_) {
+        return;
+    }
+    for(Iteration* iteration = iteration_; nullptr != iteration; iteration = iteration->outer_) {
+        if(observer == iteration->next_) {
+            iteration->next_ = observer->nextObserver_;
+        }
+    }
+    if(nullptr == observer->prevObserver_) {
+        head_ = observer->nextObserver_;
+    } else {
+        observer->prevObserver_->nextObserver_ = observer->nextObserver_;
+    }
+    if(nullptr == observer->nextObserver_) {
+        tail_ = observer->prevObserver_;
+    } else {
+        observer->nextObserver_->prevObserver_ = observer->prevObserver_;
+    }
+    observer->prevObserver_ = nullptr;
+    observer->nextObserver_ = nullptr;
+    observer->observerList_ = nullptr;
+    --size_;
+}
+
+template<class... Args>
+void UNRX4ObserverList<Args...>::clear()
+{
+    while(nullptr != head_) {
+        remove(head_);
+    }
+}
+
+template<class... Args>
+template<class F>
+void UNRX4ObserverList<Args...>::forEach(F f)
+{
+    Iteration iteration = {head_, iteration_};
+    iteration_ = &iteration;
+    while(nullptr != iteration.next_) {
+        observer_type* observer = iteration.next_;
+        iteration.next_ = observer->nextObserver_;
+        f(observer);
+    }
+    iteration_ = iteration.outer_;
+}
@@ -32,6 +32,14 @@ public:
     }
     virtual void schedule(UNRX4Action action) = 0;
 
+    /**
+     * @brief Whether schedule can be called on any thread
+     */
+    virtual bool isThreadSafe() const
+    {
+        return false;
+    }
+
 protected:
     UNRX4IScheduler() {}
 };
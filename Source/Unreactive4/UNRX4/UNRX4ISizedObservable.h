@@ -0,0 +1,112 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ISizedObservable.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4IObservable.h"
+
+/**
+ * @brief Finite source which knows its size, and gives random access to its values
+ */
+template<class T>
+class UNRX4ISizedObservable: public UNRX4IObservable<T>
+{
+public:
+    virtual ~UNRX4ISizedObservable() {}
+    virtual unrx4::size_t size() const = 0;
+
+    /**
+     * @brief Whether read needs a scratch buffer, sources which hold their values do not
+     */
+    virtual bool needsScratch() const { return true; }
+
+    /**
+     * @brief Get values in [offset, offset+count)
+     * @param scratch ... Uninitialized storage of count elements, sources which generate values construct them there
+     */
+    virtual UNRX4Batch<T> read(unrx4::size_t offset, unrx4::size_t count, T* scratch) const = 0;
+
+protected:
+    UNRX4ISizedObservable() {}
+};
+
+//-------------------
+/**
+ * @brief Uninitialized storage to read a sized source, which is allocated only if the source needs it
+ */
+template<class T>
+class UNRX4SizedScratch
+{
+public:
+    UNRX4SizedScratch();
+    ~UNRX4SizedScratch();
+
+    /**
+     * @brief Get storage for count values, or nullptr if the source does not need it
+     */
+    T* prepare(const UNRX4ISizedObservable<T>& source, unrx4::size_t count);
+
+    /**
+     * @brief Destruct values which the source constructed in this storage
+     */
+    void release(const UNRX4Batch<T>& values);
+
+private:
+    UNRX4SizedScratch(const UNRX4SizedScratch&) = delete;
+    UNRX4SizedScratch& operator=(const UNRX4SizedScratch&) = delete;
+
+    T* items_;
+    unrx4::size_t capacity_;
+};
+
+template<class T>
+UNRX4SizedScratch<T>::UNRX4SizedScratch()
+    : items_(nullptr)
+    , capacity_(0)
+{
+}
+
+template<class T>
+UNRX4SizedScratch<T>::~UNRX4SizedScratch()
+{
+    FMemory::Free(items_);
+}
+
+template<class T>
+T* UNRX4SizedScratch<T>::prepare(const UNRX4ISizedObservable<T>& source, unrx4::size_t count)
+{
+    if(!source.needsScratch()) {
+        return nullptr;
+    }
+    if(capacity_ < count) {
+        FMemory::Free(items_);
+        items_ = reinterpret_cast<T*>(FMemory::Malloc(sizeof(T) * count, alignof(T)));
+        capacity_ = count;
+    }
+    return items_;
+}
+
+template<class T>
+void UNRX4SizedScratch<T>::release(const UNRX4Batch<T>& values)
+{
+    if(nullptr == items_ || values.GetData() != items_) {
+        return;
+    }
+    for(int32 i = 0; i < values.Num(); ++i) {
+        items_[i].~T();
+    }
+}
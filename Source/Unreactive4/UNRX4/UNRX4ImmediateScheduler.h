@@ -28,4 +28,5 @@ public:
     UNRX4ImmediateScheduler() {}
     virtual ~UNRX4ImmediateScheduler() {}
     virtual void schedule(UNRX4Action action);
+    virtual bool isThreadSafe() const override { return true; }
 };
@@ -0,0 +1,264 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Multicast.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Operator.h"
+
+//-------------------
+/**
+ * @brief Share one subscription of a source, which is made by connect, not by subscribe
+ */
+template<class T>
+class UNRX4PublishObservable: public UNRX4Operator<UNRX4PublishObservable<T>, T>
+{
+    using base_type = UNRX4Operator<UNRX4PublishObservable<T>, T>;
+    friend base_type;
+
+public:
+    explicit UNRX4PublishObservable(UNRX4IObservable<T>* source);
+
+    /**
+     * @brief Subscribe the source, cold sources run here once for all observers
+     */
+    void connect();
+    void disconnect();
+    bool isConnected() const;
+
+private:
+    void onNext(const T& value);
+};
+
+template<class T>
+UNRX4PublishObservable<T>::UNRX4PublishObservable(UNRX4IObservable<T>* source)
+    : base_type(source)
+{
+    this->setAutoConnect(false);
+}
+
+template<class T>
+void UNRX4PublishObservable<T>::connect()
+{
+    base_type::connect();
+}
+
+template<class T>
+void UNRX4PublishObservable<T>::disconnect()
+{
+    base_type::disconnect();
+}
+
+template<class T>
+bool UNRX4PublishObservable<T>::isConnected() const
+{
+    return base_type::isConnected();
+}
+
+template<class T>
+void UNRX4PublishObservable<T>::onNext(const T& value)
+{
+    this->emit(value);
+}
+
+//-------------------
+/**
+ * @brief Connect the source while there are observers
+ *
+ * The connection is reset when the source terminates, then the next observer connects again,
+ * so a cold source runs again for late observers.
+ */
+template<class T>
+class UNRX4ShareObservable: public UNRX4Operator<UNRX4ShareObservable<T>, T>
+{
+    using base_type = UNRX4Operator<UNRX4ShareObservable<T>, T>;
+    friend base_type;
+
+public:
+    explicit UNRX4ShareObservable(UNRX4IObservable<T>* source);
+
+private:
+    void onNext(const T& value);
+    void onError(unrx4::error_code_type errorCode);
+    void onCompleted();
+};
+
+template<class T>
+UNRX4ShareObservable<T>::UNRX4ShareObservable(UNRX4IObservable<T>* source)
+    : base_type(source)
+{
+}
+
+template<class T>
+void UNRX4ShareObservable<T>::onNext(const T& value)
+{
+    this->emit(value);
+}
+
+template<class T>
+void UNRX4ShareObservable<T>::onError(unrx4::error_code_type errorCode)
+{
+    //Reset first, observers can subscribe again while being called
+    UNRX4Array<UNRX4IObserver<T>*> observers = this->reset();
+    for(UNRX4IObserver<T>* observer: observers) {
+        observer->error(errorCode);
+    }
+}
+
+template<class T>
+void UNRX4ShareObservable<T>::onCompleted()
+{
+    UNRX4Array<UNRX4IObserver<T>*> observers = this->reset();
+    for(UNRX4IObserver<T>* observer: observers) {
+        observer->completed();
+    }
+}
+
+//-------------------
+/**
+ * @brief Same as UNRX4ShareObservable, and replay the last values and the termination to late observers
+ *
+ * Values are kept in a ring buffer, they remain while the source is disconnected.
+ */
+template<class T>
+class UNRX4ShareReplayObservable: public UNRX4Operator<UNRX4ShareReplayObservable<T>, T>
+{
+    using base_type = UNRX4Operator<UNRX4ShareReplayObservable<T>, T>;
+    friend base_type;
+
+public:
+    UNRX4ShareReplayObservable(UNRX4IObservable<T>* source, unrx4::size_t capacity);
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+
+private:
+    enum class Termination
+    {
+        None,
+        Error,
+        Completed,
+    };
+
+    void onNext(const T& value);
+    void onError(unrx4::error_code_type errorCode);
+    void onCompleted();
+
+    unrx4::size_t capacity_;
+    unrx4::size_t head_;
+    UNRX4Array<T> values_;
+    Termination termination_;
+    unrx4::error_code_type errorCode_;
+};
+
+template<class T>
+UNRX4ShareReplayObservable<T>::UNRX4ShareReplayObservable(UNRX4IObservable<T>* source, unrx4::size_t capacity)
+    : base_type(source)
+    , capacity_(capacity)
+    , head_(0)
+    , values_(capacity)
+    , termination_(Termination::None)
+    , errorCode_(0)
+{
+}
+
+template<class T>
+void UNRX4ShareReplayObservable<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    //The oldest is at head_ once the buffer is full
+    unrx4::size_t size = values_.size();
+    for(unrx4::size_t i = 0; i < size; ++i) {
+        unrx4::size_t index = head_ + i;
+        observer->next(values_[size <= index ? index - size : index]);
+    }
+    switch(termination_) {
+    case Termination::Error:
+        observer->error(errorCode_);
+        return;
+    case Termination::Completed:
+        observer->completed();
+        return;
+    default:
+        break;
+    }
+    base_type::subscribe(observer);
+}
+
+template<class T>
+void UNRX4ShareReplayObservable<T>::onNext(const T& value)
+{
+    if(0 < capacity_) {
+        if(values_.size() < capacity_) {
+            values_.push_back(value);
+        } else {
+            values_[head_] = value;
+            head_ = (head_ + 1) < capacity_ ? head_ + 1 : 0;
+        }
+    }
+    this->emit(value);
+}
+
+template<class T>
+void UNRX4ShareReplayObservable<T>::onError(unrx4::error_code_type errorCode)
+{
+    termination_ = Termination::Error;
+    errorCode_ = errorCode;
+    this->error(errorCode);
+}
+
+template<class T>
+void UNRX4ShareReplayObservable<T>::onCompleted()
+{
+    termination_ = Termination::Completed;
+    this->completed();
+}
+
+//-------------------
+/**
+ * @brief Factories of multicasting, N observers cost one execution of the source
+ */
+class UNRX4Multicast
+{
+public:
+    template<class T>
+    static unrx4_unique_ptr<UNRX4PublishObservable<T>> publish(UNRX4IObservable<T>* source);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> share(UNRX4IObservable<T>* source);
+
+    /**
+     * @param capacity ... The number of values to replay
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> shareReplay(UNRX4IObservable<T>* source, unrx4::size_t capacity);
+};
+
+template<class T>
+unrx4_unique_ptr<UNRX4PublishObservable<T>> UNRX4Multicast::publish(UNRX4IObservable<T>* source)
+{
+    return unrx4_make_unique<UNRX4PublishObservable<T>>(source);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Multicast::share(UNRX4IObservable<T>* source)
+{
+    return unrx4_make_unique<UNRX4ShareObservable<T>>(source);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Multicast::shareReplay(UNRX4IObservable<T>* source, unrx4::size_t capacity)
+{
+    return unrx4_make_unique<UNRX4ShareReplayObservable<T>>(source, capacity);
+}
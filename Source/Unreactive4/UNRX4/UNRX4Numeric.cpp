@@ -0,0 +1,685 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Numeric.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Numeric.h"
+#if !UE_BUILD_SHIPPING
+#    include <HAL/IConsoleManager.h>
+#endif
+
+namespace unrx4
+{
+namespace numeric
+{
+    namespace
+    {
+        const float* toFloats(const FVector* x)
+        {
+            static_assert(sizeof(FVector) == sizeof(float) * 3, "FVector should be three floats");
+            return reinterpret_cast<const float*>(x);
+        }
+
+        float* toFloats(FVector* x)
+        {
+            return reinterpret_cast<float*>(x);
+        }
+
+#if UNRX4_NUMERIC_VERIFY || !UE_BUILD_SHIPPING
+        bool nearlyEqual(float x0, float x1, float magnitude)
+        {
+            float d = x0 - x1;
+            d = d < 0.0f ? -d : d;
+            return d <= 1.0e-4f * (magnitude + 1.0f);
+        }
+
+        float magnitude(const float* src, unrx4::size_t size)
+        {
+            float m = 0.0f;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                m += src[i] < 0.0f ? -src[i] : src[i];
+            }
+            return m;
+        }
+#endif
+
+        float sumFloats(const float* src, unrx4::size_t size)
+        {
+            //Four independent accumulators to hide latency of additions
+            VectorRegister s0 = VectorZero();
+            VectorRegister s1 = VectorZero();
+            VectorRegister s2 = VectorZero();
+            VectorRegister s3 = VectorZero();
+            unrx4::size_t i = 0;
+            for(; (i + 16) <= size; i += 16) {
+                s0 = VectorAdd(s0, VectorLoad(src + i));
+                s1 = VectorAdd(s1, VectorLoad(src + i + 4));
+                s2 = VectorAdd(s2, VectorLoad(src + i + 8));
+                s3 = VectorAdd(s3, VectorLoad(src + i + 12));
+            }
+            for(; (i + 4) <= size; i += 4) {
+                s0 = VectorAdd(s0, VectorLoad(src + i));
+            }
+            s0 = VectorAdd(VectorAdd(s0, s1), VectorAdd(s2, s3));
+            float lanes[4];
+            VectorStore(s0, lanes);
+            float result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for(; i < size; ++i) {
+                result += src[i];
+            }
+            return result;
+        }
+
+        void affineFloats(float* dst, const float* src, unrx4::size_t size, float scale, float bias)
+        {
+            VectorRegister s = VectorSetFloat1(scale);
+            VectorRegister b = VectorSetFloat1(bias);
+            unrx4::size_t i = 0;
+            for(; (i + 4) <= size; i += 4) {
+                VectorStore(VectorMultiplyAdd(VectorLoad(src + i), s, b), dst + i);
+            }
+            for(; i < size; ++i) {
+                dst[i] = src[i] * scale + bias;
+            }
+        }
+
+        void clampFloats(float* dst, const float* src, unrx4::size_t size, float lower, float upper)
+        {
+            VectorRegister l = VectorSetFloat1(lower);
+            VectorRegister u = VectorSetFloat1(upper);
+            unrx4::size_t i = 0;
+            for(; (i + 4) <= size; i += 4) {
+                VectorStore(VectorMin(VectorMax(VectorLoad(src + i), l), u), dst + i);
+            }
+            for(; i < size; ++i) {
+                float x = src[i] < lower ? lower : src[i];
+                dst[i] = upper < x ? upper : x;
+            }
+        }
+
+        /**
+         * @brief Reduce twelve floats, four FVectors, at once
+         *
+         * Each register has a fixed rotation of components, x y z x | y z x y | z x y z.
+         */
+        template<class Op>
+        FVector reduceVectors(const FVector* src, unrx4::size_t size, const FVector& initial, Op op)
+        {
+            const float* f = toFloats(src);
+            FVector result = initial;
+            unrx4::size_t i = 0;
+            if(4 <= size) {
+                VectorRegister r0 = VectorLoad(f);
+                VectorRegister r1 = VectorLoad(f + 4);
+                VectorRegister r2 = VectorLoad(f + 8);
+                for(i = 4; (i + 4) <= size; i += 4) {
+                    const float* p = f + i * 3;
+                    r0 = op(r0, VectorLoad(p));
+                    r1 = op(r1, VectorLoad(p + 4));
+                    r2 = op(r2, VectorLoad(p + 8));
+                }
+                float l0[4];
+                float l1[4];
+                float l2[4];
+                VectorStore(r0, l0);
+                VectorStore(r1, l1);
+                VectorStore(r2, l2);
+                FVector v0(l0[0], l0[1], l0[2]);
+                FVector v1(l0[3], l1[0], l1[1]);
+                FVector v2(l1[2], l1[3], l2[0]);
+                FVector v3(l2[1], l2[2], l2[3]);
+                result = op(op(v0, v1), op(v2, v3));
+            }
+            for(; i < size; ++i) {
+                result = op(result, src[i]);
+            }
+            return result;
+        }
+
+        struct VectorAddOp
+        {
+            VectorRegister operator()(const VectorRegister& x0, const VectorRegister& x1) const { return VectorAdd(x0, x1); }
+            FVector operator()(const FVector& x0, const FVector& x1) const { return x0 + x1; }
+        };
+
+        struct VectorMinOp
+        {
+            VectorRegister operator()(const VectorRegister& x0, const VectorRegister& x1) const { return VectorMin(x0, x1); }
+            FVector operator()(const FVector& x0, const FVector& x1) const { return x0.ComponentMin(x1); }
+        };
+
+        struct VectorMaxOp
+        {
+            VectorRegister operator()(const VectorRegister& x0, const VectorRegister& x1) const { return VectorMax(x0, x1); }
+            FVector operator()(const FVector& x0, const FVector& x1) const { return x0.ComponentMax(x1); }
+        };
+    } // namespace
+
+    float sum(const float* src, unrx4::size_t size)
+    {
+        float result = sumFloats(src, size);
+#if UNRX4_NUMERIC_VERIFY
+        UNRX4_ASSERT(nearlyEqual(result, scalar::sum(src, size), magnitude(src, size)));
+#endif
+        return result;
+    }
+
+    unrx4::s64 sum(const unrx4::s32* src, unrx4::size_t size)
+    {
+        //There is no widening addition in VectorRegisterInt, let compilers vectorize this
+        unrx4::s64 s0 = 0;
+        unrx4::s64 s1 = 0;
+        unrx4::s64 s2 = 0;
+        unrx4::s64 s3 = 0;
+        unrx4::size_t i = 0;
+        for(; (i + 4) <= size; i += 4) {
+            s0 += src[i];
+            s1 += src[i + 1];
+            s2 += src[i + 2];
+            s3 += src[i + 3];
+        }
+        for(; i < size; ++i) {
+            s0 += src[i];
+        }
+        unrx4::s64 result = (s0 + s1) + (s2 + s3);
+#if UNRX4_NUMERIC_VERIFY
+        UNRX4_ASSERT(result == scalar::sum(src, size));
+#endif
+        return result;
+    }
+
+    FVector sum(const FVector* src, unrx4::size_t size)
+    {
+        FVector result = reduceVectors(src, size, FVector::ZeroVector, VectorAddOp());
+#if UNRX4_NUMERIC_VERIFY
+        FVector expected = scalar::sum(src, size);
+        float m = magnitude(toFloats(src), size * 3);
+        UNRX4_ASSERT(nearlyEqual(result.X, expected.X, m) && nearlyEqual(result.Y, expected.Y, m) && nearlyEqual(result.Z, expected.Z, m));
+#endif
+        return result;
+    }
+
+    void minMax(float& outMin, float& outMax, const float* src, unrx4::size_t size)
+    {
+        UNRX4_ASSERT(0 < size);
+        unrx4::size_t i = 0;
+        float minValue = src[0];
+        float maxValue = src[0];
+        if(4 <= size) {
+            VectorRegister l = VectorLoad(src);
+            VectorRegister u = l;
+            for(i = 4; (i + 4) <= size; i += 4) {
+                VectorRegister x = VectorLoad(src + i);
+                l = VectorMin(l, x);
+                u = VectorMax(u, x);
+            }
+            float lanes[4];
+            VectorStore(l, lanes);
+            minValue = FMath::Min(FMath::Min(lanes[0], lanes[1]), FMath::Min(lanes[2], lanes[3]));
+            VectorStore(u, lanes);
+            maxValue = FMath::Max(FMath::Max(lanes[0], lanes[1]), FMath::Max(lanes[2], lanes[3]));
+        }
+        for(; i < size; ++i) {
+            minValue = FMath::Min(minValue, src[i]);
+            maxValue = FMath::Max(maxValue, src[i]);
+        }
+        outMin = minValue;
+        outMax = maxValue;
+#if UNRX4_NUMERIC_VERIFY
+        float expectedMin;
+        float expectedMax;
+        scalar::minMax(expectedMin, expectedMax, src, size);
+        UNRX4_ASSERT(expectedMin == outMin && expectedMax == outMax);
+#endif
+    }
+
+    void minMax(unrx4::s32& outMin, unrx4::s32& outMax, const unrx4::s32* src, unrx4::size_t size)
+    {
+        UNRX4_ASSERT(0 < size);
+        unrx4::size_t i = 0;
+        unrx4::s32 minValue = src[0];
+        unrx4::s32 maxValue = src[0];
+        if(4 <= size) {
+            VectorRegisterInt l = VectorIntLoad(src);
+            VectorRegisterInt u = l;
+            for(i = 4; (i + 4) <= size; i += 4) {
+                VectorRegisterInt x = VectorIntLoad(src + i);
+                l = VectorIntMin(l, x);
+                u = VectorIntMax(u, x);
+            }
+            unrx4::s32 lanes[4];
+            VectorIntStore(l, lanes);
+            minValue = FMath::Min(FMath::Min(lanes[0], lanes[1]), FMath::Min(lanes[2], lanes[3]));
+            VectorIntStore(u, lanes);
+            maxValue = FMath::Max(FMath::Max(lanes[0], lanes[1]), FMath::Max(lanes[2], lanes[3]));
+        }
+        for(; i < size; ++i) {
+            minValue = FMath::Min(minValue, src[i]);
+            maxValue = FMath::Max(maxValue, src[i]);
+        }
+        outMin = minValue;
+        outMax = maxValue;
+#if UNRX4_NUMERIC_VERIFY
+        unrx4::s32 expectedMin;
+        unrx4::s32 expectedMax;
+        scalar::minMax(expectedMin, expectedMax, src, size);
+        UNRX4_ASSERT(expectedMin == outMin && expectedMax == outMax);
+#endif
+    }
+
+    void minMax(FVector& outMin, FVector& outMax, const FVector* src, unrx4::size_t size)
+    {
+        UNRX4_ASSERT(0 < size);
+        outMin = reduceVectors(src, size, src[0], VectorMinOp());
+        outMax = reduceVectors(src, size, src[0], VectorMaxOp());
+#if UNRX4_NUMERIC_VERIFY
+        FVector expectedMin;
+        FVector expectedMax;
+        scalar::minMax(expectedMin, expectedMax, src, size);
+        UNRX4_ASSERT(expectedMin.Equals(outMin, 0.0f) && expectedMax.Equals(outMax, 0.0f));
+#endif
+    }
+
+    void affine(float* dst, const float* src, unrx4::size_t size, float scale, float bias)
+    {
+        affineFloats(dst, src, size, scale, bias);
+#if UNRX4_NUMERIC_VERIFY
+        for(unrx4::size_t i = 0; i < size; ++i) {
+            UNRX4_ASSERT(nearlyEqual(dst[i], src[i] * scale + bias, src[i] < 0.0f ? -src[i] : src[i]));
+        }
+#endif
+    }
+
+    void affine(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 scale, unrx4::s32 bias)
+    {
+        VectorRegisterInt s = VectorIntSet1(scale);
+        VectorRegisterInt b = VectorIntSet1(bias);
+        unrx4::size_t i = 0;
+        for(; (i + 4) <= size; i += 4) {
+            VectorIntStore(VectorIntAdd(VectorIntMultiply(VectorIntLoad(src + i), s), b), dst + i);
+        }
+        scalar::affine(dst + i, src + i, size - i, scale, bias);
+#if UNRX4_NUMERIC_VERIFY
+        for(unrx4::size_t j = 0; j < size; ++j) {
+            unrx4::s32 expected;
+            scalar::affine(&expected, src + j, 1, scale, bias);
+            UNRX4_ASSERT(expected == dst[j]);
+        }
+#endif
+    }
+
+    void affine(FVector* dst, const FVector* src, unrx4::size_t size, float scale, float bias)
+    {
+        affine(toFloats(dst), toFloats(src), size * 3, scale, bias);
+    }
+
+    void clamp(float* dst, const float* src, unrx4::size_t size, float lower, float upper)
+    {
+        clampFloats(dst, src, size, lower, upper);
+#if UNRX4_NUMERIC_VERIFY
+        for(unrx4::size_t i = 0; i < size; ++i) {
+            float expected;
+            scalar::clamp(&expected, src + i, 1, lower, upper);
+            UNRX4_ASSERT(expected == dst[i]);
+        }
+#endif
+    }
+
+    void clamp(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper)
+    {
+        VectorRegisterInt l = VectorIntSet1(lower);
+        VectorRegisterInt u = VectorIntSet1(upper);
+        unrx4::size_t i = 0;
+        for(; (i + 4) <= size; i += 4) {
+            VectorIntStore(VectorIntMin(VectorIntMax(VectorIntLoad(src + i), l), u), dst + i);
+        }
+        scalar::clamp(dst + i, src + i, size - i, lower, upper);
+#if UNRX4_NUMERIC_VERIFY
+        for(unrx4::size_t j = 0; j < size; ++j) {
+            unrx4::s32 expected;
+            scalar::clamp(&expected, src + j, 1, lower, upper);
+            UNRX4_ASSERT(expected == dst[j]);
+        }
+#endif
+    }
+
+    void clamp(FVector* dst, const FVector* src, unrx4::size_t size, float lower, float upper)
+    {
+        clamp(toFloats(dst), toFloats(src), size * 3, lower, upper);
+    }
+
+    unrx4::size_t filter(float* dst, const float* src, unrx4::size_t size, float lower, float upper)
+    {
+        //Compare four at once, then compact by the mask
+        VectorRegister l = VectorSetFloat1(lower);
+        VectorRegister u = VectorSetFloat1(upper);
+        unrx4::size_t count = 0;
+        unrx4::size_t i = 0;
+        for(; (i + 4) <= size; i += 4) {
+            VectorRegister x = VectorLoad(src + i);
+            unrx4::s32 mask = VectorMaskBits(VectorBitwiseAnd(VectorCompareGE(x, l), VectorCompareLE(x, u)));
+            if(0 == mask) {
+                continue;
+            }
+            if(0xF == mask) {
+                VectorStore(x, dst + count);
+                count += 4;
+                continue;
+            }
+            for(unrx4::s32 j = 0; j < 4; ++j) {
+                dst[count] = src[i + j];
+                count += (mask >> j) & 0x01;
+            }
+        }
+        count += scalar::filter(dst + count, src + i, size - i, lower, upper);
+#if UNRX4_NUMERIC_VERIFY
+        unrx4::size_t expected = 0;
+        for(unrx4::size_t j = 0; j < size; ++j) {
+            if(lower <= src[j] && src[j] <= upper) {
+                UNRX4_ASSERT(expected < count && dst[expected] == src[j]);
+                ++expected;
+            }
+        }
+        UNRX4_ASSERT(expected == count);
+#endif
+        return count;
+    }
+
+    unrx4::size_t filter(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper)
+    {
+        VectorRegisterInt l = VectorIntSet1(lower);
+        VectorRegisterInt u = VectorIntSet1(upper);
+        unrx4::size_t count = 0;
+        unrx4::size_t i = 0;
+        for(; (i + 4) <= size; i += 4) {
+            VectorRegisterInt x = VectorIntLoad(src + i);
+            unrx4::s32 masks[4];
+            VectorIntStore(VectorIntAnd(VectorIntCompareGE(x, l), VectorIntCompareLE(x, u)), masks);
+            for(unrx4::s32 j = 0; j < 4; ++j) {
+                dst[count] = src[i + j];
+                count += masks[j] & 0x01;
+            }
+        }
+        count += scalar::filter(dst + count, src + i, size - i, lower, upper);
+#if UNRX4_NUMERIC_VERIFY
+        unrx4::size_t expected = 0;
+        for(unrx4::size_t j = 0; j < size; ++j) {
+            if(lower <= src[j] && src[j] <= upper) {
+                UNRX4_ASSERT(expected < count && dst[expected] == src[j]);
+                ++expected;
+            }
+        }
+        UNRX4_ASSERT(expected == count);
+#endif
+        return count;
+    }
+
+    namespace scalar
+    {
+        float sum(const float* src, unrx4::size_t size)
+        {
+            float result = 0.0f;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                result += src[i];
+            }
+            return result;
+        }
+
+        unrx4::s64 sum(const unrx4::s32* src, unrx4::size_t size)
+        {
+            unrx4::s64 result = 0;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                result += src[i];
+            }
+            return result;
+        }
+
+        FVector sum(const FVector* src, unrx4::size_t size)
+        {
+            FVector result = FVector::ZeroVector;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                result = result + src[i];
+            }
+            return result;
+        }
+
+        void minMax(float& outMin, float& outMax, const float* src, unrx4::size_t size)
+        {
+            UNRX4_ASSERT(0 < size);
+            outMin = outMax = src[0];
+            for(unrx4::size_t i = 1; i < size; ++i) {
+                outMin = FMath::Min(outMin, src[i]);
+                outMax = FMath::Max(outMax, src[i]);
+            }
+        }
+
+        void minMax(unrx4::s32& outMin, unrx4::s32& outMax, const unrx4::s32* src, unrx4::size_t size)
+        {
+            UNRX4_ASSERT(0 < size);
+            outMin = outMax = src[0];
+            for(unrx4::size_t i = 1; i < size; ++i) {
+                outMin = FMath::Min(outMin, src[i]);
+                outMax = FMath::Max(outMax, src[i]);
+            }
+        }
+
+        void minMax(FVector& outMin, FVector& outMax, const FVector* src, unrx4::size_t size)
+        {
+            UNRX4_ASSERT(0 < size);
+            outMin = outMax = src[0];
+            for(unrx4::size_t i = 1; i < size; ++i) {
+                outMin = outMin.ComponentMin(src[i]);
+                outMax = outMax.ComponentMax(src[i]);
+            }
+        }
+
+        void affine(float* dst, const float* src, unrx4::size_t size, float scale, float bias)
+        {
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[i] = src[i] * scale + bias;
+            }
+        }
+
+        void affine(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 scale, unrx4::s32 bias)
+        {
+            //Wrap around on overflow like vector registers
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[i] = static_cast<unrx4::s32>(static_cast<unrx4::u32>(src[i]) * static_cast<unrx4::u32>(scale) + static_cast<unrx4::u32>(bias));
+            }
+        }
+
+        void affine(FVector* dst, const FVector* src, unrx4::size_t size, float scale, float bias)
+        {
+            affine(toFloats(dst), toFloats(src), size * 3, scale, bias);
+        }
+
+        void clamp(float* dst, const float* src, unrx4::size_t size, float lower, float upper)
+        {
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[i] = FMath::Min(FMath::Max(src[i], lower), upper);
+            }
+        }
+
+        void clamp(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper)
+        {
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[i] = FMath::Min(FMath::Max(src[i], lower), upper);
+            }
+        }
+
+        void clamp(FVector* dst, const FVector* src, unrx4::size_t size, float lower, float upper)
+        {
+            clamp(toFloats(dst), toFloats(src), size * 3, lower, upper);
+        }
+
+        unrx4::size_t filter(float* dst, const float* src, unrx4::size_t size, float lower, float upper)
+        {
+            unrx4::size_t count = 0;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[count] = src[i];
+                count += (lower <= src[i] && src[i] <= upper) ? 1 : 0;
+            }
+            return count;
+        }
+
+        unrx4::size_t filter(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper)
+        {
+            unrx4::size_t count = 0;
+            for(unrx4::size_t i = 0; i < size; ++i) {
+                dst[count] = src[i];
+                count += (lower <= src[i] && src[i] <= upper) ? 1 : 0;
+            }
+            return count;
+        }
+    } // namespace scalar
+
+#if !UE_BUILD_SHIPPING
+    namespace
+    {
+        /**
+         * @brief Compare kernels with scalar references for one size
+         * @return The number of kernels which disagree
+         */
+        unrx4::u32 verifySize(const float* floats, const unrx4::s32* ints, const FVector* vectors, unrx4::size_t size)
+        {
+            unrx4::u32 failures = 0;
+            auto expectEqual = [&failures, size](bool equal, const TCHAR* name) {
+                if(!equal) {
+                    UE_LOG(LogTemp, Error, TEXT("unrx4::numeric::%s differs from the scalar reference at size %llu"), name, static_cast<unrx4::u64>(size));
+                    ++failures;
+                }
+            };
+            float m = magnitude(floats, size);
+            expectEqual(nearlyEqual(sum(floats, size), scalar::sum(floats, size), m), TEXT("sum(float)"));
+            expectEqual(sum(ints, size) == scalar::sum(ints, size), TEXT("sum(int32)"));
+            {
+                FVector result = sum(vectors, size);
+                FVector expected = scalar::sum(vectors, size);
+                float vm = magnitude(toFloats(vectors), size * 3);
+                expectEqual(nearlyEqual(result.X, expected.X, vm) && nearlyEqual(result.Y, expected.Y, vm) && nearlyEqual(result.Z, expected.Z, vm), TEXT("sum(FVector)"));
+            }
+            {
+                float minValue, maxValue, expectedMin, expectedMax;
+                minMax(minValue, maxValue, floats, size);
+                scalar::minMax(expectedMin, expectedMax, floats, size);
+                expectEqual(minValue == expectedMin && maxValue == expectedMax, TEXT("minMax(float)"));
+            }
+            {
+                unrx4::s32 minValue, maxValue, expectedMin, expectedMax;
+                minMax(minValue, maxValue, ints, size);
+                scalar::minMax(expectedMin, expectedMax, ints, size);
+                expectEqual(minValue == expectedMin && maxValue == expectedMax, TEXT("minMax(int32)"));
+            }
+            {
+                FVector minValue, maxValue, expectedMin, expectedMax;
+                minMax(minValue, maxValue, vectors, size);
+                scalar::minMax(expectedMin, expectedMax, vectors, size);
+                expectEqual(minValue.Equals(expectedMin, 0.0f) && maxValue.Equals(expectedMax, 0.0f), TEXT("minMax(FVector)"));
+            }
+
+            TArray<float> floats0;
+            TArray<float> floats1;
+            floats0.SetNumUninitialized(static_cast<int32>(size));
+            floats1.SetNumUninitialized(static_cast<int32>(size));
+            TArray<unrx4::s32> ints0;
+            TArray<unrx4::s32> ints1;
+            ints0.SetNumUninitialized(static_cast<int32>(size));
+            ints1.SetNumUninitialized(static_cast<int32>(size));
+            {
+                affine(floats0.GetData(), floats, size, 1.5f, -0.25f);
+                scalar::affine(floats1.GetData(), floats, size, 1.5f, -0.25f);
+                bool equal = true;
+                for(unrx4::size_t i = 0; i < size; ++i) {
+                    equal = equal && nearlyEqual(floats0[i], floats1[i], floats[i] < 0.0f ? -floats[i] : floats[i]);
+                }
+                expectEqual(equal, TEXT("affine(float)"));
+            }
+            {
+                affine(ints0.GetData(), ints, size, 3, -7);
+                scalar::affine(ints1.GetData(), ints, size, 3, -7);
+                expectEqual(0 == FMemory::Memcmp(ints0.GetData(), ints1.GetData(), sizeof(unrx4::s32) * size), TEXT("affine(int32)"));
+            }
+            {
+                clamp(floats0.GetData(), floats, size, -0.5f, 0.5f);
+                scalar::clamp(floats1.GetData(), floats, size, -0.5f, 0.5f);
+                expectEqual(0 == FMemory::Memcmp(floats0.GetData(), floats1.GetData(), sizeof(float) * size), TEXT("clamp(float)"));
+            }
+            {
+                clamp(ints0.GetData(), ints, size, -1000, 1000);
+                scalar::clamp(ints1.GetData(), ints, size, -1000, 1000);
+                expectEqual(0 == FMemory::Memcmp(ints0.GetData(), ints1.GetData(), sizeof(unrx4::s32) * size), TEXT("clamp(int32)"));
+            }
+            {
+                unrx4::size_t count = filter(floats0.GetData(), floats, size, -0.5f, 0.5f);
+                unrx4::size_t expected = scalar::filter(floats1.GetData(), floats, size, -0.5f, 0.5f);
+                expectEqual(count == expected && 0 == FMemory::Memcmp(floats0.GetData(), floats1.GetData(), sizeof(float) * count), TEXT("filter(float)"));
+            }
+            {
+                unrx4::size_t count = filter(ints0.GetData(), ints, size, -1000, 1000);
+                unrx4::size_t expected = scalar::filter(ints1.GetData(), ints, size, -1000, 1000);
+                expectEqual(count == expected && 0 == FMemory::Memcmp(ints0.GetData(), ints1.GetData(), sizeof(unrx4::s32) * count), TEXT("filter(int32)"));
+            }
+            return failures;
+        }
+    } // namespace
+
+    unrx4::u32 verify(unrx4::size_t size, unrx4::s32 seed)
+    {
+        size = 0 < size ? size : 1;
+        FRandomStream random(seed);
+        TArray<float> floats;
+        TArray<unrx4::s32> ints;
+        TArray<FVector> vectors;
+        floats.SetNumUninitialized(static_cast<int32>(size));
+        ints.SetNumUninitialized(static_cast<int32>(size));
+        vectors.SetNumUninitialized(static_cast<int32>(size));
+        for(unrx4::size_t i = 0; i < size; ++i) {
+            floats[i] = random.FRandRange(-1.0f, 1.0f);
+            ints[i] = random.RandRange(-2000, 2000);
+            vectors[i] = FVector(random.FRandRange(-1.0f, 1.0f), random.FRandRange(-1.0f, 1.0f), random.FRandRange(-1.0f, 1.0f));
+        }
+        //Every size up to a few registers covers the remainders of each kernel
+        unrx4::u32 failures = 0;
+        for(unrx4::size_t n = 1; n <= FMath::Min<unrx4::size_t>(size, 32); ++n) {
+            failures += verifySize(floats.GetData(), ints.GetData(), vectors.GetData(), n);
+        }
+        if(32 < size) {
+            failures += verifySize(floats.GetData(), ints.GetData(), vectors.GetData(), size);
+        }
+        return failures;
+    }
+
+    namespace
+    {
+        FAutoConsoleCommand unrx4_internal_verifyNumericCommand_(
+            TEXT("unrx4.Verify.Numeric"),
+            TEXT("Compare the vectorized numeric kernels with their scalar references. unrx4.Verify.Numeric [size=4099] [seed=1]"),
+            FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+                unrx4::s32 size = 4099;
+                unrx4::s32 seed = 1;
+                if(0 < args.Num()) {
+                    size = FMath::Max(FCString::Atoi(*args[0]), 1);
+                }
+                if(1 < args.Num()) {
+                    seed = FCString::Atoi(*args[1]);
+                }
+                unrx4::u32 failures = verify(static_cast<unrx4::size_t>(size), seed);
+                UE_LOG(LogTemp, Log, TEXT("unrx4.Verify.Numeric size:%d seed:%d failures:%u"), size, seed, failures);
+            }));
+    } // namespace
+#endif
+} // namespace numeric
+} // namespace unrx4
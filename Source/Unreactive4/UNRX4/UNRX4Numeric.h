@@ -0,0 +1,556 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Numeric.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Operator.h"
+
+#ifndef UNRX4_NUMERIC_VERIFY
+#    if UE_BUILD_DEBUG
+#        define UNRX4_NUMERIC_VERIFY 1
+#    else
+#        define UNRX4_NUMERIC_VERIFY 0
+#    endif
+#endif
+
+namespace unrx4
+{
+namespace numeric
+{
+    //--- Vectorized kernels
+    //--- Loads and stores are unaligned, the default allocator gives only 8 bytes alignment.
+    //--- FVector is handled as a flat array of floats.
+    UNREACTIVE4_API float sum(const float* src, unrx4::size_t size);
+    UNREACTIVE4_API unrx4::s64 sum(const unrx4::s32* src, unrx4::size_t size);
+    UNREACTIVE4_API FVector sum(const FVector* src, unrx4::size_t size);
+
+    UNREACTIVE4_API void minMax(float& outMin, float& outMax, const float* src, unrx4::size_t size);
+    UNREACTIVE4_API void minMax(unrx4::s32& outMin, unrx4::s32& outMax, const unrx4::s32* src, unrx4::size_t size);
+    UNREACTIVE4_API void minMax(FVector& outMin, FVector& outMax, const FVector* src, unrx4::size_t size);
+
+    /**
+     * @brief dst[i] = src[i] * scale + bias
+     */
+    UNREACTIVE4_API void affine(float* dst, const float* src, unrx4::size_t size, float scale, float bias);
+    UNREACTIVE4_API void affine(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 scale, unrx4::s32 bias);
+    UNREACTIVE4_API void affine(FVector* dst, const FVector* src, unrx4::size_t size, float scale, float bias);
+
+    UNREACTIVE4_API void clamp(float* dst, const float* src, unrx4::size_t size, float lower, float upper);
+    UNREACTIVE4_API void clamp(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper);
+    UNREACTIVE4_API void clamp(FVector* dst, const FVector* src, unrx4::size_t size, float lower, float upper);
+
+    /**
+     * @brief Copy values in [lower, upper] to dst
+     * @return The number of copied values
+     */
+    UNREACTIVE4_API unrx4::size_t filter(float* dst, const float* src, unrx4::size_t size, float lower, float upper);
+    UNREACTIVE4_API unrx4::size_t filter(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper);
+
+#if !UE_BUILD_SHIPPING
+    /**
+     * @brief Compare every kernel with its scalar reference on random values, in any build configuration
+     * @return The number of kernels which disagree
+     */
+    UNREACTIVE4_API unrx4::u32 verify(unrx4::size_t size, unrx4::s32 seed);
+#endif
+
+    namespace scalar
+    {
+        //--- Scalar references of kernels
+        UNREACTIVE4_API float sum(const float* src, unrx4::size_t size);
+        UNREACTIVE4_API unrx4::s64 sum(const unrx4::s32* src, unrx4::size_t size);
+        UNREACTIVE4_API FVector sum(const FVector* src, unrx4::size_t size);
+
+        UNREACTIVE4_API void minMax(float& outMin, float& outMax, const float* src, unrx4::size_t size);
+        UNREACTIVE4_API void minMax(unrx4::s32& outMin, unrx4::s32& outMax, const unrx4::s32* src, unrx4::size_t size);
+        UNREACTIVE4_API void minMax(FVector& outMin, FVector& outMax, const FVector* src, unrx4::size_t size);
+
+        UNREACTIVE4_API void affine(float* dst, const float* src, unrx4::size_t size, float scale, float bias);
+        UNREACTIVE4_API void affine(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 scale, unrx4::s32 bias);
+        UNREACTIVE4_API void affine(FVector* dst, const FVector* src, unrx4::size_t size, float scale, float bias);
+
+        UNREACTIVE4_API void clamp(float* dst, const float* src, unrx4::size_t size, float lower, float upper);
+        UNREACTIVE4_API void clamp(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper);
+        UNREACTIVE4_API void clamp(FVector* dst, const FVector* src, unrx4::size_t size, float lower, float upper);
+
+        UNREACTIVE4_API unrx4::size_t filter(float* dst, const float* src, unrx4::size_t size, float lower, float upper);
+        UNREACTIVE4_API unrx4::size_t filter(unrx4::s32* dst, const unrx4::s32* src, unrx4::size_t size, unrx4::s32 lower, unrx4::s32 upper);
+    } // namespace scalar
+} // namespace numeric
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Types of numeric operators for each element type
+ */
+template<class T>
+struct UNRX4NumericTraits;
+
+template<>
+struct UNRX4NumericTraits<float>
+{
+    using scalar_type = float;
+    using accumulate_type = float;
+
+    static accumulate_type zero() { return 0.0f; }
+    static accumulate_type add(accumulate_type x0, accumulate_type x1) { return x0 + x1; }
+    static accumulate_type subtract(accumulate_type x0, accumulate_type x1) { return x0 - x1; }
+    static accumulate_type divide(accumulate_type x, unrx4::size_t count) { return x / static_cast<float>(count); }
+    static float minimum(float x0, float x1) { return x0 < x1 ? x0 : x1; }
+    static float maximum(float x0, float x1) { return x1 < x0 ? x0 : x1; }
+};
+
+template<>
+struct UNRX4NumericTraits<unrx4::s32>
+{
+    using scalar_type = unrx4::s32;
+    using accumulate_type = unrx4::s64;
+
+    static accumulate_type zero() { return 0; }
+    static accumulate_type add(accumulate_type x0, accumulate_type x1) { return x0 + x1; }
+    static accumulate_type subtract(accumulate_type x0, accumulate_type x1) { return x0 - x1; }
+    static accumulate_type divide(accumulate_type x, unrx4::size_t count) { return x / static_cast<unrx4::s64>(count); }
+    static unrx4::s32 minimum(unrx4::s32 x0, unrx4::s32 x1) { return x0 < x1 ? x0 : x1; }
+    static unrx4::s32 maximum(unrx4::s32 x0, unrx4::s32 x1) { return x1 < x0 ? x0 : x1; }
+};
+
+template<>
+struct UNRX4NumericTraits<FVector>
+{
+    using scalar_type = float;
+    using accumulate_type = FVector;
+
+    static accumulate_type zero() { return FVector::ZeroVector; }
+    static accumulate_type add(const accumulate_type& x0, const accumulate_type& x1) { return x0 + x1; }
+    static accumulate_type subtract(const accumulate_type& x0, const accumulate_type& x1) { return x0 - x1; }
+    static accumulate_type divide(const accumulate_type& x, unrx4::size_t count) { return x / static_cast<float>(count); }
+    static FVector minimum(const FVector& x0, const FVector& x1) { return x0.ComponentMin(x1); }
+    static FVector maximum(const FVector& x0, const FVector& x1) { return x0.ComponentMax(x1); }
+};
+
+//-------------------
+/**
+ * @brief Collect values into batches
+ */
+template<class T>
+class UNRX4NumericBatcher: public UNRX4Operator<UNRX4NumericBatcher<T>, T, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4NumericBatcher<T>, T, UNRX4Batch<T>>;
+    friend base_type;
+
+public:
+    UNRX4NumericBatcher(UNRX4IObservable<T>* source, unrx4::size_t batchSize);
+
+    /**
+     * @brief Emit buffered values as a batch
+     */
+    void flush();
+
+private:
+    void onNext(const T& value);
+    void onCompleted();
+
+    unrx4::size_t batchSize_;
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4NumericBatcher<T>::UNRX4NumericBatcher(UNRX4IObservable<T>* source, unrx4::size_t batchSize)
+    : base_type(source)
+    , batchSize_(0 < batchSize ? batchSize : 1)
+    , values_(batchSize_)
+{
+}
+
+template<class T>
+void UNRX4NumericBatcher<T>::flush()
+{
+    if(values_.size() <= 0) {
+        return;
+    }
+    this->emit(UNRX4Batch<T>(values_.cbegin(), static_cast<int32>(values_.size())));
+    values_.clear();
+}
+
+template<class T>
+void UNRX4NumericBatcher<T>::onNext(const T& value)
+{
+    values_.push_back(value);
+    if(batchSize_ <= values_.size()) {
+        flush();
+    }
+}
+
+template<class T>
+void UNRX4NumericBatcher<T>::onCompleted()
+{
+    flush();
+    this->completed();
+}
+
+//-------------------
+/**
+ * @brief Apply x * scale + bias to batches
+ */
+template<class T>
+class UNRX4NumericAffine: public UNRX4Operator<UNRX4NumericAffine<T>, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4NumericAffine<T>, UNRX4Batch<T>>;
+    using scalar_type = typename UNRX4NumericTraits<T>::scalar_type;
+    friend base_type;
+
+public:
+    UNRX4NumericAffine(UNRX4IObservable<UNRX4Batch<T>>* source, scalar_type scale, scalar_type bias);
+
+private:
+    void onNext(const UNRX4Batch<T>& values);
+
+    scalar_type scale_;
+    scalar_type bias_;
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4NumericAffine<T>::UNRX4NumericAffine(UNRX4IObservable<UNRX4Batch<T>>* source, scalar_type scale, scalar_type bias)
+    : base_type(source)
+    , scale_(scale)
+    , bias_(bias)
+{
+}
+
+template<class T>
+void UNRX4NumericAffine<T>::onNext(const UNRX4Batch<T>& values)
+{
+    unrx4::size_t size = static_cast<unrx4::size_t>(values.Num());
+    values_.resize(size);
+    unrx4::numeric::affine(values_.begin(), values.GetData(), size, scale_, bias_);
+    this->emit(UNRX4Batch<T>(values_.cbegin(), values.Num()));
+}
+
+//-------------------
+/**
+ * @brief Apply a function to each value of batches
+ *
+ * The function is inlined into a plain loop, which compilers can vectorize for simple functions.
+ * Only affine and clamp are written with vector registers, use them for those.
+ */
+template<class T, class F>
+class UNRX4NumericMap: public UNRX4Operator<UNRX4NumericMap<T, F>, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4NumericMap<T, F>, UNRX4Batch<T>>;
+    friend base_type;
+
+public:
+    UNRX4NumericMap(UNRX4IObservable<UNRX4Batch<T>>* source, F f);
+
+private:
+    void onNext(const UNRX4Batch<T>& values);
+
+    F f_;
+    UNRX4Array<T> values_;
+};
+
+template<class T, class F>
+UNRX4NumericMap<T, F>::UNRX4NumericMap(UNRX4IObservable<UNRX4Batch<T>>* source, F f)
+    : base_type(source)
+    , f_(f)
+{
+}
+
+template<class T, class F>
+void UNRX4NumericMap<T, F>::onNext(const UNRX4Batch<T>& values)
+{
+    unrx4::size_t size = static_cast<unrx4::size_t>(values.Num());
+    values_.resize(size);
+    const T* src = values.GetData();
+    T* dst = values_.begin();
+    for(unrx4::size_t i = 0; i < size; ++i) {
+        dst[i] = f_(src[i]);
+    }
+    this->emit(UNRX4Batch<T>(values_.cbegin(), values.Num()));
+}
+
+//-------------------
+/**
+ * @brief Clamp values of batches into [lower, upper]
+ */
+template<class T>
+class UNRX4NumericClamp: public UNRX4Operator<UNRX4NumericClamp<T>, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4NumericClamp<T>, UNRX4Batch<T>>;
+    using scalar_type = typename UNRX4NumericTraits<T>::scalar_type;
+    friend base_type;
+
+public:
+    UNRX4NumericClamp(UNRX4IObservable<UNRX4Batch<T>>* source, scalar_type lower, scalar_type upper);
+
+private:
+    void onNext(const UNRX4Batch<T>& values);
+
+    scalar_type lower_;
+    scalar_type upper_;
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4NumericClamp<T>::UNRX4NumericClamp(UNRX4IObservable<UNRX4Batch<T>>* source, scalar_type lower, scalar_type upper)
+    : base_type(source)
+    , lower_(lower)
+    , upper_(upper)
+{
+    UNRX4_ASSERT(lower_ <= upper_);
+}
+
+template<class T>
+void UNRX4NumericClamp<T>::onNext(const UNRX4Batch<T>& values)
+{
+    unrx4::size_t size = static_cast<unrx4::size_t>(values.Num());
+    values_.resize(size);
+    unrx4::numeric::clamp(values_.begin(), values.GetData(), size, lower_, upper_);
+    this->emit(UNRX4Batch<T>(values_.cbegin(), values.Num()));
+}
+
+//-------------------
+/**
+ * @brief Pass values of batches in [lower, upper], empty batches are not emitted
+ */
+template<class T>
+class UNRX4NumericFilter: public UNRX4Operator<UNRX4NumericFilter<T>, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4NumericFilter<T>, UNRX4Batch<T>>;
+    friend base_type;
+
+public:
+    UNRX4NumericFilter(UNRX4IObservable<UNRX4Batch<T>>* source, T lower, T upper);
+
+private:
+    void onNext(const UNRX4Batch<T>& values);
+
+    T lower_;
+    T upper_;
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4NumericFilter<T>::UNRX4NumericFilter(UNRX4IObservable<UNRX4Batch<T>>* source, T lower, T upper)
+    : base_type(source)
+    , lower_(lower)
+    , upper_(upper)
+{
+}
+
+template<class T>
+void UNRX4NumericFilter<T>::onNext(const UNRX4Batch<T>& values)
+{
+    values_.resize(static_cast<unrx4::size_t>(values.Num()));
+    unrx4::size_t size = unrx4::numeric::filter(values_.begin(), values.GetData(), values_.size(), lower_, upper_);
+    if(size <= 0) {
+        return;
+    }
+    this->emit(UNRX4Batch<T>(values_.cbegin(), static_cast<int32>(size)));
+}
+
+//-------------------
+enum class UNRX4NumericReduction
+{
+    Sum,
+    Min,
+    Max,
+    Average,
+};
+
+/**
+ * @brief Reduce batches, then emit the result on completed
+ *
+ * Nothing is emitted for Min, Max and Average of an empty stream.
+ */
+template<class T>
+class UNRX4NumericReduce: public UNRX4Operator<UNRX4NumericReduce<T>, UNRX4Batch<T>, typename UNRX4NumericTraits<T>::accumulate_type>
+{
+    using traits_type = UNRX4NumericTraits<T>;
+    using accumulate_type = typename traits_type::accumulate_type;
+    using base_type = UNRX4Operator<UNRX4NumericReduce<T>, UNRX4Batch<T>, accumulate_type>;
+    friend base_type;
+
+public:
+    UNRX4NumericReduce(UNRX4IObservable<UNRX4Batch<T>>* source, UNRX4NumericReduction reduction);
+
+private:
+    void onNext(const UNRX4Batch<T>& values);
+    void onCompleted();
+
+    UNRX4NumericReduction reduction_;
+    unrx4::size_t count_;
+    accumulate_type sum_;
+    T min_;
+    T max_;
+};
+
+template<class T>
+UNRX4NumericReduce<T>::UNRX4NumericReduce(UNRX4IObservable<UNRX4Batch<T>>* source, UNRX4NumericReduction reduction)
+    : base_type(source)
+    , reduction_(reduction)
+    , count_(0)
+    , sum_(traits_type::zero())
+    , min_{}
+    , max_{}
+{
+}
+
+template<class T>
+void UNRX4NumericReduce<T>::onNext(const UNRX4Batch<T>& values)
+{
+    unrx4::size_t size = static_cast<unrx4::size_t>(values.Num());
+    if(size <= 0) {
+        return;
+    }
+    switch(reduction_) {
+    case UNRX4NumericReduction::Sum:
+    case UNRX4NumericReduction::Average:
+        sum_ = traits_type::add(sum_, unrx4::numeric::sum(values.GetData(), size));
+        break;
+    case UNRX4NumericReduction::Min:
+    case UNRX4NumericReduction::Max: {
+        T minValue;
+        T maxValue;
+        unrx4::numeric::minMax(minValue, maxValue, values.GetData(), size);
+        min_ = 0 < count_ ? traits_type::minimum(min_, minValue) : minValue;
+        max_ = 0 < count_ ? traits_type::maximum(max_, maxValue) : maxValue;
+    } break;
+    }
+    count_ += size;
+}
+
+template<class T>
+void UNRX4NumericReduce<T>::onCompleted()
+{
+    switch(reduction_) {
+    case UNRX4NumericReduction::Sum:
+        this->emit(sum_);
+        break;
+    case UNRX4NumericReduction::Min:
+        if(0 < count_) {
+            this->emit(static_cast<accumulate_type>(min_));
+        }
+        break;
+    case UNRX4NumericReduction::Max:
+        if(0 < count_) {
+            this->emit(static_cast<accumulate_type>(max_));
+        }
+        break;
+    case UNRX4NumericReduction::Average:
+        if(0 < count_) {
+            this->emit(traits_type::divide(sum_, count_));
+        }
+        break;
+    }
+    this->completed();
+}
+
+//-------------------
+/**
+ * @brief Factories of numeric operators
+ *
+ * Stages are owned by the caller, and subscribe their source while they have observers.
+ */
+class UNRX4Numeric
+{
+public:
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericBatcher<T>> batch(UNRX4IObservable<T>* source, unrx4::size_t batchSize);
+
+    /**
+     * @brief Map values with a function of T(const T&)
+     */
+    template<class T, class F>
+    static unrx4_unique_ptr<UNRX4NumericMap<T, F>> map(UNRX4IObservable<UNRX4Batch<T>>* source, F f);
+
+    template<class T, class S = typename UNRX4NumericTraits<T>::scalar_type>
+    static unrx4_unique_ptr<UNRX4NumericAffine<T>> affine(UNRX4IObservable<UNRX4Batch<T>>* source, S scale, S bias);
+
+    template<class T, class S = typename UNRX4NumericTraits<T>::scalar_type>
+    static unrx4_unique_ptr<UNRX4NumericClamp<T>> clamp(UNRX4IObservable<UNRX4Batch<T>>* source, S lower, S upper);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericFilter<T>> filter(UNRX4IObservable<UNRX4Batch<T>>* source, T lower, T upper);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericReduce<T>> sum(UNRX4IObservable<UNRX4Batch<T>>* source);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericReduce<T>> min(UNRX4IObservable<UNRX4Batch<T>>* source);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericReduce<T>> max(UNRX4IObservable<UNRX4Batch<T>>* source);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4NumericReduce<T>> average(UNRX4IObservable<UNRX4Batch<T>>* source);
+};
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericBatcher<T>> UNRX4Numeric::batch(UNRX4IObservable<T>* source, unrx4::size_t batchSize)
+{
+    return unrx4_make_unique<UNRX4NumericBatcher<T>>(source, batchSize);
+}
+
+template<class T, class F>
+unrx4_unique_ptr<UNRX4NumericMap<T, F>> UNRX4Numeric::map(UNRX4IObservable<UNRX4Batch<T>>* source, F f)
+{
+    return unrx4_make_unique<UNRX4NumericMap<T, F>>(source, f);
+}
+
+template<class T, class S>
+unrx4_unique_ptr<UNRX4NumericAffine<T>> UNRX4Numeric::affine(UNRX4IObservable<UNRX4Batch<T>>* source, S scale, S bias)
+{
+    return unrx4_make_unique<UNRX4NumericAffine<T>>(source, scale, bias);
+}
+
+template<class T, class S>
+unrx4_unique_ptr<UNRX4NumericClamp<T>> UNRX4Numeric::clamp(UNRX4IObservable<UNRX4Batch<T>>* source, S lower, S upper)
+{
+    return unrx4_make_unique<UNRX4NumericClamp<T>>(source, lower, upper);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericFilter<T>> UNRX4Numeric::filter(UNRX4IObservable<UNRX4Batch<T>>* source, T lower, T upper)
+{
+    return unrx4_make_unique<UNRX4NumericFilter<T>>(source, lower, upper);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericReduce<T>> UNRX4Numeric::sum(UNRX4IObservable<UNRX4Batch<T>>* source)
+{
+    return unrx4_make_unique<UNRX4NumericReduce<T>>(source, UNRX4NumericReduction::Sum);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericReduce<T>> UNRX4Numeric::min(UNRX4IObservable<UNRX4Batch<T>>* source)
+{
+    return unrx4_make_unique<UNRX4NumericReduce<T>>(source, UNRX4NumericReduction::Min);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericReduce<T>> UNRX4Numeric::max(UNRX4IObservable<UNRX4Batch<T>>* source)
+{
+    return unrx4_make_unique<UNRX4NumericReduce<T>>(source, UNRX4NumericReduction::Max);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4NumericReduce<T>> UNRX4Numeric::average(UNRX4IObservable<UNRX4Batch<T>>* source)
+{
+    return unrx4_make_unique<UNRX4NumericReduce<T>>(source, UNRX4NumericReduction::Average);
+}
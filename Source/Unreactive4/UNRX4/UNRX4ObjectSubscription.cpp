@@ -0,0 +1,166 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ObjectSubscription.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4ObjectSubscription.h"
+#include <UObject/Object.h>
+#include <algorithm>
+
+UNRX4ObjectSubscriptions::UNRX4ObjectSubscriptions()
+{
+}
+
+UNRX4ObjectSubscriptions::~UNRX4ObjectSubscriptions()
+{
+    clear();
+}
+
+void UNRX4ObjectSubscriptions::clear()
+{
+    //Observables might have been destroyed already, so only owned observers are released
+    for(Entry& entry: entries_) {
+        if(nullptr != entry.destroy_) {
+            entry.destroy_(entry.observer_);
+        }
+    }
+    entries_.clear();
+    entries_.shrink_to_fit();
+    pruned_.clear();
+    pruned_.shrink_to_fit();
+    prunedObservers_.clear();
+    prunedObservers_.shrink_to_fit();
+}
+
+void UNRX4ObjectSubscriptions::unsubscribe(const void* observer)
+{
+    unrx4::size_t size = 0;
+    for(unrx4::size_t i = 0; i < entries_.size(); ++i) {
+        if(observer == entries_[i].observer_) {
+            release(entries_[i]);
+            continue;
+        }
+        if(size != i) {
+            entries_[size] = std::move(entries_[i]);
+        }
+        ++size;
+    }
+    compact(size);
+}
+
+void UNRX4ObjectSubscriptions::forget(const void* observable)
+{
+    unrx4::size_t size = 0;
+    for(unrx4::size_t i = 0; i < entries_.size(); ++i) {
+        Entry& entry = entries_[i];
+        if(observable == entry.observable_) {
+            if(nullptr != entry.destroy_) {
+                entry.destroy_(entry.observer_);
+            }
+            continue;
+        }
+        if(size != i) {
+            entries_[size] = std::move(entry);
+        }
+        ++size;
+    }
+    compact(size);
+}
+
+void UNRX4ObjectSubscriptions::prune()
+{
+    unrx4::size_t size = 0;
+    for(unrx4::size_t i = 0; i < entries_.size(); ++i) {
+        if(!entries_[i].owner_.IsValid()) {
+            //Reserve once for the rest, instead of growing while thousands of actors are destroyed
+            if(pruned_.size() <= 0) {
+                pruned_.reserve(entries_.size() - i);
+            }
+            pruned_.push_back(std::move(entries_[i]));
+            continue;
+        }
+        if(size != i) {
+            entries_[size] = std::move(entries_[i]);
+        }
+        ++size;
+    }
+    compact(size);
+    if(pruned_.size() <= 0) {
+        return;
+    }
+
+    //Group dead entries by observable, then unsubscribe each group at once
+    std::sort(pruned_.begin(), pruned_.end(), [](const Entry& x0, const Entry& x1) {
+        return x0.observable_ < x1.observable_;
+    });
+    prunedObservers_.reserve(pruned_.size());
+    for(unrx4::size_t begin = 0; begin < pruned_.size();) {
+        const Entry& first = pruned_[begin];
+        unrx4::size_t end = begin;
+        prunedObservers_.clear();
+        while(end < pruned_.size() && first.observable_ == pruned_[end].observable_ && first.unsubscribe_ == pruned_[end].unsubscribe_) {
+            prunedObservers_.push_back(pruned_[end].observer_);
+            ++end;
+        }
+        first.unsubscribe_(first.observable_, prunedObservers_.cbegin(), prunedObservers_.size());
+        for(unrx4::size_t i = begin; i < end; ++i) {
+            if(nullptr != pruned_[i].destroy_) {
+                pruned_[i].destroy_(pruned_[i].observer_);
+            }
+        }
+        begin = end;
+    }
+    pruned_.clear();
+    pruned_.shrink_to_fit();
+    prunedObservers_.clear();
+    prunedObservers_.shrink_to_fit();
+}
+
+unrx4::size_t UNRX4ObjectSubscriptions::size() const
+{
+    return entries_.size();
+}
+
+void UNRX4ObjectSubscriptions::add(const UObject* owner, void* observable, void* observer, unsubscribe_func unsubscribe, destroy_func destroy)
+{
+    UNRX4_ASSERT(nullptr != owner);
+    Entry entry;
+    entry.owner_ = owner;
+    entry.observable_ = observable;
+    entry.observer_ = observer;
+    entry.unsubscribe_ = unsubscribe;
+    entry.destroy_ = destroy;
+    entries_.push_back(entry);
+}
+
+void UNRX4ObjectSubscriptions::release(Entry& entry)
+{
+    entry.unsubscribe_(entry.observable_, &entry.observer_, 1);
+    if(nullptr != entry.destroy_) {
+        entry.destroy_(entry.observer_);
+    }
+}
+
+void UNRX4ObjectSubscriptions::compact(unrx4::size_t size)
+{
+    while(size < entries_.size()) {
+        entries_.pop_back();
+    }
+    //Give memory back after mass destruction of actors
+    if(entries_.size() < (entries_.capacity() >> 2)) {
+        entries_.shrink_to_fit();
+    }
+}
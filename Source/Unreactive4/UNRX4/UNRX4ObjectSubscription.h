@@ -0,0 +1,140 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ObjectSubscription.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <UObject/WeakObjectPtrTemplates.h>
+#include "UNRX4Container.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+
+class UObject;
+
+//-------------------
+/**
+ * @brief Subscriptions tied to the lifetime of UObjects
+ *
+ * Observables keep raw observer pointers and never check owners while dispatching.
+ * Instead, subscriptions whose owners have become unreachable are pruned at once in every GC, after reachability analysis and before the owners are destroyed.
+ */
+UNREACTIVE4_API
+class UNRX4ObjectSubscriptions
+{
+public:
+    UNRX4ObjectSubscriptions();
+    ~UNRX4ObjectSubscriptions();
+
+    /**
+     * @brief Subscribe an observer, which will be unsubscribed after the owner has been collected
+     */
+    template<class... Args>
+    void subscribe(const UObject* owner, UNRX4IObservable<Args...>* observable, UNRX4IObserver<Args...>* observer);
+
+    /**
+     * @brief Subscribe an observer, which will be unsubscribed and destroyed after the owner has been collected
+     */
+    template<class... Args>
+    void subscribe(const UObject* owner, UNRX4IObservable<Args...>* observable, unrx4_unique_ptr<UNRX4IObserver<Args...>>&& observer);
+
+    /**
+     * @brief Unsubscribe an observer now
+     */
+    void unsubscribe(const void* observer);
+
+    /**
+     * @brief Drop all subscriptions to an observable without unsubscribing, call this before destroying the observable
+     */
+    void forget(const void* observable);
+
+    /**
+     * @brief Unsubscribe all observers whose owners are no longer valid
+     *
+     * Observers are unsubscribed in bulk for each observable, then mass destruction of actors stays linear.
+     */
+    void prune();
+
+    /**
+     * @brief Drop all subscriptions without unsubscribing, and destroy owned observers
+     */
+    void clear();
+
+    unrx4::size_t size() const;
+
+private:
+    UNRX4ObjectSubscriptions(const UNRX4ObjectSubscriptions&) = delete;
+    UNRX4ObjectSubscriptions& operator=(const UNRX4ObjectSubscriptions&) = delete;
+
+    using unsubscribe_func = void (*)(void* observable, void* const* observers, unrx4::size_t count);
+    using destroy_func = void (*)(void* observer);
+
+    struct Entry
+    {
+        TWeakObjectPtr<const UObject> owner_;
+        void* observable_;
+        void* observer_;
+        unsubscribe_func unsubscribe_;
+        destroy_func destroy_;
+    };
+
+    template<class... Args>
+    static void unsubscribeObservers(void* observable, void* const* observers, unrx4::size_t count)
+    {
+        UNRX4IObservable<Args...>* target = static_cast<UNRX4IObservable<Args...>*>(observable);
+        if(count <= 1) {
+            target->unsubscribe(static_cast<UNRX4IObserver<Args...>*>(observers[0]));
+            return;
+        }
+        UNRX4Array<UNRX4IObserver<Args...>*> typed(count);
+        for(unrx4::size_t i = 0; i < count; ++i) {
+            typed.push_back(static_cast<UNRX4IObserver<Args...>*>(observers[i]));
+        }
+        target->unsubscribeMany(typed.cbegin(), count);
+    }
+
+    template<class... Args>
+    static void destroyObserver(void* observer)
+    {
+        unrx4_destruct(static_cast<UNRX4IObserver<Args...>*>(observer));
+    }
+
+    void add(const UObject* owner, void* observable, void* observer, unsubscribe_func unsubscribe, destroy_func destroy);
+    void release(Entry& entry);
+    void compact(unrx4::size_t size);
+
+    UNRX4Array<Entry> entries_;
+    UNRX4Array<Entry> pruned_;
+    UNRX4Array<void*> prunedObservers_;
+};
+
+template<class... Args>
+void UNRX4ObjectSubscriptions::subscribe(const UObject* owner, UNRX4IObservable<Args...>* observable, UNRX4IObserver<Args...>* observer)
+{
+    UNRX4_ASSERT(nullptr != observable);
+    UNRX4_ASSERT(nullptr != observer);
+    observable->subscribe(observer);
+    add(owner, observable, observer, &unsubscribeObservers<Args...>, nullptr);
+}
+
+template<class... Args>
+void UNRX4ObjectSubscriptions::subscribe(const UObject* owner, UNRX4IObservable<Args...>* observable, unrx4_unique_ptr<UNRX4IObserver<Args...>>&& observer)
+{
+    UNRX4_ASSERT(nullptr != observable);
+    UNRX4_ASSERT(nullptr != observer);
+    UNRX4IObserver<Args...>* pointer = observer.Release();
+    observable->subscribe(pointer);
+    add(owner, observable, pointer, &unsubscribeObservers<Args...>, &destroyObserver<Args...>);
+}
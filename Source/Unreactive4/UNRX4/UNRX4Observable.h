@@ -17,9 +17,22 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  * @author t-sakai
  */
 // clang-format on
+#include <Async/Async.h>
+#include <Async/Future.h>
+#include <Async/ParallelFor.h>
 #include "UNRX4Container.h"
 #include "UNRX4IObservable.h"
 #include "UNRX4IObserver.h"
+#include "UNRX4IScheduler.h"
+#include "UNRX4ISizedObservable.h"
+#include "UNRX4PipelineArena.h"
+#include "UNRX4Profiler.h"
+#include "UNRX4ThreadPoolScheduler.h"
+#include "UNRX4Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <utility>
 
 //-------------------
 template<class T>
@@ -79,27 +92,874 @@ UNRX4ObservableRepeat<T>::UNRX4ObservableRepeat(unrx4::u32 count, T value)
 template<class T>
 void UNRX4ObservableRepeat<T>::subscribe(UNRX4IObserver<T>* observer)
 {
-    for(unrx4::u32 i = 0; i < count; ++i) {
+    for(unrx4::u32 i = 0; i < count_; ++i) {
         observer->next(value_);
     }
     observer->completed();
 }
 
 //-------------------
+/**
+ * @brief Emit count values from start, each incremented by one
+ */
+template<class T>
+class UNRX4ObservableRange: public UNRX4ISizedObservable<T>
+{
+public:
+    UNRX4ObservableRange(T start, unrx4::u32 count);
+    virtual ~UNRX4ObservableRange() {}
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* /*observer*/) override{}
+    virtual void next(T) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+    virtual unrx4::size_t size() const override;
+    virtual UNRX4Batch<T> read(unrx4::size_t offset, unrx4::size_t count, T* scratch) const override;
+
+private:
+    T start_;
+    unrx4::u32 count_;
+};
+
+template<class T>
+UNRX4ObservableRange<T>::UNRX4ObservableRange(T start, unrx4::u32 count)
+    : start_(start)
+    , count_(count)
+{
+}
+
+template<class T>
+void UNRX4ObservableRange<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    T value = start_;
+    for(unrx4::u32 i = 0; i < count_; ++i) {
+        observer->next(value);
+        ++value;
+    }
+    observer->completed();
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableRange<T>::size() const
+{
+    return count_;
+}
+
+template<class T>
+UNRX4Batch<T> UNRX4ObservableRange<T>::read(unrx4::size_t offset, unrx4::size_t count, T* scratch) const
+{
+    UNRX4_ASSERT((offset + count) <= count_);
+    for(unrx4::size_t i = 0; i < count; ++i) {
+        new(&scratch[i]) T(static_cast<T>(start_ + static_cast<T>(offset + i)));
+    }
+    return UNRX4Batch<T>(scratch, static_cast<int32>(count));
+}
+
+//-------------------
+/**
+ * @brief Emit values of an owned array
+ */
+template<class T>
+class UNRX4ObservableArray: public UNRX4ISizedObservable<T>
+{
+public:
+    explicit UNRX4ObservableArray(UNRX4Array<T>&& values);
+    virtual ~UNRX4ObservableArray() {}
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* /*observer*/) override{}
+    virtual void next(T) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+    virtual unrx4::size_t size() const override;
+    virtual bool needsScratch() const override { return false; }
+    virtual UNRX4Batch<T> read(unrx4::size_t offset, unrx4::size_t count, T* scratch) const override;
+
+private:
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4ObservableArray<T>::UNRX4ObservableArray(UNRX4Array<T>&& values)
+    : values_(std::move(values))
+{
+}
+
+template<class T>
+void UNRX4ObservableArray<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    for(unrx4::size_t i = 0; i < values_.size(); ++i) {
+        observer->next(values_[i]);
+    }
+    observer->completed();
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableArray<T>::size() const
+{
+    return values_.size();
+}
+
+template<class T>
+UNRX4Batch<T> UNRX4ObservableArray<T>::read(unrx4::size_t offset, unrx4::size_t count, T* /*scratch*/) const
+{
+    UNRX4_ASSERT((offset + count) <= values_.size());
+    return UNRX4Batch<T>(values_.cbegin() + offset, static_cast<int32>(count));
+}
+
+//-------------------
+/**
+ * @brief Emit values of caller-owned memory without copying, the memory should outlive this
+ */
+template<class T>
+class UNRX4ObservableView: public UNRX4ISizedObservable<T>
+{
+public:
+    explicit UNRX4ObservableView(UNRX4Batch<T> values);
+    virtual ~UNRX4ObservableView() {}
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* /*observer*/) override{}
+    virtual void next(T) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+    virtual unrx4::size_t size() const override;
+    virtual bool needsScratch() const override { return false; }
+    virtual UNRX4Batch<T> read(unrx4::size_t offset, unrx4::size_t count, T* scratch) const override;
+
+private:
+    UNRX4Batch<T> values_;
+};
+
+template<class T>
+UNRX4ObservableView<T>::UNRX4ObservableView(UNRX4Batch<T> values)
+    : values_(values)
+{
+}
+
+template<class T>
+void UNRX4ObservableView<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    for(const T& value: values_) {
+        observer->next(value);
+    }
+    observer->completed();
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableView<T>::size() const
+{
+    return static_cast<unrx4::size_t>(values_.Num());
+}
+
+template<class T>
+UNRX4Batch<T> UNRX4ObservableView<T>::read(unrx4::size_t offset, unrx4::size_t count, T* /*scratch*/) const
+{
+    UNRX4_ASSERT((offset + count) <= size());
+    return UNRX4Batch<T>(values_.GetData() + offset, static_cast<int32>(count));
+}
+
+//-------------------
+/**
+ * @brief Emit a sized source in batches, each one is read when it is emitted
+ *
+ * With a scheduler, each batch is emitted by its own action, then subscribe returns before the first batch.
+ */
+template<class T>
+class UNRX4ObservableChunks: public UNRX4IObservable<UNRX4Batch<T>>
+{
+public:
+    using this_type = UNRX4ObservableChunks<T>;
+    using observer_type = UNRX4IObserver<UNRX4Batch<T>>;
+
+    UNRX4ObservableChunks(UNRX4ISizedObservable<T>* source, unrx4::size_t chunkSize, UNRX4IScheduler* scheduler);
+    virtual ~UNRX4ObservableChunks();
+
+    virtual void subscribe(UNRX4IObserver<UNRX4Batch<T>>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<UNRX4Batch<T>>* observer) override;
+    virtual void next(UNRX4Batch<T>) override {}
+    virtual void error(unrx4::error_code_type /*errorCode*/) override {}
+    virtual void completed() override {}
+
+private:
+    struct Cursor
+    {
+        observer_type* observer_;
+        unrx4::size_t offset_;
+        UNRX4SizedScratch<T> scratch_;
+    };
+
+    struct State
+    {
+        FCriticalSection lock_;
+        this_type* owner_;
+    };
+    using state_type = TSharedRef<State, ESPMode::ThreadSafe>;
+
+    static void step(const state_type& state, Cursor* cursor);
+
+    /**
+     * @brief Emit the next batch
+     * @return false if the cursor finished, then it is destroyed
+     */
+    bool advance(Cursor* cursor);
+
+    state_type state_;
+    UNRX4ISizedObservable<T>* source_;
+    unrx4::size_t chunkSize_;
+    UNRX4IScheduler* scheduler_;
+    UNRX4Array<Cursor*> cursors_;
+};
+
+template<class T>
+UNRX4ObservableChunks<T>::UNRX4ObservableChunks(UNRX4ISizedObservable<T>* source, unrx4::size_t chunkSize, UNRX4IScheduler* scheduler)
+    : state_(MakeShared<State, ESPMode::ThreadSafe>())
+    , source_(source)
+    , chunkSize_(0 < chunkSize ? chunkSize : 1)
+    , scheduler_(scheduler)
+{
+    UNRX4_ASSERT(nullptr != source_);
+    state_->owner_ = this;
+}
+
+template<class T>
+UNRX4ObservableChunks<T>::~UNRX4ObservableChunks()
+{
+    FScopeLock lock(&state_->lock_);
+    state_->owner_ = nullptr;
+    for(Cursor* cursor: cursors_) {
+        unrx4_destruct(cursor);
+    }
+    cursors_.clear();
+}
+
+template<class T>
+void UNRX4ObservableChunks<T>::subscribe(UNRX4IObserver<UNRX4Batch<T>>* observer)
+{
+    Cursor* cursor = unrx4_construct<Cursor>();
+    cursor->observer_ = observer;
+    cursor->offset_ = 0;
+    {
+        FScopeLock lock(&state_->lock_);
+        cursors_.push_back(cursor);
+    }
+    if(nullptr == scheduler_) {
+        FScopeLock lock(&state_->lock_);
+        while(advance(cursor)) {
+        }
+        return;
+    }
+    scheduler_->schedule(UNRX4Action([state = state_, cursor]() {
+        step(state, cursor);
+    }));
+}
+
+template<class T>
+void UNRX4ObservableChunks<T>::unsubscribe(UNRX4IObserver<UNRX4Batch<T>>* observer)
+{
+    //Cursors are destroyed at their next step
+    FScopeLock lock(&state_->lock_);
+    for(Cursor* cursor: cursors_) {
+        if(observer == cursor->observer_) {
+            cursor->observer_ = nullptr;
+        }
+    }
+}
+
+template<class T>
+void UNRX4ObservableChunks<T>::step(const state_type& state, Cursor* cursor)
+{
+    FScopeLock lock(&state->lock_);
+    this_type* owner = state->owner_;
+    if(nullptr == owner || !owner->advance(cursor)) {
+        return;
+    }
+    owner->scheduler_->schedule(UNRX4Action([state, cursor]() {
+        step(state, cursor);
+    }));
+}
+
+template<class T>
+bool UNRX4ObservableChunks<T>::advance(Cursor* cursor)
+{
+    unrx4::size_t size = source_->size();
+    if(nullptr != cursor->observer_ && cursor->offset_ < size) {
+        unrx4::size_t count = (size - cursor->offset_) < chunkSize_ ? (size - cursor->offset_) : chunkSize_;
+        UNRX4Batch<T> values = source_->read(cursor->offset_, count, cursor->scratch_.prepare(*source_, count));
+        cursor->offset_ += count;
+        cursor->observer_->next(values);
+        cursor->scratch_.release(values);
+        return true;
+    }
+    if(nullptr != cursor->observer_) {
+        cursor->observer_->completed();
+    }
+    cursors_.remove(cursor);
+    unrx4_destruct(cursor);
+    return false;
+}
+
+//-------------------
+/**
+ * @brief How UNRX4ObservableFromEvent calls its observers
+ */
+enum class UNRX4DispatchMode : unrx4::u8
+{
+    Serial,   //!< Call observers in order on the calling thread
+    Parallel, //!< Split observers into chunks over worker threads, then join before returning
+    Async,    //!< Split observers into chunks over the thread pool, then return without waiting
+};
+
+namespace unrx4
+{
+namespace dispatch
+{
+    /**
+     * @brief The observable whose asynchronous chunk is running on this thread
+     */
+    inline const void*& current()
+    {
+        static thread_local const void* observable = nullptr;
+        return observable;
+    }
+} // namespace dispatch
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Observable from an event
+ *
+ * In Serial mode, subscribing, unsubscribing and events happen on one thread, and nothing is locked.
+ * In Parallel and Async modes, observers can also unsubscribe from worker threads, then observers are locked,
+ * and every event calls the observers of its own snapshot.
+ */
+template<class... Args>
+class UNRX4ObservableFromEvent: public UNRX4IObservable<Args...>
+{
+public:
+    using this_type = UNRX4ObservableFromEvent<Args...>;
+    using delegate_type = UNRX4Function<void(Args...)>;
+    using observer_type = UNRX4IObserver<Args...>;
+
+    static constexpr unrx4::size_t DefaultParallelThreshold = 64;
+    static constexpr unrx4::size_t MinParallelChunk = 8;
+    static constexpr unrx4::size_t MaxParallelChunks = 64;
+
+    UNRX4ObservableFromEvent(UNRX4Function<void(Args...)>& handler)
+        : mode_(UNRX4DispatchMode::Serial)
+        , threshold_(DefaultParallelThreshold)
+        , scheduler_(nullptr)
+        , pending_(0)
+        , handler_(nullptr)
+    {
+        handler.bind(this, &this_type::next);
+    }
+
+    /**
+     * @brief Place the binding of the handler and observers in an arena, the handler should outlive this
+     */
+    UNRX4ObservableFromEvent(UNRX4Function<void(Args...)>& handler, UNRX4PipelineArena& arena)
+        : observers_(arena)
+        , mode_(UNRX4DispatchMode::Serial)
+        , threshold_(DefaultParallelThreshold)
+        , scheduler_(nullptr)
+        , spare_(arena)
+        , removals_(arena)
+        , pending_(0)
+        , handler_(&handler)
+    {
+        handler = delegate_type(arena, [this](Args... args) { next(args...); });
+    }
+
+    virtual ~UNRX4ObservableFromEvent()
+    {
+        wait();
+        //The binding is released with the arena
+        if(nullptr != handler_) {
+            *handler_ = delegate_type();
+        }
+    }
+
+    virtual void subscribe(UNRX4IObserver<Args...>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<Args...>* observer) override;
+
+    /**
+     * @brief Subscribe observers with one reallocation at most
+     */
+    virtual void subscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count) override;
+
+    /**
+     * @brief Unsubscribe observers in one pass, O((n + m) log m) for n observers and m targets
+     *
+     * Each target removes one subscription like unsubscribe, and the order of remaining observers is kept.
+     */
+    virtual void unsubscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count) override;
+
+    virtual void next(Args... args) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Opt in to parallel dispatch for many independent observers
+     * @param mode ... Parallel and Async modes call observers concurrently, then they should not share state without synchronization
+     * @param threshold ... Events for fewer observers than this are dispatched serially
+     * @param scheduler ... The thread pool which runs chunks in Async mode, Async falls back to Parallel without it.
+     * Schedulers drained on the calling thread are not accepted, because wait() would never return.
+     * Call this on the thread which dispatches events, while no observer is being called.
+     */
+    void setDispatchMode(UNRX4DispatchMode mode, unrx4::size_t threshold = DefaultParallelThreshold, UNRX4ThreadPoolScheduler* scheduler = nullptr);
+
+    /**
+     * @brief Block until all asynchronous dispatches finish
+     */
+    void wait();
+
+    /**
+     * @brief The number of asynchronous dispatches which have not finished
+     */
+    unrx4::s32 pending() const;
+
+protected:
+    UNRX4ObservableFromEvent()
+        : mode_(UNRX4DispatchMode::Serial)
+        , threshold_(DefaultParallelThreshold)
+        , scheduler_(nullptr)
+        , pending_(0)
+        , handler_(nullptr)
+    {
+    }
+
+    explicit UNRX4ObservableFromEvent(UNRX4PipelineArena& arena)
+        : observers_(arena)
+        , mode_(UNRX4DispatchMode::Serial)
+        , threshold_(DefaultParallelThreshold)
+        , scheduler_(nullptr)
+        , spare_(arena)
+        , removals_(arena)
+        , pending_(0)
+        , handler_(nullptr)
+    {
+    }
+
+private:
+    using args_type = std::tuple<typename std::decay<Args>::type...>;
+
+    /**
+     * @brief An event and the observers at the time, shared by the chunks of an asynchronous dispatch
+     */
+    struct Dispatch
+    {
+        Dispatch(Args... args)
+            : args_(args...)
+            , chunks_(0)
+        {
+        }
+
+        template<std::size_t... I>
+        void call(observer_type* observer, std::index_sequence<I...>) const
+        {
+            observer->next(std::get<I>(args_)...);
+        }
+
+        args_type args_;
+        UNRX4Array<observer_type*> observers_;
+        std::atomic<unrx4::s32> chunks_;
+    };
+
+    /**
+     * @brief Lock observers only in Parallel and Async modes
+     */
+    class ScopeLock
+    {
+    public:
+        explicit ScopeLock(this_type* owner)
+            : lock_(UNRX4DispatchMode::Serial == owner->mode_ ? nullptr : &owner->lock_)
+        {
+            if(nullptr != lock_) {
+                lock_->Lock();
+            }
+        }
+
+        ~ScopeLock()
+        {
+            if(nullptr != lock_) {
+                lock_->Unlock();
+            }
+        }
+
+    private:
+        FCriticalSection* lock_;
+    };
+
+    /**
+     * @brief A target of unsubscribeMany, sorted by observer
+     */
+    struct Removal
+    {
+        observer_type* observer_;
+        bool removed_;
+
+        bool operator<(const Removal& other) const
+        {
+            return observer_ < other.observer_;
+        }
+    };
+
+    static unrx4::size_t parallelChunk(unrx4::size_t size);
+
+    /**
+     * @brief Wait for asynchronous dispatches before an observer leaves, unless called from a chunk of this observable
+     */
+    void waitForUnsubscribe();
+
+    /**
+     * @brief Copy observers to a buffer owned by one dispatch, because an observer can dispatch another event re-entrantly
+     */
+    void acquireSnapshot(UNRX4Array<observer_type*>& snapshot);
+    void releaseSnapshot(UNRX4Array<observer_type*>& snapshot);
+    void dispatchParallel(const UNRX4Array<observer_type*>& snapshot, Args... args);
+    void dispatchAsync(UNRX4Array<observer_type*>&& snapshot, Args... args);
+
+    UNRX4Array<observer_type*> observers_;
+    UNRX4DispatchMode mode_;
+    unrx4::size_t threshold_;
+    UNRX4ThreadPoolScheduler* scheduler_;
+    FCriticalSection lock_;
+    UNRX4Array<observer_type*> spare_;
+    UNRX4Array<Removal> removals_;
+    std::atomic<unrx4::s32> pending_;
+    delegate_type* handler_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4ObservableFromEvent");
+};
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::subscribe(UNRX4IObserver<Args...>* observer)
+{
+    //Parallel dispatch lets observers unsubscribe from worker threads
+    ScopeLock lock(this);
+    observers_.push_back(observer);
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::unsubscribe(UNRX4IObserver<Args...>* observer)
+{
+    waitForUnsubscribe();
+    ScopeLock lock(this);
+    observers_.remove(observer);
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::subscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count)
+{
+    ScopeLock lock(this);
+    observers_.reserve(observers_.size() + count);
+    for(unrx4::size_t i = 0; i < count; ++i) {
+        observers_.push_back(observers[i]);
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::unsubscribeMany(UNRX4IObserver<Args...>* const* observers, unrx4::size_t count)
+{
+    waitForUnsubscribe();
+    ScopeLock lock(this);
+    if(count <= 1) {
+        if(0 < count) {
+            observers_.remove(observers[0]);
+        }
+        return;
+    }
+    removals_.resize(count);
+    for(unrx4::size_t i = 0; i < count; ++i) {
+        removals_[i] = {observers[i], false};
+    }
+    std::sort(removals_.begin(), removals_.end());
+
+    //Compact observers in place, then nothing is reallocated
+    unrx4::size_t remaining = count;
+    unrx4::size_t size = 0;
+    for(unrx4::size_t i = 0; i < observers_.size(); ++i) {
+        observer_type* observer = observers_[i];
+        if(0 < remaining) {
+            Removal* removal = std::lower_bound(removals_.begin(), removals_.end(), Removal{observer, false});
+            while(removal != removals_.end() && observer == removal->observer_ && removal->removed_) {
+                ++removal;
+            }
+            if(removal != removals_.end() && observer == removal->observer_) {
+                removal->removed_ = true;
+                --remaining;
+                continue;
+            }
+        }
+        if(size != i) {
+            observers_[size] = observer;
+        }
+        ++size;
+    }
+    observers_.resize(size);
+    removals_.clear();
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::next(Args... args)
+{
+    if(UNRX4DispatchMode::Serial != mode_) {
+        //Observers which unsubscribe during the dispatch still receive this event
+        UNRX4Array<observer_type*> snapshot;
+        acquireSnapshot(snapshot);
+        UNRX4_TRACE_DISPATCH("UNRX4ObservableFromEvent::next", this, snapshot.size());
+        UNRX4_PROFILE_DISPATCH(profile_, snapshot.size());
+        if(snapshot.size() < threshold_) {
+            for(observer_type* observer: snapshot) {
+                observer->next(args...);
+            }
+        } else if(UNRX4DispatchMode::Async == mode_ && nullptr != scheduler_) {
+            dispatchAsync(std::move(snapshot), args...);
+            return;
+        } else {
+            dispatchParallel(snapshot, args...);
+        }
+        releaseSnapshot(snapshot);
+        return;
+    }
+    UNRX4_TRACE_DISPATCH("UNRX4ObservableFromEvent::next", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(args...);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::error(unrx4::error_code_type errorCode)
+{
+    //Terminate after asynchronous dispatches of preceding events
+    wait();
+    UNRX4_TRACE_DISPATCH("UNRX4ObservableFromEvent::error", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::completed()
+{
+    //Terminate after asynchronous dispatches of preceding events
+    wait();
+    UNRX4_TRACE_DISPATCH("UNRX4ObservableFromEvent::completed", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::setDispatchMode(UNRX4DispatchMode mode, unrx4::size_t threshold, UNRX4ThreadPoolScheduler* scheduler)
+{
+    mode_ = mode;
+    threshold_ = 0 < threshold ? threshold : 1;
+    scheduler_ = scheduler;
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::wait()
+{
+    while(0 < pending_.load(std::memory_order_acquire)) {
+        FPlatformProcess::Yield();
+    }
+}
+
+template<class... Args>
+unrx4::s32 UNRX4ObservableFromEvent<Args...>::pending() const
+{
+    return pending_.load(std::memory_order_relaxed);
+}
+
 template<class... Args>
-class UNRX4ObservableFromEvent: public UNRX4IObservable<Args...>
+unrx4::size_t UNRX4ObservableFromEvent<Args...>::parallelChunk(unrx4::size_t size)
+{
+    unrx4::size_t chunk = (size + MaxParallelChunks - 1) / MaxParallelChunks;
+    return chunk < MinParallelChunk ? MinParallelChunk : chunk;
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::waitForUnsubscribe()
+{
+    //Queued chunks call observers of their snapshots, then callers can delete observers after unsubscribing.
+    //An observer unsubscribing from its own chunk cannot wait for it, and must outlive wait() to be deleted.
+    if(this != unrx4::dispatch::current()) {
+        wait();
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::acquireSnapshot(UNRX4Array<observer_type*>& snapshot)
+{
+    //Reuse the buffer of a finished dispatch
+    FScopeLock lock(&lock_);
+    snapshot = std::move(spare_);
+    snapshot.resize(observers_.size());
+    FMemory::Memcpy(snapshot.begin(), observers_.cbegin(), sizeof(observer_type*) * observers_.size());
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::releaseSnapshot(UNRX4Array<observer_type*>& snapshot)
+{
+    FScopeLock lock(&lock_);
+    if(spare_.capacity() < snapshot.capacity()) {
+        snapshot.clear();
+        spare_ = std::move(snapshot);
+    }
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::dispatchParallel(const UNRX4Array<observer_type*>& snapshot, Args... args)
+{
+    const unrx4::size_t size = snapshot.size();
+    const unrx4::size_t chunk = parallelChunk(size);
+    const unrx4::size_t chunks = (size + chunk - 1) / chunk;
+    observer_type* const* observers = snapshot.cbegin();
+    ParallelFor(
+        static_cast<int32>(chunks), [observers, size, chunk, &args...](int32 index) {
+            unrx4::size_t begin = static_cast<unrx4::size_t>(index) * chunk;
+            unrx4::size_t end = (size - begin) < chunk ? size : begin + chunk;
+            for(unrx4::size_t i = begin; i < end; ++i) {
+                observers[i]->next(args...);
+            }
+        },
+        chunks <= 1);
+}
+
+template<class... Args>
+void UNRX4ObservableFromEvent<Args...>::dispatchAsync(UNRX4Array<observer_type*>&& snapshot, Args... args)
+{
+    Dispatch* dispatch = unrx4_construct<Dispatch>(args...);
+    dispatch->observers_ = std::move(snapshot);
+    const unrx4::size_t size = dispatch->observers_.size();
+    const unrx4::size_t chunk = parallelChunk(size);
+    const unrx4::size_t chunks = (size + chunk - 1) / chunk;
+    dispatch->chunks_.store(static_cast<unrx4::s32>(chunks), std::memory_order_relaxed);
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    for(unrx4::size_t c = 0; c < chunks; ++c) {
+        scheduler_->schedule(UNRX4Action([this, dispatch, c, size, chunk]() {
+            unrx4::size_t begin = c * chunk;
+            unrx4::size_t end = (size - begin) < chunk ? size : begin + chunk;
+            const void* previous = unrx4::dispatch::current();
+            unrx4::dispatch::current() = this;
+            for(unrx4::size_t i = begin; i < end; ++i) {
+                dispatch->call(dispatch->observers_[i], std::index_sequence_for<Args...>());
+            }
+            unrx4::dispatch::current() = previous;
+            //The last chunk releases the event
+            if(1 == dispatch->chunks_.fetch_sub(1, std::memory_order_acq_rel)) {
+                unrx4_destruct(dispatch);
+                pending_.fetch_sub(1, std::memory_order_release);
+            }
+        }));
+    }
+}
+
+//-------------------
+/**
+ * @brief Collect subscriptions and unsubscriptions to an observable, then apply them in bulk on commit or destruction
+ *
+ * Subscriptions are applied before unsubscriptions, then an observer subscribed and unsubscribed in a transaction ends unsubscribed.
+ */
+template<class... Args>
+class UNRX4SubscriptionTransaction
 {
 public:
-    using this_type = UNRX4ObservableFromEvent<Args...>;
-    using delegate_type = UNRX4Function<void(Args...)>;
     using observer_type = UNRX4IObserver<Args...>;
 
-    UNRX4ObservableFromEvent(UNRX4Function<void(Args...)>& handler)
+    explicit UNRX4SubscriptionTransaction(UNRX4IObservable<Args...>* observable);
+    ~UNRX4SubscriptionTransaction();
+
+    void subscribe(observer_type* observer);
+    void unsubscribe(observer_type* observer);
+    void commit();
+
+private:
+    UNRX4SubscriptionTransaction(const UNRX4SubscriptionTransaction&) = delete;
+    UNRX4SubscriptionTransaction& operator=(const UNRX4SubscriptionTransaction&) = delete;
+
+    UNRX4IObservable<Args...>* observable_;
+    UNRX4Array<observer_type*> subscriptions_;
+    UNRX4Array<observer_type*> unsubscriptions_;
+};
+
+template<class... Args>
+UNRX4SubscriptionTransaction<Args...>::UNRX4SubscriptionTransaction(UNRX4IObservable<Args...>* observable)
+    : observable_(observable)
+{
+    UNRX4_ASSERT(nullptr != observable_);
+}
+
+template<class... Args>
+UNRX4SubscriptionTransaction<Args...>::~UNRX4SubscriptionTransaction()
+{
+    commit();
+}
+
+template<class... Args>
+void UNRX4SubscriptionTransaction<Args...>::subscribe(observer_type* observer)
+{
+    subscriptions_.push_back(observer);
+}
+
+template<class... Args>
+void UNRX4SubscriptionTransaction<Args...>::unsubscribe(observer_type* observer)
+{
+    unsubscriptions_.push_back(observer);
+}
+
+template<class... Args>
+void UNRX4SubscriptionTransaction<Args...>::commit()
+{
+    if(0 < subscriptions_.size()) {
+        observable_->subscribeMany(subscriptions_.cbegin(), subscriptions_.size());
+        subscriptions_.clear();
+    }
+    if(0 < unsubscriptions_.size()) {
+        observable_->unsubscribeMany(unsubscriptions_.cbegin(), unsubscriptions_.size());
+        unsubscriptions_.clear();
+    }
+}
+
+//-------------------
+/**
+ * @brief Observable from an event, which links observers into an intrusive list
+ *
+ * Subscribing and unsubscribing are O(1) and allocate nothing, but an observer can subscribe to only one intrusive observable at a time.
+ */
+template<class... Args>
+class UNRX4IntrusiveObservable: public UNRX4IObservable<Args...>
+{
+public:
+    using this_type = UNRX4IntrusiveObservable<Args...>;
+    using observer_type = UNRX4IObserver<Args...>;
+
+    UNRX4IntrusiveObservable(UNRX4Function<void(Args...)>& handler)
     {
         handler.bind(this, &this_type::next);
     }
 
-    virtual ~UNRX4ObservableFromEvent() {}
+    virtual ~UNRX4IntrusiveObservable() {}
 
     virtual void subscribe(UNRX4IObserver<Args...>* observer) override;
     virtual void unsubscribe(UNRX4IObserver<Args...>* observer) override;
@@ -107,46 +967,263 @@ public:
     virtual void error(unrx4::error_code_type errorCode) override;
     virtual void completed() override;
 
+protected:
+    UNRX4IntrusiveObservable() {}
+
 private:
-    UNRX4Array<observer_type*> observers_;
+    UNRX4ObserverList<Args...> observers_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4IntrusiveObservable");
 };
 
 template<class... Args>
-void UNRX4ObservableFromEvent<Args...>::subscribe(UNRX4IObserver<Args...>* observer)
+void UNRX4IntrusiveObservable<Args...>::subscribe(UNRX4IObserver<Args...>* observer)
 {
     observers_.push_back(observer);
 }
 
 template<class... Args>
-void UNRX4ObservableFromEvent<Args...>::unsubscribe(UNRX4IObserver<Args...>* observer)
+void UNRX4IntrusiveObservable<Args...>::unsubscribe(UNRX4IObserver<Args...>* observer)
 {
     observers_.remove(observer);
 }
 
 template<class... Args>
-void UNRX4ObservableFromEvent<Args...>::next(Args... args)
+void UNRX4IntrusiveObservable<Args...>::next(Args... args)
 {
-    for(observer_type* observer: observers_) {
-        observer->next(std::forward<Args>(args)...);
-    }
+    UNRX4_TRACE_DISPATCH("UNRX4IntrusiveObservable::next", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    observers_.forEach([&](observer_type* observer) {
+        observer->next(args...);
+    });
 }
 
 template<class... Args>
-void UNRX4ObservableFromEvent<Args...>::error(unrx4::error_code_type errorCode)
+void UNRX4IntrusiveObservable<Args...>::error(unrx4::error_code_type errorCode)
 {
-    for(observer_type* observer: observers_) {
+    UNRX4_TRACE_DISPATCH("UNRX4IntrusiveObservable::error", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    observers_.forEach([errorCode](observer_type* observer) {
         observer->error(errorCode);
-    }
+    });
 }
 
 template<class... Args>
-void UNRX4ObservableFromEvent<Args...>::completed()
+void UNRX4IntrusiveObservable<Args...>::completed()
+{
+    UNRX4_TRACE_DISPATCH("UNRX4IntrusiveObservable::completed", this, observers_.size());
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    observers_.forEach([](observer_type* observer) {
+        observer->completed();
+    });
+}
+
+//-------------------
+/**
+ * @brief Bind a single-cast delegate to an observable, the delegate should outlive the observable
+ */
+template<class... Args>
+class UNRX4ObservableFromDelegate: public UNRX4ObservableFromEvent<Args...>
+{
+public:
+    using this_type = UNRX4ObservableFromDelegate<Args...>;
+    using base_type = UNRX4ObservableFromEvent<Args...>;
+    using delegate_type = TDelegate<void(Args...)>;
+
+    explicit UNRX4ObservableFromDelegate(delegate_type& delegate)
+        : delegate_(&delegate)
+    {
+        UNRX4_ASSERT(!delegate.IsBound());
+        delegate.BindRaw(static_cast<base_type*>(this), &base_type::next);
+    }
+
+    UNRX4ObservableFromDelegate(delegate_type& delegate, UNRX4PipelineArena& arena)
+        : base_type(arena)
+        , delegate_(&delegate)
+    {
+        UNRX4_ASSERT(!delegate.IsBound());
+        delegate.BindRaw(static_cast<base_type*>(this), &base_type::next);
+    }
+
+    virtual ~UNRX4ObservableFromDelegate()
+    {
+        delegate_->Unbind();
+    }
+
+private:
+    delegate_type* delegate_;
+};
+
+//-------------------
+/**
+ * @brief Add an observable to a multicast delegate, other bindings are kept
+ */
+template<class... Args>
+class UNRX4ObservableFromMulticastDelegate: public UNRX4ObservableFromEvent<Args...>
+{
+public:
+    using this_type = UNRX4ObservableFromMulticastDelegate<Args...>;
+    using base_type = UNRX4ObservableFromEvent<Args...>;
+    using delegate_type = TMulticastDelegate<void(Args...)>;
+
+    explicit UNRX4ObservableFromMulticastDelegate(delegate_type& delegate)
+        : delegate_(&delegate)
+        , handle_(delegate.AddRaw(static_cast<base_type*>(this), &base_type::next))
+    {
+    }
+
+    UNRX4ObservableFromMulticastDelegate(delegate_type& delegate, UNRX4PipelineArena& arena)
+        : base_type(arena)
+        , delegate_(&delegate)
+        , handle_(delegate.AddRaw(static_cast<base_type*>(this), &base_type::next))
+    {
+    }
+
+    virtual ~UNRX4ObservableFromMulticastDelegate()
+    {
+        delegate_->Remove(handle_);
+    }
+
+private:
+    delegate_type* delegate_;
+    FDelegateHandle handle_;
+};
+
+//-------------------
+/**
+ * @brief Emit the result of a future then complete.
+ *
+ * The result is delivered on the scheduler, or on the thread which fulfills the future if the scheduler is null.
+ * Schedulers which are not thread-safe receive the action on the game thread. Subscribers after the delivery receive the result immediately.
+ */
+template<class T>
+class UNRX4ObservableFromFuture: public UNRX4IObservable<T>
+{
+public:
+    using this_type = UNRX4ObservableFromFuture<T>;
+    using observer_type = UNRX4IObserver<T>;
+
+    UNRX4ObservableFromFuture(TFuture<T>&& future, UNRX4IScheduler* scheduler);
+    virtual ~UNRX4ObservableFromFuture();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override {}
+
+private:
+    struct State
+    {
+        FCriticalSection lock_;
+        this_type* owner_;
+    };
+    using state_type = TSharedRef<State, ESPMode::ThreadSafe>;
+
+    static void resolve(const state_type& state, const T& value);
+
+    state_type state_;
+    TOptional<T> result_;
+    UNRX4Array<observer_type*> observers_;
+};
+
+template<class T>
+UNRX4ObservableFromFuture<T>::UNRX4ObservableFromFuture(TFuture<T>&& future, UNRX4IScheduler* scheduler)
+    : state_(MakeShared<State, ESPMode::ThreadSafe>())
+{
+    state_->owner_ = this;
+    if(future.IsReady()) {
+        result_.Emplace(future.Get());
+        return;
+    }
+    future.Then([state = state_, scheduler](TFuture<T> self) {
+        if(nullptr == scheduler) {
+            resolve(state, self.Get());
+            return;
+        }
+        if(scheduler->isThreadSafe() || IsInGameThread()) {
+            scheduler->schedule(UNRX4Action([state, value = self.Get()]() {
+                resolve(state, value);
+            }));
+            return;
+        }
+        AsyncTask(ENamedThreads::GameThread, [state, scheduler, value = self.Get()]() {
+            scheduler->schedule(UNRX4Action([state, value]() {
+                resolve(state, value);
+            }));
+        });
+    });
+}
+
+template<class T>
+UNRX4ObservableFromFuture<T>::~UNRX4ObservableFromFuture()
+{
+    FScopeLock lock(&state_->lock_);
+    state_->owner_ = nullptr;
+}
+
+template<class T>
+void UNRX4ObservableFromFuture<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    {
+        FScopeLock lock(&state_->lock_);
+        if(!result_.IsSet()) {
+            observers_.push_back(observer);
+            return;
+        }
+    }
+    observer->next(result_.GetValue());
+    observer->completed();
+}
+
+template<class T>
+void UNRX4ObservableFromFuture<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    FScopeLock lock(&state_->lock_);
+    observers_.remove(observer);
+}
+
+template<class T>
+void UNRX4ObservableFromFuture<T>::next(T value)
 {
-    for(observer_type* observer: observers_) {
+    UNRX4_TRACE_DISPATCH("UNRX4ObservableFromFuture::next", this, observers_.size());
+    UNRX4Array<observer_type*> observers;
+    {
+        FScopeLock lock(&state_->lock_);
+        if(result_.IsSet()) {
+            return;
+        }
+        result_.Emplace(value);
+        observers = std::move(observers_);
+    }
+    for(observer_type* observer: observers) {
+        observer->next(value);
         observer->completed();
     }
 }
 
+template<class T>
+void UNRX4ObservableFromFuture<T>::error(unrx4::error_code_type errorCode)
+{
+    UNRX4Array<observer_type*> observers;
+    {
+        FScopeLock lock(&state_->lock_);
+        observers = std::move(observers_);
+    }
+    for(observer_type* observer: observers) {
+        observer->error(errorCode);
+    }
+}
+
+template<class T>
+void UNRX4ObservableFromFuture<T>::resolve(const state_type& state, const T& value)
+{
+    //The destructor waits for the lock, then the owner stays alive while observers are called. The lock is recursive.
+    FScopeLock lock(&state->lock_);
+    if(nullptr != state->owner_) {
+        state->owner_->next(value);
+    }
+}
+
 //-------------------
 class UNRX4Observable
 {
@@ -157,8 +1234,80 @@ public:
     template<class T>
     static unrx4_unique_ptr<UNRX4IObservable<T>> repeat(unrx4::u32 count, T value);
 
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ISizedObservable<T>> range(T start, unrx4::u32 count);
+
+    /**
+     * @brief Take the ownership of values
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ISizedObservable<T>> fromArray(UNRX4Array<T>&& values);
+
+    /**
+     * @brief Read caller-owned memory without copying, the memory should outlive the observable
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ISizedObservable<T>> fromArray(TArrayView<const T> values);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ISizedObservable<T>> fromRange(const T* begin, const T* end);
+
+    /**
+     * @brief Emit a sized source in batches of chunkSize, one batch per action if a scheduler is given
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<UNRX4Batch<T>>> chunks(UNRX4ISizedObservable<T>* source, unrx4::size_t chunkSize, UNRX4IScheduler* scheduler = nullptr);
+
     template<class... Args>
     static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromEvent(UNRX4Function<void(Args...)>& eventHandler);
+
+    /**
+     * @brief Same as fromEvent, but events for at least threshold observers are dispatched in parallel
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromEvent(UNRX4Function<void(Args...)>& eventHandler, UNRX4DispatchMode mode, unrx4::size_t threshold, UNRX4ThreadPoolScheduler* scheduler = nullptr);
+
+    /**
+     * @brief Same as fromEvent, but observers are linked into an intrusive list
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromEventIntrusive(UNRX4Function<void(Args...)>& eventHandler);
+
+    /**
+     * @brief Bind an unbound delegate to a new observable
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromDelegate(TDelegate<void(Args...)>& delegate);
+
+    /**
+     * @brief Add a new observable to a multicast delegate
+     */
+    template<class... Args>
+    static unrx4_unique_ptr<UNRX4IObservable<Args...>> fromMulticastDelegate(TMulticastDelegate<void(Args...)>& delegate);
+
+    /**
+     * @brief Same as fromEvent, but the observable, the binding of the handler and observers are placed in an arena
+     */
+    template<class... Args>
+    static UNRX4IObservable<Args...>* fromEvent(UNRX4PipelineArena& arena, UNRX4Function<void(Args...)>& eventHandler);
+
+    /**
+     * @brief Same as fromDelegate, but the observable and observers are placed in an arena
+     */
+    template<class... Args>
+    static UNRX4IObservable<Args...>* fromDelegate(UNRX4PipelineArena& arena, TDelegate<void(Args...)>& delegate);
+
+    /**
+     * @brief Same as fromMulticastDelegate, but the observable and observers are placed in an arena
+     */
+    template<class... Args>
+    static UNRX4IObservable<Args...>* fromMulticastDelegate(UNRX4PipelineArena& arena, TMulticastDelegate<void(Args...)>& delegate);
+
+    /**
+     * @brief Emit the result of a future on a scheduler, or on the fulfilling thread if the scheduler is null
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> fromFuture(TFuture<T>&& future, UNRX4IScheduler* scheduler = nullptr);
 };
 
 template<class T>
@@ -173,8 +1322,89 @@ unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Observable::repeat(unrx4::u32 count,
     return unrx4_make_unique<UNRX4ObservableRepeat<T>>(count, value);
 }
 
+template<class T>
+unrx4_unique_ptr<UNRX4ISizedObservable<T>> UNRX4Observable::range(T start, unrx4::u32 count)
+{
+    return unrx4_make_unique<UNRX4ObservableRange<T>>(start, count);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4ISizedObservable<T>> UNRX4Observable::fromArray(UNRX4Array<T>&& values)
+{
+    return unrx4_make_unique<UNRX4ObservableArray<T>>(std::move(values));
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4ISizedObservable<T>> UNRX4Observable::fromArray(TArrayView<const T> values)
+{
+    return unrx4_make_unique<UNRX4ObservableView<T>>(values);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4ISizedObservable<T>> UNRX4Observable::fromRange(const T* begin, const T* end)
+{
+    UNRX4_ASSERT(begin <= end);
+    return unrx4_make_unique<UNRX4ObservableView<T>>(UNRX4Batch<T>(begin, static_cast<int32>(end - begin)));
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<UNRX4Batch<T>>> UNRX4Observable::chunks(UNRX4ISizedObservable<T>* source, unrx4::size_t chunkSize, UNRX4IScheduler* scheduler)
+{
+    return unrx4_make_unique<UNRX4ObservableChunks<T>>(source, chunkSize, scheduler);
+}
+
 template<class... Args>
 unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4Observable::fromEvent(UNRX4Function<void(Args...)>& eventHandler)
 {
     return unrx4_make_unique<UNRX4ObservableFromEvent<Args...>>(eventHandler);
 }
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4Observable::fromEvent(UNRX4Function<void(Args...)>& eventHandler, UNRX4DispatchMode mode, unrx4::size_t threshold, UNRX4ThreadPoolScheduler* scheduler)
+{
+    unrx4_unique_ptr<UNRX4ObservableFromEvent<Args...>> observable = unrx4_make_unique<UNRX4ObservableFromEvent<Args...>>(eventHandler);
+    observable->setDispatchMode(mode, threshold, scheduler);
+    return observable;
+}
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4Observable::fromEventIntrusive(UNRX4Function<void(Args...)>& eventHandler)
+{
+    return unrx4_make_unique<UNRX4IntrusiveObservable<Args...>>(eventHandler);
+}
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4Observable::fromDelegate(TDelegate<void(Args...)>& delegate)
+{
+    return unrx4_make_unique<UNRX4ObservableFromDelegate<Args...>>(delegate);
+}
+
+template<class... Args>
+unrx4_unique_ptr<UNRX4IObservable<Args...>> UNRX4Observable::fromMulticastDelegate(TMulticastDelegate<void(Args...)>& delegate)
+{
+    return unrx4_make_unique<UNRX4ObservableFromMulticastDelegate<Args...>>(delegate);
+}
+
+template<class... Args>
+UNRX4IObservable<Args...>* UNRX4Observable::fromEvent(UNRX4PipelineArena& arena, UNRX4Function<void(Args...)>& eventHandler)
+{
+    return arena.create<UNRX4ObservableFromEvent<Args...>>(eventHandler, arena);
+}
+
+template<class... Args>
+UNRX4IObservable<Args...>* UNRX4Observable::fromDelegate(UNRX4PipelineArena& arena, TDelegate<void(Args...)>& delegate)
+{
+    return arena.create<UNRX4ObservableFromDelegate<Args...>>(delegate, arena);
+}
+
+template<class... Args>
+UNRX4IObservable<Args...>* UNRX4Observable::fromMulticastDelegate(UNRX4PipelineArena& arena, TMulticastDelegate<void(Args...)>& delegate)
+{
+    return arena.create<UNRX4ObservableFromMulticastDelegate<Args...>>(delegate, arena);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Observable::fromFuture(TFuture<T>&& future, UNRX4IScheduler* scheduler)
+{
+    return unrx4_make_unique<UNRX4ObservableFromFuture<T>>(std::move(future), scheduler);
+}
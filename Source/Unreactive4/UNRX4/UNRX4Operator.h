@@ -0,0 +1,253 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Operator.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4Profiler.h"
+#include "UNRX4Trace.h"
+
+//-------------------
+/**
+ * @brief Base of operator stages, which observe a source and emit to their own observers
+ *
+ * A stage subscribes its source when the first observer subscribes, and unsubscribes when the last one leaves,
+ * so all observers of a stage share one upstream subscription. Derived classes can disable this to connect manually.
+ * Derived classes implement onNext, and can override onError and onCompleted, which are called without virtual dispatch.
+ * @tparam Derived ... The derived class
+ * @tparam In ... Type of upstream values
+ * @tparam Out ... Type of downstream values
+ */
+template<class Derived, class In, class Out = In>
+class UNRX4Operator: public UNRX4IObservable<Out>
+{
+public:
+    using source_type = UNRX4IObservable<In>;
+    using observer_type = UNRX4IObserver<Out>;
+
+    explicit UNRX4Operator(source_type* source);
+    virtual ~UNRX4Operator();
+
+    virtual void subscribe(UNRX4IObserver<Out>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<Out>* observer) override;
+
+    /**
+     * @brief Emit a value to observers directly
+     */
+    virtual void next(Out value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    unrx4::size_t numObservers() const;
+
+protected:
+    void emit(const Out& value);
+    void onError(unrx4::error_code_type errorCode);
+    void onCompleted();
+
+    void connect();
+    void disconnect();
+    bool isConnected() const;
+
+    /**
+     * @brief Drop the observers and disconnect the source, then the next subscription connects again
+     * @return The dropped observers
+     */
+    UNRX4Array<observer_type*> reset();
+
+    /**
+     * @brief Whether subscribe and unsubscribe connect and disconnect the source, true as default
+     */
+    void setAutoConnect(bool autoConnect);
+
+private:
+    UNRX4Operator(const UNRX4Operator&) = delete;
+    UNRX4Operator& operator=(const UNRX4Operator&) = delete;
+
+    class Inlet: public UNRX4IObserver<In>
+    {
+    public:
+        explicit Inlet(UNRX4Operator* owner)
+            : owner_(owner)
+        {
+        }
+
+        virtual void next(In value) override
+        {
+            UNRX4_TRACE_OPERATOR("UNRX4Operator::next", owner_, owner_->numObservers());
+            static_cast<Derived*>(owner_)->onNext(value);
+        }
+
+        virtual void error(unrx4::error_code_type errorCode) override
+        {
+            static_cast<Derived*>(owner_)->onError(errorCode);
+        }
+
+        virtual void completed() override
+        {
+            static_cast<Derived*>(owner_)->onCompleted();
+        }
+
+    private:
+        UNRX4Operator* owner_;
+    };
+
+    source_type* source_;
+    Inlet inlet_;
+    UNRX4Array<observer_type*> observers_;
+    bool connected_;
+    bool autoConnect_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4Operator");
+};
+
+template<class Derived, class In, class Out>
+UNRX4Operator<Derived, In, Out>::UNRX4Operator(source_type* source)
+    : source_(source)
+    , inlet_(this)
+    , connected_(false)
+    , autoConnect_(true)
+{
+}
+
+template<class Derived, class In, class Out>
+UNRX4Operator<Derived, In, Out>::~UNRX4Operator()
+{
+    disconnect();
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::subscribe(UNRX4IObserver<Out>* observer)
+{
+    observers_.push_back(observer);
+    if(autoConnect_) {
+        connect();
+    }
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::unsubscribe(UNRX4IObserver<Out>* observer)
+{
+    observers_.remove(observer);
+    if(autoConnect_ && observers_.size() <= 0) {
+        disconnect();
+    }
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::next(Out value)
+{
+    emit(value);
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::error(unrx4::error_code_type errorCode)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::completed()
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class Derived, class In, class Out>
+unrx4::size_t UNRX4Operator<Derived, In, Out>::numObservers() const
+{
+    return observers_.size();
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::emit(const Out& value)
+{
+    UNRX4_PROFILE_DISPATCH(profile_, observers_.size());
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(value);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::onError(unrx4::error_code_type errorCode)
+{
+    error(errorCode);
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::onCompleted()
+{
+    completed();
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::connect()
+{
+    if(connected_ || nullptr == source_) {
+        return;
+    }
+    //Cold sources emit while subscribing, so mark first
+    connected_ = true;
+    source_->subscribe(&inlet_);
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::disconnect()
+{
+    if(!connected_) {
+        return;
+    }
+    connected_ = false;
+    source_->unsubscribe(&inlet_);
+}
+
+template<class Derived, class In, class Out>
+bool UNRX4Operator<Derived, In, Out>::isConnected() const
+{
+    return connected_;
+}
+
+template<class Derived, class In, class Out>
+UNRX4Array<typename UNRX4Operator<Derived, In, Out>::observer_type*> UNRX4Operator<Derived, In, Out>::reset()
+{
+    UNRX4Array<observer_type*> observers(std::move(observers_));
+    disconnect();
+    return observers;
+}
+
+template<class Derived, class In, class Out>
+void UNRX4Operator<Derived, In, Out>::setAutoConnect(bool autoConnect)
+{
+    autoConnect_ = autoConnect;
+}
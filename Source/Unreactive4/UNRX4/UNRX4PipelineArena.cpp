@@ -0,0 +1,86 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4PipelineArena.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4PipelineArena.h"
+#include "UNRX4System.h"
+
+UNRX4PipelineArena::UNRX4PipelineArena()
+    : blocks_(nullptr)
+    , destructors_(nullptr)
+    , used_(0)
+{
+}
+
+UNRX4PipelineArena::~UNRX4PipelineArena()
+{
+    release();
+}
+
+void* UNRX4PipelineArena::allocate(unrx4::size_t size)
+{
+    //Every block has a tag before it, so that unrx4_free can skip arenas' blocks
+    unrx4::size_t required = HeaderSize + ((size + Alignment - 1) & ~(Alignment - 1));
+    if(nullptr == blocks_ || blocks_->capacity_ < (blocks_->top_ + required)) {
+        Block* block;
+        if((BlockHeaderSize + required) <= BlockSize) {
+            block = reinterpret_cast<Block*>(UNRX4System::getInstance().acquirePipelineBlock());
+            block->capacity_ = BlockSize;
+        } else {
+            block = reinterpret_cast<Block*>(FMemory::Malloc(BlockHeaderSize + required, Alignment));
+            block->capacity_ = BlockHeaderSize + required;
+        }
+        block->top_ = BlockHeaderSize;
+        block->next_ = blocks_;
+        blocks_ = block;
+    }
+    unrx4::u8* ptr = reinterpret_cast<unrx4::u8*>(blocks_) + blocks_->top_ + HeaderSize;
+    unrx4::setBlockTag(ptr, unrx4::BlockTag::Pipeline);
+    blocks_->top_ += required;
+    used_ += required;
+    return ptr;
+}
+
+void UNRX4PipelineArena::release()
+{
+    while(nullptr != destructors_) {
+        Destructor* destructor = destructors_;
+        destructors_ = destructor->next_;
+        destructor->destruct_(destructor->object_);
+    }
+    UNRX4System& system = UNRX4System::getInstance();
+    while(nullptr != blocks_) {
+        Block* block = blocks_;
+        blocks_ = block->next_;
+        if(BlockSize == block->capacity_) {
+            system.releasePipelineBlock(block);
+        } else {
+            FMemory::Free(block);
+        }
+    }
+    used_ = 0;
+}
+
+unrx4::size_t UNRX4PipelineArena::used() const
+{
+    return used_;
+}
+
+bool UNRX4PipelineArena::owns(const void* ptr)
+{
+    return unrx4::BlockTag::Pipeline == unrx4::getBlockTag(ptr);
+}
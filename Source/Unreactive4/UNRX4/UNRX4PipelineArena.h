@@ -0,0 +1,106 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4PipelineArena.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4.h"
+
+//-------------------
+/**
+ * @brief Region for all nodes of a subscription graph, which is torn down at once
+ *
+ * Nodes are placed in the arena by create(), and nodes from arena-aware factories of UNRX4Observable also place their handler bindings and observer lists there.
+ * Other allocations never go to arenas, because long-lived structures like scheduler queues would point into recycled blocks.
+ * Every block is tagged with unrx4::BlockTag::Pipeline, and unrx4_free ignores it. Blocks are recycled through a pool in UNRX4System.
+ * An arena is not thread-safe, then a graph in it is built and subscribed on one thread.
+ */
+UNREACTIVE4_API
+class UNRX4PipelineArena
+{
+public:
+    static constexpr unrx4::size_t BlockSize = 4096;
+    static constexpr unrx4::size_t Alignment = 16;
+
+    UNRX4PipelineArena();
+    ~UNRX4PipelineArena();
+
+    void* allocate(unrx4::size_t size);
+
+    /**
+     * @brief Construct an object, which is destructed when the arena is released
+     */
+    template<class T, class... Args>
+    T* create(Args&&... args);
+
+    /**
+     * @brief Destruct objects created by this arena in reverse order, then return all blocks to the pool
+     */
+    void release();
+
+    unrx4::size_t used() const;
+
+    /**
+     * @brief Whether a block was allocated by any arena
+     */
+    static bool owns(const void* ptr);
+
+private:
+    UNRX4PipelineArena(const UNRX4PipelineArena&) = delete;
+    UNRX4PipelineArena& operator=(const UNRX4PipelineArena&) = delete;
+
+    struct Block
+    {
+        Block* next_;
+        unrx4::size_t capacity_;
+        unrx4::size_t top_;
+    };
+
+    struct Destructor
+    {
+        Destructor* next_;
+        void (*destruct_)(void* object);
+        void* object_;
+    };
+
+    static constexpr unrx4::size_t HeaderSize = Alignment;
+    static constexpr unrx4::size_t BlockHeaderSize = (sizeof(Block) + Alignment - 1) & ~(Alignment - 1);
+
+    template<class T>
+    static void destruct(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+
+    Block* blocks_;
+    Destructor* destructors_;
+    unrx4::size_t used_;
+};
+
+template<class T, class... Args>
+T* UNRX4PipelineArena::create(Args&&... args)
+{
+    void* ptr = allocate(sizeof(T));
+    T* object = new(ptr) T(std::forward<Args>(args)...);
+    if(!std::is_trivially_destructible<T>::value) {
+        Destructor* destructor = reinterpret_cast<Destructor*>(allocate(sizeof(Destructor)));
+        destructor->next_ = destructors_;
+        destructor->destruct_ = &UNRX4PipelineArena::destruct<T>;
+        destructor->object_ = object;
+        destructors_ = destructor;
+    }
+    return object;
+}
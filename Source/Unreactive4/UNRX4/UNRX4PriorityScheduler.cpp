@@ -0,0 +1,226 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4PriorityScheduler.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4PriorityScheduler.h"
+#include "UNRX4Trace.h"
+
+namespace
+{
+    inline unrx4::u64 unrx4_internal_toCycles(double seconds)
+    {
+        return static_cast<unrx4::u64>(FMath::Max(seconds, 0.0) / FPlatformTime::GetSecondsPerCycle64());
+    }
+} // namespace
+
+//-------------------
+double UNRX4PriorityScheduler::Stats::averageWaitSeconds() const
+{
+    if(0 == count_) {
+        return 0.0;
+    }
+    return static_cast<double>(totalWaitCycles_) * FPlatformTime::GetSecondsPerCycle64() / static_cast<double>(count_);
+}
+
+double UNRX4PriorityScheduler::Stats::maxWaitSeconds() const
+{
+    return static_cast<double>(maxWaitCycles_) * FPlatformTime::GetSecondsPerCycle64();
+}
+
+//-------------------
+UNRX4PriorityScheduler::UNRX4PriorityScheduler()
+    : sequence_(0)
+    , agingCycles_(0)
+    , earliestDeadlineFirst_(false)
+    , stats_{}
+{
+    setAgingPeriod(0.1);
+}
+
+UNRX4PriorityScheduler::~UNRX4PriorityScheduler()
+{
+}
+
+void UNRX4PriorityScheduler::schedule(UNRX4Action action)
+{
+    schedule(std::move(action), UNRX4Priority::Normal);
+}
+
+void UNRX4PriorityScheduler::schedule(UNRX4Action action, UNRX4Priority priority)
+{
+    if(!action) {
+        return;
+    }
+    UNRX4_ASSERT(priority < UNRX4Priority::Num);
+    unrx4::u64 scheduled = FPlatformTime::Cycles64();
+    unrx4::u64 key = scheduled + agingCycles_ * static_cast<unrx4::u64>(priority);
+    push(std::move(action), priority, scheduled, key);
+}
+
+void UNRX4PriorityScheduler::schedule(UNRX4Action action, UNRX4Priority priority, double deadlineSeconds)
+{
+    if(!earliestDeadlineFirst_) {
+        schedule(std::move(action), priority);
+        return;
+    }
+    if(!action) {
+        return;
+    }
+    UNRX4_ASSERT(priority < UNRX4Priority::Num);
+    unrx4::u64 scheduled = FPlatformTime::Cycles64();
+    push(std::move(action), priority, scheduled, scheduled + unrx4_internal_toCycles(deadlineSeconds));
+}
+
+unrx4::u32 UNRX4PriorityScheduler::run(unrx4::u32 maxActions)
+{
+    UNRX4_TRACE_DRAIN("UNRX4PriorityScheduler::run", this, heap_.size());
+    unrx4::u32 count = 0;
+    while(count < maxActions && 0 < heap_.size()) {
+        Entry entry;
+        pop(entry);
+        unrx4::u64 wait = FPlatformTime::Cycles64() - entry.scheduled_;
+        Stats& stats = stats_[static_cast<unrx4::u32>(entry.priority_)];
+        ++stats.count_;
+        stats.totalWaitCycles_ += wait;
+        stats.maxWaitCycles_ = FMath::Max(stats.maxWaitCycles_, wait);
+        UNRX4_TRACE_SCOPE("UNRX4PriorityScheduler::action");
+#if UNRX4_PROFILER_ENABLED
+        UNRX4Profiler::recordLatency(entry.stream_, wait);
+        unrx4::u32 previous = UNRX4Profiler::exchangeCurrentStream(entry.stream_);
+        entry.action_();
+        UNRX4Profiler::exchangeCurrentStream(previous);
+#else
+        entry.action_();
+#endif
+        ++count;
+    }
+    return count;
+}
+
+void UNRX4PriorityScheduler::setEarliestDeadlineFirst(bool enable)
+{
+    earliestDeadlineFirst_ = enable;
+}
+
+bool UNRX4PriorityScheduler::isEarliestDeadlineFirst() const
+{
+    return earliestDeadlineFirst_;
+}
+
+void UNRX4PriorityScheduler::setAgingPeriod(double seconds)
+{
+    agingCycles_ = unrx4_internal_toCycles(seconds);
+}
+
+unrx4::size_t UNRX4PriorityScheduler::size() const
+{
+    return heap_.size();
+}
+
+const UNRX4PriorityScheduler::Stats& UNRX4PriorityScheduler::stats(UNRX4Priority priority) const
+{
+    UNRX4_ASSERT(priority < UNRX4Priority::Num);
+    return stats_[static_cast<unrx4::u32>(priority)];
+}
+
+void UNRX4PriorityScheduler::resetStats()
+{
+    for(Stats& stats: stats_) {
+        stats = {};
+    }
+}
+
+bool UNRX4PriorityScheduler::less(const Entry& x0, const Entry& x1)
+{
+    if(x0.key_ != x1.key_) {
+        return x0.key_ < x1.key_;
+    }
+    return x0.sequence_ < x1.sequence_;
+}
+
+void UNRX4PriorityScheduler::push(UNRX4Action&& action, UNRX4Priority priority, unrx4::u64 scheduled, unrx4::u64 key)
+{
+    Entry entry;
+    entry.key_ = key;
+    entry.sequence_ = sequence_++;
+    entry.scheduled_ = scheduled;
+    entry.priority_ = priority;
+    entry.action_ = std::move(action);
+#if UNRX4_PROFILER_ENABLED
+    entry.stream_ = UNRX4Profiler::currentStream();
+    if(UNRX4Profiler::InvalidStream == entry.stream_) {
+        entry.stream_ = profile_.id();
+    }
+#endif
+    heap_.push_back(std::move(entry));
+    siftUp(heap_.size() - 1);
+}
+
+void UNRX4PriorityScheduler::pop(Entry& entry)
+{
+    UNRX4_ASSERT(0 < heap_.size());
+    entry = std::move(heap_[0]);
+    unrx4::size_t last = heap_.size() - 1;
+    if(0 < last) {
+        heap_[0] = std::move(heap_[last]);
+    }
+    heap_.pop_back();
+    if(0 < heap_.size()) {
+        siftDown(0);
+    }
+}
+
+void UNRX4PriorityScheduler::siftUp(unrx4::size_t index)
+{
+    //Move the entry into the hole at last, parents are shifted down
+    Entry entry = std::move(heap_[index]);
+    while(0 < index) {
+        unrx4::size_t parent = (index - 1) / Arity;
+        if(!less(entry, heap_[parent])) {
+            break;
+        }
+        heap_[index] = std::move(heap_[parent]);
+        index = parent;
+    }
+    heap_[index] = std::move(entry);
+}
+
+void UNRX4PriorityScheduler::siftDown(unrx4::size_t index)
+{
+    unrx4::size_t size = heap_.size();
+    Entry entry = std::move(heap_[index]);
+    for(;;) {
+        unrx4::size_t first = index * Arity + 1;
+        if(size <= first) {
+            break;
+        }
+        //Children are adjacent, so finding the smallest touches a few contiguous cache lines
+        unrx4::size_t end = FMath::Min(first + Arity, size);
+        unrx4::size_t smallest = first;
+        for(unrx4::size_t i = first + 1; i < end; ++i) {
+            if(less(heap_[i], heap_[smallest])) {
+                smallest = i;
+            }
+        }
+        if(!less(heap_[smallest], entry)) {
+            break;
+        }
+        heap_[index] = std::move(heap_[smallest]);
+        index = smallest;
+    }
+    heap_[index] = std::move(entry);
+}
@@ -0,0 +1,123 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4PriorityScheduler.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4IScheduler.h"
+#include "UNRX4Profiler.h"
+
+//-------------------
+enum class UNRX4Priority: unrx4::u8
+{
+    Critical = 0,
+    High,
+    Normal,
+    Low,
+    Cosmetic,
+    Num,
+};
+
+//-------------------
+/**
+ * @brief Scheduler which runs actions in order of virtual deadlines on a 4-ary heap
+ *
+ * The virtual deadline of an action is the time scheduled plus its priority times the aging period,
+ * so a waiting action of a lower priority eventually overtakes newer actions of higher priorities.
+ * In earliest-deadline-first mode, explicit deadlines are used instead.
+ */
+class UNRX4PriorityScheduler: public UNRX4IScheduler
+{
+public:
+    static constexpr unrx4::u32 NumPriorities = static_cast<unrx4::u32>(UNRX4Priority::Num);
+    static constexpr unrx4::size_t Arity = 4;
+
+    /**
+     * @brief Wait times from scheduling to running of a priority
+     */
+    struct Stats
+    {
+        unrx4::u64 count_;
+        unrx4::u64 totalWaitCycles_;
+        unrx4::u64 maxWaitCycles_;
+
+        double averageWaitSeconds() const;
+        double maxWaitSeconds() const;
+    };
+
+    UNRX4PriorityScheduler();
+    virtual ~UNRX4PriorityScheduler();
+
+    /**
+     * @brief Schedule an action with UNRX4Priority::Normal
+     */
+    virtual void schedule(UNRX4Action action) override;
+    void schedule(UNRX4Action action, UNRX4Priority priority);
+
+    /**
+     * @brief Schedule an action, which should run within the seconds in earliest-deadline-first mode
+     */
+    void schedule(UNRX4Action action, UNRX4Priority priority, double deadlineSeconds);
+
+    /**
+     * @brief Run actions until the queue is empty or the count reaches the limit
+     * @return The number of actions which ran
+     */
+    unrx4::u32 run(unrx4::u32 maxActions = 0xFFFFFFFFU);
+
+    void setEarliestDeadlineFirst(bool enable);
+    bool isEarliestDeadlineFirst() const;
+
+    /**
+     * @brief Set how long one priority class is worth
+     */
+    void setAgingPeriod(double seconds);
+
+    unrx4::size_t size() const;
+    const Stats& stats(UNRX4Priority priority) const;
+    void resetStats();
+
+private:
+    UNRX4PriorityScheduler(const UNRX4PriorityScheduler&) = delete;
+    UNRX4PriorityScheduler& operator=(const UNRX4PriorityScheduler&) = delete;
+
+    struct Entry
+    {
+        unrx4::u64 key_;
+        unrx4::u64 sequence_;
+        unrx4::u64 scheduled_;
+        UNRX4Priority priority_;
+        UNRX4Action action_;
+#if UNRX4_PROFILER_ENABLED
+        unrx4::u32 stream_;
+#endif
+    };
+
+    static bool less(const Entry& x0, const Entry& x1);
+
+    void push(UNRX4Action&& action, UNRX4Priority priority, unrx4::u64 scheduled, unrx4::u64 key);
+    void pop(Entry& entry);
+    void siftUp(unrx4::size_t index);
+    void siftDown(unrx4::size_t index);
+
+    UNRX4Array<Entry> heap_;
+    unrx4::u64 sequence_;
+    unrx4::u64 agingCycles_;
+    bool earliestDeadlineFirst_;
+    Stats stats_[NumPriorities];
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4PriorityScheduler");
+};
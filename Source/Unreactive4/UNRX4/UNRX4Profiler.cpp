@@ -0,0 +1,323 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Profiler.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Profiler.h"
+
+#if UNRX4_PROFILER_ENABLED
+#    include <Engine/Engine.h>
+#    include <HAL/IConsoleManager.h>
+#    include <Containers/Ticker.h>
+
+namespace
+{
+    thread_local void* unrx4_internal_threadBlock_ = nullptr;
+    thread_local unrx4::u32 unrx4_internal_currentStream_ = UNRX4Profiler::InvalidStream;
+
+    inline void unrx4_internal_add(std::atomic<unrx4::u64>& counter, unrx4::u64 value)
+    {
+        //Only the owner thread writes, so no read-modify-write is needed
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline unrx4::u64 unrx4_internal_load(const std::atomic<unrx4::u64>& counter)
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    inline double unrx4_internal_toSeconds(unrx4::u64 cycles)
+    {
+        return static_cast<double>(cycles) * FPlatformTime::GetSecondsPerCycle64();
+    }
+} // namespace
+
+//-------------------
+double UNRX4ProfileSnapshot::latencyPercentile(double percentile) const
+{
+    if(0 == latencyCount_) {
+        return 0.0;
+    }
+    unrx4::u64 threshold = static_cast<unrx4::u64>(percentile * static_cast<double>(latencyCount_));
+    unrx4::u64 count = 0;
+    for(unrx4::u32 i = 0; i < HistogramBuckets; ++i) {
+        count += latency_[i];
+        if(threshold < count) {
+            return unrx4_internal_toSeconds(1ULL << (i + 1));
+        }
+    }
+    return unrx4_internal_toSeconds(1ULL << HistogramBuckets);
+}
+
+//-------------------
+UNRX4Profiler& UNRX4Profiler::getInstance()
+{
+    //Streams might be registered while static initialization
+    static UNRX4Profiler instance;
+    return instance;
+}
+
+UNRX4Profiler::UNRX4Profiler()
+    : threadBlocks_(nullptr)
+    , streams_{}
+    , generations_{}
+    , numFreeStreams_(MaxStreams)
+{
+    for(unrx4::u32 i = 0; i < MaxStreams; ++i) {
+        freeStreams_[i] = MaxStreams - i - 1;
+    }
+}
+
+UNRX4Profiler::~UNRX4Profiler()
+{
+    ThreadBlock* block = threadBlocks_;
+    while(nullptr != block) {
+        ThreadBlock* next = block->next_;
+        for(std::atomic<Counter*>& page: block->pages_) {
+            FMemory::Free(page.load(std::memory_order_relaxed));
+        }
+        FMemory::Free(block);
+        block = next;
+    }
+    threadBlocks_ = nullptr;
+}
+
+unrx4::u32 UNRX4Profiler::registerStream(const TCHAR* name, const void* object)
+{
+    FScopeLock lock(&lock_);
+    if(numFreeStreams_ <= 0) {
+        return InvalidStream;
+    }
+    --numFreeStreams_;
+    unrx4::u32 id = freeStreams_[numFreeStreams_];
+    streams_[id].name_ = name;
+    streams_[id].object_ = object;
+    streams_[id].lastEvents_ = 0;
+    streams_[id].lastCycles_ = FPlatformTime::Cycles64();
+    //Counters of other threads are not touched here, they are reset by their owners
+    generations_[id].fetch_add(1, std::memory_order_release);
+    return id;
+}
+
+void UNRX4Profiler::unregisterStream(unrx4::u32 id)
+{
+    if(InvalidStream == id) {
+        return;
+    }
+    FScopeLock lock(&lock_);
+    UNRX4_ASSERT(id < MaxStreams);
+    UNRX4_ASSERT(nullptr != streams_[id].name_);
+    streams_[id].name_ = nullptr;
+    freeStreams_[numFreeStreams_] = id;
+    ++numFreeStreams_;
+}
+
+void UNRX4Profiler::recordDispatch(unrx4::u32 id, unrx4::u32 subscribers, unrx4::u64 cycles)
+{
+    if(InvalidStream == id) {
+        return;
+    }
+    Counter& counter = getCounter(id);
+    unrx4_internal_add(counter.events_, 1);
+    unrx4_internal_add(counter.dispatchCycles_, cycles);
+    counter.subscribers_.store(subscribers, std::memory_order_relaxed);
+}
+
+void UNRX4Profiler::recordLatency(unrx4::u32 id, unrx4::u64 cycles)
+{
+    if(InvalidStream == id) {
+        return;
+    }
+    unrx4::u32 bucket = FPlatformMath::FloorLog2_64(cycles | 1ULL);
+    if(HistogramBuckets <= bucket) {
+        bucket = HistogramBuckets - 1;
+    }
+    unrx4_internal_add(getCounter(id).latency_[bucket], 1);
+}
+
+unrx4::u32 UNRX4Profiler::currentStream()
+{
+    return unrx4_internal_currentStream_;
+}
+
+unrx4::u32 UNRX4Profiler::exchangeCurrentStream(unrx4::u32 id)
+{
+    unrx4::u32 previous = unrx4_internal_currentStream_;
+    unrx4_internal_currentStream_ = id;
+    return previous;
+}
+
+void UNRX4Profiler::collect(TArray<UNRX4ProfileSnapshot>& snapshots)
+{
+    snapshots.Reset();
+    unrx4::u64 now = FPlatformTime::Cycles64();
+    FScopeLock lock(&lock_);
+    for(unrx4::u32 id = 0; id < MaxStreams; ++id) {
+        Stream& stream = streams_[id];
+        if(nullptr == stream.name_) {
+            continue;
+        }
+        UNRX4ProfileSnapshot& snapshot = snapshots.AddZeroed_GetRef();
+        snapshot.name_ = stream.name_;
+        snapshot.object_ = stream.object_;
+        snapshot.id_ = id;
+        unrx4::u32 generation = generations_[id].load(std::memory_order_relaxed);
+        unrx4::u32 page = id / StreamsPerPage;
+        unrx4::u32 index = id % StreamsPerPage;
+        for(ThreadBlock* block = threadBlocks_; nullptr != block; block = block->next_) {
+            Counter* counters = block->pages_[page].load(std::memory_order_acquire);
+            if(nullptr == counters) {
+                continue;
+            }
+            const Counter& counter = counters[index];
+            if(generation != counter.generation_.load(std::memory_order_acquire)) {
+                continue;
+            }
+            snapshot.events_ += unrx4_internal_load(counter.events_);
+            snapshot.dispatchCycles_ += unrx4_internal_load(counter.dispatchCycles_);
+            snapshot.subscribers_ = FMath::Max(snapshot.subscribers_, static_cast<unrx4::u32>(unrx4_internal_load(counter.subscribers_)));
+            for(unrx4::u32 i = 0; i < HistogramBuckets; ++i) {
+                unrx4::u64 latency = unrx4_internal_load(counter.latency_[i]);
+                snapshot.latency_[i] += latency;
+                snapshot.latencyCount_ += latency;
+            }
+        }
+        double duration = unrx4_internal_toSeconds(now - stream.lastCycles_);
+        snapshot.rate_ = (0.0 < duration) ? static_cast<double>(snapshot.events_ - stream.lastEvents_) / duration : 0.0;
+        stream.lastEvents_ = snapshot.events_;
+        stream.lastCycles_ = now;
+    }
+}
+
+void UNRX4Profiler::dump(unrx4::u32 count)
+{
+    TArray<UNRX4ProfileSnapshot> snapshots;
+    collect(snapshots);
+    snapshots.Sort([](const UNRX4ProfileSnapshot& x0, const UNRX4ProfileSnapshot& x1) {
+        return x1.dispatchCycles_ < x0.dispatchCycles_;
+    });
+    UE_LOG(LogTemp, Log, TEXT("UNRX4 streams: %d live, top %u by dispatch time"), snapshots.Num(), count);
+    UE_LOG(LogTemp, Log, TEXT("%-32s %6s %18s %8s %12s %10s %10s %10s %10s"), TEXT("name"), TEXT("id"), TEXT("object"), TEXT("subs"), TEXT("events"), TEXT("rate/s"), TEXT("total ms"), TEXT("p50 us"), TEXT("p99 us"));
+    unrx4::u32 num = FMath::Min(count, static_cast<unrx4::u32>(snapshots.Num()));
+    for(unrx4::u32 i = 0; i < num; ++i) {
+        const UNRX4ProfileSnapshot& snapshot = snapshots[i];
+        UE_LOG(LogTemp, Log, TEXT("%-32s %6u %18p %8u %12llu %10.1f %10.3f %10.1f %10.1f"),
+               snapshot.name_,
+               snapshot.id_,
+               snapshot.object_,
+               snapshot.subscribers_,
+               snapshot.events_,
+               snapshot.rate_,
+               unrx4_internal_toSeconds(snapshot.dispatchCycles_) * 1000.0,
+               snapshot.latencyPercentile(0.5) * 1000000.0,
+               snapshot.latencyPercentile(0.99) * 1000000.0);
+    }
+}
+
+UNRX4Profiler::Counter& UNRX4Profiler::getCounter(unrx4::u32 id)
+{
+    UNRX4_ASSERT(id < MaxStreams);
+    ThreadBlock* block = reinterpret_cast<ThreadBlock*>(unrx4_internal_threadBlock_);
+    if(nullptr == block) {
+        block = getInstance().createThreadBlock();
+        unrx4_internal_threadBlock_ = block;
+    }
+    unrx4::u32 page = id / StreamsPerPage;
+    Counter* counters = block->pages_[page].load(std::memory_order_relaxed);
+    if(nullptr == counters) {
+        counters = reinterpret_cast<Counter*>(FMemory::MallocZeroed(sizeof(Counter) * StreamsPerPage));
+        block->pages_[page].store(counters, std::memory_order_release);
+    }
+    Counter& counter = counters[id % StreamsPerPage];
+    unrx4::u32 generation = getInstance().generations_[id].load(std::memory_order_acquire);
+    if(generation != counter.generation_.load(std::memory_order_relaxed)) {
+        //Reset before publishing the generation, then collect never sums counts of the previous stream
+        counter.events_.store(0, std::memory_order_relaxed);
+        counter.dispatchCycles_.store(0, std::memory_order_relaxed);
+        counter.subscribers_.store(0, std::memory_order_relaxed);
+        for(std::atomic<unrx4::u64>& latency: counter.latency_) {
+            latency.store(0, std::memory_order_relaxed);
+        }
+        counter.generation_.store(generation, std::memory_order_release);
+    }
+    return counter;
+}
+
+UNRX4Profiler::ThreadBlock* UNRX4Profiler::createThreadBlock()
+{
+    ThreadBlock* block = reinterpret_cast<ThreadBlock*>(FMemory::MallocZeroed(sizeof(ThreadBlock)));
+    FScopeLock lock(&lock_);
+    block->next_ = threadBlocks_;
+    threadBlocks_ = block;
+    return block;
+}
+
+//-------------------
+namespace
+{
+    FDelegateHandle unrx4_internal_overlayHandle_;
+
+    bool unrx4_internal_drawOverlay(float /*deltaTime*/)
+    {
+        if(nullptr == GEngine) {
+            return true;
+        }
+        TArray<UNRX4ProfileSnapshot> snapshots;
+        UNRX4Profiler::getInstance().collect(snapshots);
+        snapshots.Sort([](const UNRX4ProfileSnapshot& x0, const UNRX4ProfileSnapshot& x1) {
+            return x1.dispatchCycles_ < x0.dispatchCycles_;
+        });
+        int32 num = FMath::Min(snapshots.Num(), 16);
+        for(int32 i = 0; i < num; ++i) {
+            const UNRX4ProfileSnapshot& snapshot = snapshots[i];
+            GEngine->AddOnScreenDebugMessage(
+                static_cast<uint64>(0x554E5258U) + i, 0.3f, FColor::Cyan,
+                FString::Printf(TEXT("%s#%u %p subs:%u rate:%.1f/s total:%.3fms p99:%.1fus"),
+                                snapshot.name_,
+                                snapshot.id_,
+                                snapshot.object_,
+                                snapshot.subscribers_,
+                                snapshot.rate_,
+                                unrx4_internal_toSeconds(snapshot.dispatchCycles_) * 1000.0,
+                                snapshot.latencyPercentile(0.99) * 1000000.0));
+        }
+        return true;
+    }
+
+    FAutoConsoleCommand unrx4_internal_dumpCommand_(
+        TEXT("unrx4.Profiler.Dump"),
+        TEXT("Dump the hottest reactive streams. unrx4.Profiler.Dump [count=16]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+            unrx4::u32 count = 16;
+            if(0 < args.Num()) {
+                count = static_cast<unrx4::u32>(FMath::Max(FCString::Atoi(*args[0]), 1));
+            }
+            UNRX4Profiler::getInstance().dump(count);
+        }));
+
+    FAutoConsoleCommand unrx4_internal_overlayCommand_(
+        TEXT("unrx4.Profiler.Overlay"),
+        TEXT("Toggle the on-screen overlay of the hottest reactive streams"),
+        FConsoleCommandDelegate::CreateLambda([]() {
+            if(unrx4_internal_overlayHandle_.IsValid()) {
+                FTicker::GetCoreTicker().RemoveTicker(unrx4_internal_overlayHandle_);
+                unrx4_internal_overlayHandle_.Reset();
+            } else {
+                unrx4_internal_overlayHandle_ = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(unrx4_internal_drawOverlay), 0.25f);
+            }
+        }));
+} // namespace
+#endif
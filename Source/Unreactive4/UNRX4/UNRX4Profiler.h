@@ -0,0 +1,218 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Profiler.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4.h"
+
+/**
+ * @brief Set UNRX4_PROFILER_ENABLED to 0 to strip the live stream profiler
+ */
+#ifndef UNRX4_PROFILER_ENABLED
+#    if !UE_BUILD_SHIPPING
+#        define UNRX4_PROFILER_ENABLED 1
+#    else
+#        define UNRX4_PROFILER_ENABLED 0
+#    endif
+#endif
+
+#if UNRX4_PROFILER_ENABLED
+#    include <atomic>
+
+//-------------------
+/**
+ * @brief Aggregated statistics of a stream at a moment
+ */
+struct UNRX4ProfileSnapshot
+{
+    static constexpr unrx4::u32 HistogramBuckets = 32;
+
+    const TCHAR* name_;
+    const void* object_; //!< the object which owns the stream, streams of the same type are told apart by it
+    unrx4::u32 id_;
+    unrx4::u32 subscribers_;
+    unrx4::u64 events_;
+    unrx4::u64 dispatchCycles_;
+    double rate_; //!< events per second since the previous collection
+    unrx4::u64 latencyCount_;
+    unrx4::u64 latency_[HistogramBuckets]; //!< bucket i counts latencies in [2^i, 2^(i+1)) cycles
+
+    /**
+     * @brief Estimate a latency percentile in seconds from the histogram
+     * @param percentile ... [0 1]
+     */
+    double latencyPercentile(double percentile) const;
+};
+
+//-------------------
+/**
+ * @brief Registry of live streams, which keeps event rates, dispatch times and latency histograms
+ *
+ * Every thread writes into its own counters without any synchronization,
+ * and the counters are aggregated only when someone collects them.
+ * An id is reused with a new generation, then each thread resets its own counters when it sees the new one,
+ * and counters of older generations are skipped when aggregating.
+ */
+UNREACTIVE4_API
+class UNRX4Profiler
+{
+public:
+    static constexpr unrx4::u32 MaxStreams = 1024;
+    static constexpr unrx4::u32 StreamsPerPage = 64;
+    static constexpr unrx4::u32 HistogramBuckets = UNRX4ProfileSnapshot::HistogramBuckets;
+    static constexpr unrx4::u32 InvalidStream = 0xFFFFFFFFU;
+
+    static UNRX4Profiler& getInstance();
+
+    /**
+     * @brief Register a stream
+     * @param name ... A static string, which should live longer than the stream
+     * @param object ... The object which owns the stream, only for reports
+     * @return InvalidStream if no more stream can be registered
+     */
+    unrx4::u32 registerStream(const TCHAR* name, const void* object = nullptr);
+    void unregisterStream(unrx4::u32 id);
+
+    static void recordDispatch(unrx4::u32 id, unrx4::u32 subscribers, unrx4::u64 cycles);
+    static void recordLatency(unrx4::u32 id, unrx4::u64 cycles);
+
+    /**
+     * @brief The stream which is dispatching on this thread
+     */
+    static unrx4::u32 currentStream();
+    static unrx4::u32 exchangeCurrentStream(unrx4::u32 id);
+
+    /**
+     * @brief Aggregate counters of all threads
+     */
+    void collect(TArray<UNRX4ProfileSnapshot>& snapshots);
+
+    /**
+     * @brief Log the hottest streams sorted by cumulative dispatch time
+     */
+    void dump(unrx4::u32 count);
+
+private:
+    UNRX4Profiler(const UNRX4Profiler&) = delete;
+    UNRX4Profiler& operator=(const UNRX4Profiler&) = delete;
+
+    struct Counter
+    {
+        std::atomic<unrx4::u32> generation_;
+        std::atomic<unrx4::u64> events_;
+        std::atomic<unrx4::u64> dispatchCycles_;
+        std::atomic<unrx4::u64> subscribers_;
+        std::atomic<unrx4::u64> latency_[HistogramBuckets];
+    };
+
+    struct ThreadBlock
+    {
+        ThreadBlock* next_;
+        std::atomic<Counter*> pages_[MaxStreams / StreamsPerPage];
+    };
+
+    struct Stream
+    {
+        const TCHAR* name_;
+        const void* object_;
+        unrx4::u64 lastEvents_;
+        unrx4::u64 lastCycles_;
+    };
+
+    UNRX4Profiler();
+    ~UNRX4Profiler();
+
+    static Counter& getCounter(unrx4::u32 id);
+    ThreadBlock* createThreadBlock();
+
+    FCriticalSection lock_;
+    ThreadBlock* threadBlocks_;
+    Stream streams_[MaxStreams];
+    std::atomic<unrx4::u32> generations_[MaxStreams];
+    unrx4::u32 freeStreams_[MaxStreams];
+    unrx4::u32 numFreeStreams_;
+};
+
+//-------------------
+/**
+ * @brief Register a stream while this is alive
+ */
+class UNRX4ProfileStream
+{
+public:
+    explicit UNRX4ProfileStream(const TCHAR* name, const void* object = nullptr)
+        : id_(UNRX4Profiler::getInstance().registerStream(name, object))
+    {
+    }
+
+    ~UNRX4ProfileStream()
+    {
+        UNRX4Profiler::getInstance().unregisterStream(id_);
+    }
+
+    unrx4::u32 id() const
+    {
+        return id_;
+    }
+
+private:
+    UNRX4ProfileStream(const UNRX4ProfileStream&) = delete;
+    UNRX4ProfileStream& operator=(const UNRX4ProfileStream&) = delete;
+
+    unrx4::u32 id_;
+};
+
+/**
+ * @brief Measure a dispatch, and make the stream current while dispatching
+ */
+class UNRX4ProfileDispatchScope
+{
+public:
+    UNRX4ProfileDispatchScope(const UNRX4ProfileStream& stream, unrx4::size_t subscribers)
+        : id_(stream.id())
+        , subscribers_(static_cast<unrx4::u32>(subscribers))
+        , previous_(UNRX4Profiler::exchangeCurrentStream(stream.id()))
+        , start_(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~UNRX4ProfileDispatchScope()
+    {
+        UNRX4Profiler::recordDispatch(id_, subscribers_, FPlatformTime::Cycles64() - start_);
+        UNRX4Profiler::exchangeCurrentStream(previous_);
+    }
+
+private:
+    UNRX4ProfileDispatchScope(const UNRX4ProfileDispatchScope&) = delete;
+    UNRX4ProfileDispatchScope& operator=(const UNRX4ProfileDispatchScope&) = delete;
+
+    unrx4::u32 id_;
+    unrx4::u32 subscribers_;
+    unrx4::u32 previous_;
+    unrx4::u64 start_;
+};
+
+//this in a default member initializer is the owner of the member
+#    define UNRX4_PROFILE_STREAM(Member, NameStr) UNRX4ProfileStream Member{TEXT(NameStr), this}
+#    define UNRX4_PROFILE_DISPATCH(Stream, Subscribers) UNRX4ProfileDispatchScope unrx4_internal_profileScope_((Stream), (Subscribers))
+
+#else
+
+#    define UNRX4_PROFILE_STREAM(Member, NameStr)
+#    define UNRX4_PROFILE_DISPATCH(Stream, Subscribers)
+
+#endif
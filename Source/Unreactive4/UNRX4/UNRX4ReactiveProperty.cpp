@@ -0,0 +1,115 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ReactiveProperty.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4ReactiveProperty.h"
+#include "UNRX4ObjectSubscription.h"
+#include "UNRX4System.h"
+#include "UNRX4Trace.h"
+
+//-------------------
+UNRX4ReactivePropertyBase::UNRX4ReactivePropertyBase()
+    : dirty_(false)
+{
+}
+
+UNRX4ReactivePropertyBase::~UNRX4ReactivePropertyBase()
+{
+}
+
+bool UNRX4ReactivePropertyBase::isDirty() const
+{
+    return dirty_;
+}
+
+void UNRX4ReactivePropertyBase::markDirty()
+{
+    if(dirty_) {
+        return;
+    }
+    dirty_ = true;
+    UNRX4System::getInstance().reactiveProperties().add(this);
+}
+
+void UNRX4ReactivePropertyBase::detach(const void* observable)
+{
+    UNRX4System& system = UNRX4System::getInstance();
+    if(dirty_) {
+        system.reactiveProperties().remove(this);
+        dirty_ = false;
+    }
+    system.objectSubscriptions().forget(observable);
+}
+
+//-------------------
+UNRX4ReactiveProperties::UNRX4ReactiveProperties()
+{
+}
+
+UNRX4ReactiveProperties::~UNRX4ReactiveProperties()
+{
+    clear();
+}
+
+void UNRX4ReactiveProperties::add(UNRX4ReactivePropertyBase* property)
+{
+    dirty_.push_back(property);
+}
+
+void UNRX4ReactiveProperties::remove(UNRX4ReactivePropertyBase* property)
+{
+    dirty_.remove(property);
+    //A property can be destroyed by an observer of another property while flushing
+    for(unrx4::size_t i = 0; i < flushing_.size(); ++i) {
+        if(property == flushing_[i]) {
+            flushing_[i] = nullptr;
+        }
+    }
+}
+
+unrx4::size_t UNRX4ReactiveProperties::flush()
+{
+    UNRX4_TRACE_SCOPE("UNRX4ReactiveProperties::flush");
+    //The buffers are swapped to keep their capacities, the flushing one has been cleared
+    std::swap(dirty_, flushing_);
+    unrx4::size_t size = flushing_.size();
+    for(unrx4::size_t i = 0; i < flushing_.size(); ++i) {
+        UNRX4ReactivePropertyBase* property = flushing_[i];
+        if(nullptr == property) {
+            continue;
+        }
+        property->dirty_ = false;
+        property->flush();
+    }
+    flushing_.clear();
+    return size;
+}
+
+void UNRX4ReactiveProperties::clear()
+{
+    for(unrx4::size_t i = 0; i < dirty_.size(); ++i) {
+        dirty_[i]->dirty_ = false;
+    }
+    dirty_.clear();
+    dirty_.shrink_to_fit();
+    flushing_.shrink_to_fit();
+}
+
+unrx4::size_t UNRX4ReactiveProperties::size() const
+{
+    return dirty_.size();
+}
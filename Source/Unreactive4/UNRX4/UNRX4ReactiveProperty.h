@@ -0,0 +1,240 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ReactiveProperty.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4Distinct.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+
+//-------------------
+/**
+ * @brief Type erased part of reactive properties, which the end of frame flush calls
+ */
+UNREACTIVE4_API
+class UNRX4ReactivePropertyBase
+{
+public:
+    bool isDirty() const;
+
+protected:
+    friend class UNRX4ReactiveProperties;
+
+    UNRX4ReactivePropertyBase();
+    virtual ~UNRX4ReactivePropertyBase();
+
+    /**
+     * @brief Queue this property to the next flush, once per frame
+     */
+    void markDirty();
+
+    /**
+     * @brief Leave the queue and drop subscriptions bound to objects, derived classes call this at destruction
+     * @param observable ... This property as the observable, which subscriptions are keyed by
+     */
+    void detach(const void* observable);
+
+    /**
+     * @brief Emit the value if it has changed since the last emission
+     */
+    virtual void flush() = 0;
+
+    bool dirty_;
+
+private:
+    UNRX4ReactivePropertyBase(const UNRX4ReactivePropertyBase&) = delete;
+    UNRX4ReactivePropertyBase& operator=(const UNRX4ReactivePropertyBase&) = delete;
+};
+
+//-------------------
+/**
+ * @brief Dirty reactive properties, flushed at once from UNRX4System::endFrame
+ *
+ * Properties should be written and flushed on the game thread.
+ */
+UNREACTIVE4_API
+class UNRX4ReactiveProperties
+{
+public:
+    UNRX4ReactiveProperties();
+    ~UNRX4ReactiveProperties();
+
+    void add(UNRX4ReactivePropertyBase* property);
+    void remove(UNRX4ReactivePropertyBase* property);
+
+    /**
+     * @brief Flush dirty properties, properties written while flushing are flushed in the next frame
+     * @return The number of flushed properties
+     */
+    unrx4::size_t flush();
+
+    /**
+     * @brief Forget dirty properties without flushing
+     */
+    void clear();
+
+    unrx4::size_t size() const;
+
+private:
+    UNRX4ReactiveProperties(const UNRX4ReactiveProperties&) = delete;
+    UNRX4ReactiveProperties& operator=(const UNRX4ReactiveProperties&) = delete;
+
+    UNRX4Array<UNRX4ReactivePropertyBase*> dirty_;
+    UNRX4Array<UNRX4ReactivePropertyBase*> flushing_;
+};
+
+//-------------------
+/**
+ * @brief A value which emits its changes once per frame
+ *
+ * Any number of writes in a frame are coalesced, and observers receive the last value at the end of the frame,
+ * only if it is not equal to the value emitted last.
+ */
+template<class T, class Equal = UNRX4EqualTo<T>>
+class UNRX4ReactiveProperty: public UNRX4IObservable<T>, public UNRX4ReactivePropertyBase
+{
+public:
+    using observer_type = UNRX4IObserver<T>;
+
+    explicit UNRX4ReactiveProperty(const T& value = T(), Equal equal = Equal());
+    virtual ~UNRX4ReactiveProperty();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+
+    /**
+     * @brief Same as set
+     */
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief The last written value, which may not have been emitted yet
+     */
+    const T& get() const;
+
+    /**
+     * @brief Write a value, which is emitted at the end of the frame
+     */
+    void set(T value);
+
+    unrx4::size_t numObservers() const;
+
+private:
+    virtual void flush() override;
+
+    UNRX4Array<observer_type*> observers_;
+    T value_;
+    T emitted_;
+    Equal equal_;
+};
+
+template<class T, class Equal>
+UNRX4ReactiveProperty<T, Equal>::UNRX4ReactiveProperty(const T& value, Equal equal)
+    : value_(value)
+    , emitted_(value)
+    , equal_(std::move(equal))
+{
+}
+
+template<class T, class Equal>
+UNRX4ReactiveProperty<T, Equal>::~UNRX4ReactiveProperty()
+{
+    detach(static_cast<UNRX4IObservable<T>*>(this));
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::subscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.push_back(observer);
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.remove(observer);
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::next(T value)
+{
+    set(std::move(value));
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::error(unrx4::error_code_type errorCode)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::completed()
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T, class Equal>
+const T& UNRX4ReactiveProperty<T, Equal>::get() const
+{
+    return value_;
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::set(T value)
+{
+    value_ = std::move(value);
+    markDirty();
+}
+
+template<class T, class Equal>
+unrx4::size_t UNRX4ReactiveProperty<T, Equal>::numObservers() const
+{
+    return observers_.size();
+}
+
+template<class T, class Equal>
+void UNRX4ReactiveProperty<T, Equal>::flush()
+{
+    //Writes which return to the emitted value are not changes
+    if(equal_(value_, emitted_)) {
+        return;
+    }
+    emitted_ = value_;
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(emitted_);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
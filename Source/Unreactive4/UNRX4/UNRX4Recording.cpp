@@ -0,0 +1,205 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Recording.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Recording.h"
+#include <Async/Async.h>
+#include <Async/MappedFileHandle.h>
+#include <HAL/PlatformFilemanager.h>
+
+//-------------------
+UNRX4LogWriter::UNRX4LogWriter()
+    : file_(nullptr)
+    , current_(0)
+    , used_(0)
+    , size_(0)
+{
+}
+
+UNRX4LogWriter::~UNRX4LogWriter()
+{
+    close();
+}
+
+bool UNRX4LogWriter::open(const TCHAR* path, const UNRX4LogHeader& header, unrx4::size_t bufferSize)
+{
+    close();
+    file_ = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(path);
+    if(nullptr == file_) {
+        return false;
+    }
+    bufferSize = FMath::Max(bufferSize, sizeof(UNRX4LogHeader));
+    for(TArray<uint8>& buffer: buffers_) {
+        buffer.SetNumUninitialized(static_cast<int32>(bufferSize));
+    }
+    current_ = 0;
+    used_ = 0;
+    size_ = 0;
+    append(&header, sizeof(header));
+    return true;
+}
+
+void UNRX4LogWriter::append(const void* data, unrx4::size_t size)
+{
+    if(nullptr == file_) {
+        return;
+    }
+    UNRX4_ASSERT(size <= static_cast<unrx4::size_t>(buffers_[current_].Num()));
+    if(static_cast<unrx4::size_t>(buffers_[current_].Num()) < (used_ + size)) {
+        flush();
+    }
+    FMemory::Memcpy(buffers_[current_].GetData() + used_, data, size);
+    used_ += size;
+    size_ += size;
+}
+
+void UNRX4LogWriter::flush()
+{
+    if(nullptr == file_ || used_ <= 0) {
+        return;
+    }
+    //The other buffer is free again after the previous write
+    wait();
+    IFileHandle* file = file_;
+    const uint8* data = buffers_[current_].GetData();
+    int64 size = static_cast<int64>(used_);
+    pending_ = Async(EAsyncExecution::ThreadPool, [file, data, size]() {
+        file->Write(data, size);
+    });
+    current_ ^= 1;
+    used_ = 0;
+}
+
+void UNRX4LogWriter::close()
+{
+    if(nullptr == file_) {
+        return;
+    }
+    flush();
+    wait();
+    file_->Flush();
+    delete file_;
+    file_ = nullptr;
+    for(TArray<uint8>& buffer: buffers_) {
+        buffer.Empty();
+    }
+}
+
+bool UNRX4LogWriter::isOpen() const
+{
+    return nullptr != file_;
+}
+
+unrx4::u64 UNRX4LogWriter::size() const
+{
+    return size_;
+}
+
+void UNRX4LogWriter::wait()
+{
+    if(pending_.IsValid()) {
+        pending_.Wait();
+        pending_.Reset();
+    }
+}
+
+//-------------------
+UNRX4LogReader::UNRX4LogReader()
+    : handle_(nullptr)
+    , region_(nullptr)
+    , data_(nullptr)
+    , header_{}
+    , size_(0)
+{
+}
+
+UNRX4LogReader::~UNRX4LogReader()
+{
+    close();
+}
+
+bool UNRX4LogReader::open(const TCHAR* path, unrx4::u64 type, unrx4::u32 recordSize)
+{
+    close();
+    handle_ = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(path);
+    if(nullptr == handle_) {
+        return false;
+    }
+    int64 fileSize = handle_->GetFileSize();
+    if(fileSize < static_cast<int64>(sizeof(UNRX4LogHeader))) {
+        close();
+        return false;
+    }
+    region_ = handle_->MapRegion(0, fileSize);
+    if(nullptr == region_) {
+        close();
+        return false;
+    }
+    data_ = region_->GetMappedPtr();
+    FMemory::Memcpy(&header_, data_, sizeof(UNRX4LogHeader));
+    if(UNRX4LogHeader::Magic != header_.magic_ || UNRX4LogHeader::Version != header_.version_ || type != header_.type_ || recordSize != header_.recordSize_) {
+        UE_LOG(LogTemp, Warning, TEXT("UNRX4LogReader: %s is not a log of the type"), path);
+        close();
+        return false;
+    }
+    size_ = static_cast<unrx4::size_t>(region_->GetMappedSize() - sizeof(UNRX4LogHeader)) / recordSize;
+    return true;
+}
+
+void UNRX4LogReader::close()
+{
+    delete region_;
+    region_ = nullptr;
+    delete handle_;
+    handle_ = nullptr;
+    data_ = nullptr;
+    header_ = {};
+    size_ = 0;
+}
+
+bool UNRX4LogReader::isOpen() const
+{
+    return nullptr != data_;
+}
+
+const UNRX4LogHeader& UNRX4LogReader::header() const
+{
+    return header_;
+}
+
+unrx4::size_t UNRX4LogReader::size() const
+{
+    return size_;
+}
+
+unrx4::s64 UNRX4LogReader::elapsedTicks(unrx4::size_t index) const
+{
+    unrx4::s64 ticks;
+    FMemory::Memcpy(&ticks, record(index), sizeof(ticks));
+    return ticks;
+}
+
+const unrx4::u8* UNRX4LogReader::payload(unrx4::size_t index) const
+{
+    return record(index) + sizeof(unrx4::s64);
+}
+
+const unrx4::u8* UNRX4LogReader::record(unrx4::size_t index) const
+{
+    UNRX4_ASSERT(index < size_);
+    return data_ + sizeof(UNRX4LogHeader) + index * header_.recordSize_;
+}
@@ -0,0 +1,481 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Recording.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <Async/Future.h>
+#include "UNRX4Operator.h"
+#include "UNRX4VirtualTimeScheduler.h"
+#include <type_traits>
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+//-------------------
+/**
+ * @brief Header of a binary log, followed by fixed size records of a timestamp and a payload
+ */
+struct UNRX4LogHeader
+{
+    static constexpr unrx4::u32 Magic = 0x58524E55U; //UNRX
+    static constexpr unrx4::u32 Version = 1;
+
+    unrx4::u32 magic_;
+    unrx4::u32 version_;
+    unrx4::u32 recordSize_;
+    unrx4::u32 payloadSize_;
+    unrx4::u64 type_;
+    unrx4::s64 startTicks_; //!< UTC ticks when recording started
+};
+
+namespace unrx4
+{
+namespace recording
+{
+    /**
+     * @brief Elapsed ticks followed by a payload, padded to 8 bytes
+     */
+    template<class T>
+    constexpr unrx4::u32 recordSize()
+    {
+        return static_cast<unrx4::u32>(sizeof(unrx4::s64) + ((sizeof(T) + 7) & ~static_cast<unrx4::size_t>(7)));
+    }
+
+    template<class T>
+    UNRX4LogHeader header(unrx4::u64 type, unrx4::s64 startTicks)
+    {
+        UNRX4LogHeader header;
+        header.magic_ = UNRX4LogHeader::Magic;
+        header.version_ = UNRX4LogHeader::Version;
+        header.recordSize_ = recordSize<T>();
+        header.payloadSize_ = static_cast<unrx4::u32>(sizeof(T));
+        header.type_ = type;
+        header.startTicks_ = startTicks;
+        return header;
+    }
+} // namespace recording
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Append-only file writer, which fills a buffer in memory and writes full buffers on a worker thread
+ *
+ * Appending only copies into the buffer, there are no system calls per record.
+ * While a buffer is written, the other one is filled, then an append waits only if both are full.
+ */
+UNREACTIVE4_API
+class UNRX4LogWriter
+{
+public:
+    static constexpr unrx4::size_t DefaultBufferSize = 256 * 1024;
+
+    UNRX4LogWriter();
+    ~UNRX4LogWriter();
+
+    bool open(const TCHAR* path, const UNRX4LogHeader& header, unrx4::size_t bufferSize = DefaultBufferSize);
+
+    /**
+     * @brief Copy bytes into the buffer, the size should not exceed the buffer size
+     */
+    void append(const void* data, unrx4::size_t size);
+
+    /**
+     * @brief Hand the filled part of the buffer to the worker thread
+     */
+    void flush();
+
+    /**
+     * @brief Flush, wait for writes, and close the file
+     */
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * @brief The number of bytes appended, including the header
+     */
+    unrx4::u64 size() const;
+
+private:
+    UNRX4LogWriter(const UNRX4LogWriter&) = delete;
+    UNRX4LogWriter& operator=(const UNRX4LogWriter&) = delete;
+
+    void wait();
+
+    IFileHandle* file_;
+    TArray<uint8> buffers_[2];
+    unrx4::s32 current_;
+    unrx4::size_t used_;
+    unrx4::u64 size_;
+    TFuture<void> pending_;
+};
+
+//-------------------
+/**
+ * @brief Read-only view of a binary log mapped into memory
+ */
+UNREACTIVE4_API
+class UNRX4LogReader
+{
+public:
+    UNRX4LogReader();
+    ~UNRX4LogReader();
+
+    /**
+     * @brief Map a log, and check that it has been recorded for the type
+     */
+    bool open(const TCHAR* path, unrx4::u64 type, unrx4::u32 recordSize);
+    void close();
+    bool isOpen() const;
+
+    const UNRX4LogHeader& header() const;
+
+    /**
+     * @brief The number of complete records, a partial record at the end is ignored
+     */
+    unrx4::size_t size() const;
+    unrx4::s64 elapsedTicks(unrx4::size_t index) const;
+    const unrx4::u8* payload(unrx4::size_t index) const;
+
+private:
+    UNRX4LogReader(const UNRX4LogReader&) = delete;
+    UNRX4LogReader& operator=(const UNRX4LogReader&) = delete;
+
+    const unrx4::u8* record(unrx4::size_t index) const;
+
+    IMappedFileHandle* handle_;
+    IMappedFileRegion* region_;
+    const unrx4::u8* data_;
+    UNRX4LogHeader header_;
+    unrx4::size_t size_;
+};
+
+//-------------------
+/**
+ * @brief Tee values into a binary log, then emit them downstream unchanged
+ *
+ * The log is closed when the source completes or the recorder is destroyed.
+ */
+template<class T>
+class UNRX4Recorder: public UNRX4Operator<UNRX4Recorder<T>, T>
+{
+    using base_type = UNRX4Operator<UNRX4Recorder<T>, T>;
+    friend base_type;
+    static_assert(std::is_trivially_copyable<T>::value, "Recorded values should be trivially copyable.");
+
+public:
+    UNRX4Recorder(UNRX4IObservable<T>* source, const TCHAR* path, unrx4::u64 type, unrx4::size_t bufferSize);
+    virtual ~UNRX4Recorder();
+
+    bool isRecording() const;
+    unrx4::u64 numRecords() const;
+
+private:
+    void onNext(const T& value);
+    void onError(unrx4::error_code_type errorCode);
+    void onCompleted();
+
+    UNRX4LogWriter writer_;
+    unrx4::u64 startCycles_;
+    unrx4::u64 numRecords_;
+};
+
+template<class T>
+UNRX4Recorder<T>::UNRX4Recorder(UNRX4IObservable<T>* source, const TCHAR* path, unrx4::u64 type, unrx4::size_t bufferSize)
+    : base_type(source)
+    , startCycles_(FPlatformTime::Cycles64())
+    , numRecords_(0)
+{
+    writer_.open(path, unrx4::recording::header<T>(type, FDateTime::UtcNow().GetTicks()), bufferSize);
+}
+
+template<class T>
+UNRX4Recorder<T>::~UNRX4Recorder()
+{
+    writer_.close();
+}
+
+template<class T>
+bool UNRX4Recorder<T>::isRecording() const
+{
+    return writer_.isOpen();
+}
+
+template<class T>
+unrx4::u64 UNRX4Recorder<T>::numRecords() const
+{
+    return numRecords_;
+}
+
+template<class T>
+void UNRX4Recorder<T>::onNext(const T& value)
+{
+    if(writer_.isOpen()) {
+        alignas(8) unrx4::u8 record[unrx4::recording::recordSize<T>()] = {};
+        //Cycles are converted to ticks of FTimespan, which do not depend on the machine
+        unrx4::s64 elapsed = static_cast<unrx4::s64>(static_cast<double>(FPlatformTime::Cycles64() - startCycles_) * FPlatformTime::GetSecondsPerCycle64() * ETimespan::TicksPerSecond);
+        FMemory::Memcpy(record, &elapsed, sizeof(elapsed));
+        FMemory::Memcpy(record + sizeof(elapsed), &value, sizeof(T));
+        writer_.append(record, sizeof(record));
+        ++numRecords_;
+    }
+    this->emit(value);
+}
+
+template<class T>
+void UNRX4Recorder<T>::onError(unrx4::error_code_type errorCode)
+{
+    writer_.flush();
+    base_type::onError(errorCode);
+}
+
+template<class T>
+void UNRX4Recorder<T>::onCompleted()
+{
+    writer_.close();
+    base_type::onCompleted();
+}
+
+//-------------------
+/**
+ * @brief Source which emits the records of a binary log
+ *
+ * Records are emitted as fast as possible by play, or at their recorded offsets on the clock of a virtual time scheduler.
+ */
+template<class T>
+class UNRX4ObservableReplay: public UNRX4IObservable<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Replayed values should be trivially copyable.");
+
+public:
+    using this_type = UNRX4ObservableReplay<T>;
+    using observer_type = UNRX4IObserver<T>;
+
+    UNRX4ObservableReplay(const TCHAR* path, unrx4::u64 type);
+    virtual ~UNRX4ObservableReplay();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    bool isOpen() const;
+    unrx4::size_t size() const;
+
+    /**
+     * @brief Emit all records at once, then complete
+     * @return The number of emitted records
+     */
+    unrx4::size_t play();
+
+    /**
+     * @brief Schedule records at their offsets from the current time of the scheduler, one action at a time
+     */
+    void play(UNRX4VirtualTimeScheduler& scheduler);
+
+private:
+    struct State
+    {
+        FCriticalSection lock_;
+        this_type* owner_;
+    };
+    using state_type = TSharedRef<State, ESPMode::ThreadSafe>;
+
+    static void step(const state_type& state, UNRX4VirtualTimeScheduler& scheduler, unrx4::s64 startTicks, unrx4::size_t index);
+
+    T read(unrx4::size_t index) const;
+    void scheduleRecord(UNRX4VirtualTimeScheduler& scheduler, unrx4::s64 startTicks, unrx4::size_t index);
+
+    state_type state_;
+    UNRX4LogReader reader_;
+    UNRX4Array<observer_type*> observers_;
+};
+
+template<class T>
+UNRX4ObservableReplay<T>::UNRX4ObservableReplay(const TCHAR* path, unrx4::u64 type)
+    : state_(MakeShared<State, ESPMode::ThreadSafe>())
+{
+    state_->owner_ = this;
+    reader_.open(path, type, unrx4::recording::recordSize<T>());
+}
+
+template<class T>
+UNRX4ObservableReplay<T>::~UNRX4ObservableReplay()
+{
+    //Actions left in the scheduler find no owner
+    FScopeLock lock(&state_->lock_);
+    state_->owner_ = nullptr;
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.push_back(observer);
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.remove(observer);
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::next(T value)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(value);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::error(unrx4::error_code_type errorCode)
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::completed()
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+bool UNRX4ObservableReplay<T>::isOpen() const
+{
+    return reader_.isOpen();
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableReplay<T>::size() const
+{
+    return reader_.size();
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableReplay<T>::play()
+{
+    unrx4::size_t size = reader_.size();
+    for(unrx4::size_t i = 0; i < size; ++i) {
+        next(read(i));
+    }
+    completed();
+    return size;
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::play(UNRX4VirtualTimeScheduler& scheduler)
+{
+    scheduleRecord(scheduler, scheduler.now().GetTicks(), 0);
+}
+
+template<class T>
+T UNRX4ObservableReplay<T>::read(unrx4::size_t index) const
+{
+    //Payloads are not aligned for T in the mapped file
+    T value;
+    FMemory::Memcpy(&value, reader_.payload(index), sizeof(T));
+    return value;
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::step(const state_type& state, UNRX4VirtualTimeScheduler& scheduler, unrx4::s64 startTicks, unrx4::size_t index)
+{
+    //Hold the lock while emitting, then the destructor waits for it. The lock is recursive.
+    FScopeLock lock(&state->lock_);
+    this_type* owner = state->owner_;
+    if(nullptr == owner) {
+        return;
+    }
+    if(owner->reader_.size() <= index) {
+        owner->completed();
+        return;
+    }
+    owner->next(owner->read(index));
+    //An observer can destroy the replay
+    if(nullptr != state->owner_) {
+        owner->scheduleRecord(scheduler, startTicks, index + 1);
+    }
+}
+
+template<class T>
+void UNRX4ObservableReplay<T>::scheduleRecord(UNRX4VirtualTimeScheduler& scheduler, unrx4::s64 startTicks, unrx4::size_t index)
+{
+    if(reader_.size() <= index) {
+        scheduler.schedule(UNRX4Action([state = state_, &scheduler, startTicks, index]() {
+            step(state, scheduler, startTicks, index);
+        }));
+        return;
+    }
+    //Only the next record is queued, so long logs do not fill the scheduler
+    scheduler.scheduleAt(UNRX4Action([state = state_, &scheduler, startTicks, index]() {
+                             step(state, scheduler, startTicks, index);
+                         }),
+                         FDateTime(startTicks + reader_.elapsedTicks(index)));
+}
+
+//-------------------
+/**
+ * @brief Factories of recording and replay
+ */
+class UNRX4Recording
+{
+public:
+    /**
+     * @brief Tee a source into a binary log at the path
+     * @param type ... Id of the record layout, e.g. unrx4::sharedmemory::typeId("FMySample.1")
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4IObservable<T>> record(UNRX4IObservable<T>* source, const TCHAR* path, unrx4::u64 type, unrx4::size_t bufferSize = UNRX4LogWriter::DefaultBufferSize);
+
+    /**
+     * @brief Map a binary log recorded for T
+     * @param type ... Id of the record layout, which should equal to the one of the recording
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ObservableReplay<T>> replay(const TCHAR* path, unrx4::u64 type);
+};
+
+template<class T>
+unrx4_unique_ptr<UNRX4IObservable<T>> UNRX4Recording::record(UNRX4IObservable<T>* source, const TCHAR* path, unrx4::u64 type, unrx4::size_t bufferSize)
+{
+    return unrx4_make_unique<UNRX4Recorder<T>>(source, path, type, bufferSize);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4ObservableReplay<T>> UNRX4Recording::replay(const TCHAR* path, unrx4::u64 type)
+{
+    return unrx4_make_unique<UNRX4ObservableReplay<T>>(path, type);
+}
@@ -0,0 +1,151 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ShardedSubject.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4ShardedSubject.h"
+#if !UE_BUILD_SHIPPING
+#    include <Async/Async.h>
+#    include <HAL/IConsoleManager.h>
+#    include "UNRX4ConcurrentSubject.h"
+#endif
+
+namespace unrx4
+{
+namespace sharded
+{
+    namespace
+    {
+        std::atomic<unrx4::u32> unrx4_internal_threadSlots_(0);
+    }
+
+    unrx4::u32 threadSlot()
+    {
+        thread_local unrx4::u32 slot = unrx4_internal_threadSlots_.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    unrx4::u32 defaultShards()
+    {
+        return static_cast<unrx4::u32>(FMath::Max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1));
+    }
+
+    const void*& flushing()
+    {
+        thread_local const void* subject = nullptr;
+        return subject;
+    }
+} // namespace sharded
+} // namespace unrx4
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+    class UNRX4BenchObserver: public UNRX4IObserver<unrx4::s32>
+    {
+    public:
+        UNRX4BenchObserver()
+            : count_(0)
+        {
+        }
+
+        virtual void next(unrx4::s32) override
+        {
+            ++count_;
+        }
+
+        virtual void error(unrx4::error_code_type) override
+        {
+        }
+
+        virtual void completed() override
+        {
+        }
+
+        unrx4::u64 count_;
+    };
+
+    /**
+     * @brief Push events from dedicated producer threads, while the calling thread delivers
+     * @return Deliveries per second
+     */
+    template<class Subject, class Flush>
+    double unrx4_internal_benchmark(Subject& subject, unrx4::s32 producers, unrx4::s32 events, unrx4::s32 subscribers, Flush flush)
+    {
+        TArray<UNRX4BenchObserver> observers;
+        observers.SetNum(subscribers);
+        for(UNRX4BenchObserver& observer: observers) {
+            subject.subscribe(&observer);
+        }
+        std::atomic<unrx4::s32> running(producers);
+        TArray<TFuture<void>> futures;
+        futures.Reserve(producers);
+        double start = FPlatformTime::Seconds();
+        for(unrx4::s32 i = 0; i < producers; ++i) {
+            futures.Add(Async(EAsyncExecution::Thread, [&subject, &running, events]() {
+                for(unrx4::s32 j = 0; j < events; ++j) {
+                    subject.next(j);
+                }
+                running.fetch_sub(1, std::memory_order_release);
+            }));
+        }
+        while(0 < running.load(std::memory_order_acquire)) {
+            flush();
+        }
+        for(TFuture<void>& future: futures) {
+            future.Wait();
+        }
+        flush();
+        double seconds = FMath::Max(FPlatformTime::Seconds() - start, 1.0e-6);
+        for(UNRX4BenchObserver& observer: observers) {
+            subject.unsubscribe(&observer);
+        }
+        return static_cast<double>(producers) * events * subscribers / seconds;
+    }
+
+    FAutoConsoleCommand unrx4_internal_benchShardedCommand_(
+        TEXT("unrx4.Bench.ShardedSubject"),
+        TEXT("Compare the sharded subject with the concurrent subject at 1/4/16/64 producers. unrx4.Bench.ShardedSubject [events=100000] [subscribers=64]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+            unrx4::s32 events = 100000;
+            unrx4::s32 subscribers = 64;
+            if(0 < args.Num()) {
+                events = FMath::Max(FCString::Atoi(*args[0]), 1);
+            }
+            if(1 < args.Num()) {
+                subscribers = FMath::Max(FCString::Atoi(*args[1]), 1);
+            }
+            static const unrx4::s32 Producers[] = {1, 4, 16, 64};
+            double base = 0.0;
+            for(unrx4::s32 producers: Producers) {
+                UNRX4ConcurrentSubject<unrx4::s32> concurrent(UNRX4ConcurrentSubject<unrx4::s32>::DefaultCapacity, false);
+                double concurrentRate = unrx4_internal_benchmark(concurrent, producers, events, subscribers, [&concurrent]() { concurrent.drain(); });
+
+                UNRX4ShardedSubject<unrx4::s32> sharded;
+                double shardedRate = unrx4_internal_benchmark(sharded, producers, events, subscribers, [&sharded]() { sharded.flush(); });
+                if(base <= 0.0) {
+                    base = shardedRate;
+                }
+                UE_LOG(LogTemp, Log, TEXT("unrx4.Bench.ShardedSubject producers:%d shards:%u concurrent:%.2fM/s sharded:%.2fM/s scaling:%.2fx"),
+                       producers,
+                       sharded.numShards(),
+                       concurrentRate / 1000000.0,
+                       shardedRate / 1000000.0,
+                       shardedRate / base);
+            }
+        }));
+} // namespace
+#endif
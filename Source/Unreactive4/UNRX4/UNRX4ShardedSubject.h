@@ -0,0 +1,352 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ShardedSubject.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <Async/ParallelFor.h>
+#include "UNRX4Container.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include "UNRX4Trace.h"
+#include <atomic>
+
+namespace unrx4
+{
+namespace sharded
+{
+    /**
+     * @brief Sequential number of the calling thread, which producers use to pick their shard
+     */
+    UNREACTIVE4_API unrx4::u32 threadSlot();
+
+    /**
+     * @brief Default number of shards, the number of logical cores
+     */
+    UNREACTIVE4_API unrx4::u32 defaultShards();
+
+    /**
+     * @brief The subject whose flush is calling observers on this thread
+     */
+    UNREACTIVE4_API const void*& flushing();
+} // namespace sharded
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Subject partitioned into shards for many producers and observers
+ *
+ * Each producer thread pushes into the ring buffer of its own shard, and each shard has its own part of the observers,
+ * then producers on different threads and subscriptions to different shards do not touch the same cache lines.
+ * Events are delivered at the merge point, flush, which gathers events of all shards into one batch,
+ * and delivers the batch to the partitions of observers in parallel.
+ * Each observer receives events serially and in the order of each producer, but observers in different shards are called concurrently.
+ * A producer always pushes into the shard of its thread, and waits for flush if the shard is full, which keeps its order.
+ * Events pushed after a terminal event are dropped at flush.
+ * Observers are called without locks of shards. Unsubscribing waits for a running flush, unless an observer of the flush unsubscribes,
+ * then observers which unsubscribe during a flush still receive its batch.
+ */
+template<class T>
+class UNRX4ShardedSubject: public UNRX4IObservable<T>
+{
+public:
+    using observer_type = UNRX4IObserver<T>;
+    static constexpr unrx4::size_t DefaultShardCapacity = 4096;
+    static constexpr unrx4::size_t CacheLineSize = 64;
+
+    /**
+     * @param numShards ... The number of shards, 0 for unrx4::sharded::defaultShards
+     * @param shardCapacity ... The number of pending events of each shard, rounded up to a power of two
+     */
+    explicit UNRX4ShardedSubject(unrx4::u32 numShards = 0, unrx4::size_t shardCapacity = DefaultShardCapacity);
+    virtual ~UNRX4ShardedSubject();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Deliver pending events of all shards, calls from multiple threads are serialized
+     * @return The number of delivered events, 0 if an observer of this subject calls this
+     */
+    unrx4::size_t flush();
+
+    unrx4::u32 numShards() const;
+    unrx4::size_t numObservers() const;
+
+private:
+    UNRX4ShardedSubject(const UNRX4ShardedSubject&) = delete;
+    UNRX4ShardedSubject& operator=(const UNRX4ShardedSubject&) = delete;
+
+    enum class Termination : unrx4::u8
+    {
+        None,
+        Erroring, //!< The error code is being stored
+        Error,
+        Completed,
+        Delivered,
+    };
+
+    struct Cell
+    {
+        std::atomic<unrx4::size_t> sequence_;
+        alignas(T) unrx4::u8 value_[sizeof(T)];
+    };
+
+    struct alignas(CacheLineSize) Shard
+    {
+        std::atomic<unrx4::size_t> enqueue_;
+        alignas(CacheLineSize) unrx4::size_t dequeue_;
+        Cell* cells_;
+        FCriticalSection lock_;
+        UNRX4Array<observer_type*> observers_;
+        UNRX4Array<observer_type*> snapshot_; //!< Observers of the running flush
+    };
+
+    bool tryPush(Shard& shard, T& value);
+    bool tryPop(Shard& shard, T& value);
+
+    unrx4::u32 numShards_;
+    unrx4::size_t mask_;
+    Shard* shards_;
+    std::atomic<Termination> termination_;
+    unrx4::error_code_type errorCode_;
+    FCriticalSection flushLock_;
+    UNRX4Array<T> merged_;
+};
+
+template<class T>
+UNRX4ShardedSubject<T>::UNRX4ShardedSubject(unrx4::u32 numShards, unrx4::size_t shardCapacity)
+    : numShards_(0 < numShards ? numShards : unrx4::sharded::defaultShards())
+    , mask_(0)
+    , shards_(nullptr)
+    , termination_(Termination::None)
+    , errorCode_(0)
+{
+    unrx4::size_t capacity = 2;
+    while(capacity < shardCapacity) {
+        capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    //Shards are aligned to cache lines, which unrx4_malloc does not guarantee
+    shards_ = reinterpret_cast<Shard*>(FMemory::Malloc(sizeof(Shard) * numShards_, CacheLineSize));
+    for(unrx4::u32 i = 0; i < numShards_; ++i) {
+        Shard* shard = new(&shards_[i]) Shard();
+        shard->enqueue_.store(0, std::memory_order_relaxed);
+        shard->dequeue_ = 0;
+        shard->cells_ = reinterpret_cast<Cell*>(unrx4_malloc(sizeof(Cell) * capacity));
+        for(unrx4::size_t j = 0; j < capacity; ++j) {
+            new(&shard->cells_[j].sequence_) std::atomic<unrx4::size_t>(j);
+        }
+    }
+}
+
+template<class T>
+UNRX4ShardedSubject<T>::~UNRX4ShardedSubject()
+{
+    T value;
+    for(unrx4::u32 i = 0; i < numShards_; ++i) {
+        Shard& shard = shards_[i];
+        while(tryPop(shard, value)) {
+        }
+        unrx4_free(shard.cells_);
+        shard.~Shard();
+    }
+    FMemory::Free(shards_);
+}
+
+template<class T>
+void UNRX4ShardedSubject<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    //Balance partitions, sizes can be stale but it only affects the balance
+    unrx4::u32 target = 0;
+    for(unrx4::u32 i = 1; i < numShards_; ++i) {
+        if(shards_[i].observers_.size() < shards_[target].observers_.size()) {
+            target = i;
+        }
+    }
+    FScopeLock lock(&shards_[target].lock_);
+    shards_[target].observers_.push_back(observer);
+}
+
+template<class T>
+void UNRX4ShardedSubject<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    //Wait for a running flush, then callers can delete the observer. Observers of the flush cannot wait for it.
+    const bool inFlush = this == unrx4::sharded::flushing();
+    if(!inFlush) {
+        flushLock_.Lock();
+    }
+    for(unrx4::u32 i = 0; i < numShards_; ++i) {
+        Shard& shard = shards_[i];
+        FScopeLock lock(&shard.lock_);
+        unrx4::size_t size = shard.observers_.size();
+        shard.observers_.remove(observer);
+        if(shard.observers_.size() != size) {
+            break;
+        }
+    }
+    if(!inFlush) {
+        flushLock_.Unlock();
+    }
+}
+
+template<class T>
+void UNRX4ShardedSubject<T>::next(T value)
+{
+    if(Termination::None != termination_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    //Spilling over to other shards would reorder events of this producer, then wait for flush if the shard is full
+    Shard& shard = shards_[unrx4::sharded::threadSlot() % numShards_];
+    while(!tryPush(shard, value)) {
+        FPlatformProcess::Yield();
+    }
+}
+
+template<class T>
+void UNRX4ShardedSubject<T>::error(unrx4::error_code_type errorCode)
+{
+    //Only the first terminal event stores its code, then publishes it
+    Termination expected = Termination::None;
+    if(termination_.compare_exchange_strong(expected, Termination::Erroring, std::memory_order_relaxed)) {
+        errorCode_ = errorCode;
+        termination_.store(Termination::Error, std::memory_order_release);
+    }
+}
+
+template<class T>
+void UNRX4ShardedSubject<T>::completed()
+{
+    Termination expected = Termination::None;
+    termination_.compare_exchange_strong(expected, Termination::Completed);
+}
+
+template<class T>
+unrx4::size_t UNRX4ShardedSubject<T>::flush()
+{
+    if(this == unrx4::sharded::flushing()) {
+        return 0;
+    }
+    FScopeLock flushLock(&flushLock_);
+    merged_.clear();
+    T value;
+    for(unrx4::u32 i = 0; i < numShards_; ++i) {
+        while(tryPop(shards_[i], value)) {
+            merged_.push_back(std::move(value));
+        }
+    }
+    Termination termination = termination_.load(std::memory_order_acquire);
+    if(Termination::Delivered == termination) {
+        //A producer can pass the check of termination_ in next before another one terminates
+        merged_.clear();
+        return 0;
+    }
+    if(Termination::Error == termination || Termination::Completed == termination) {
+        termination_.store(Termination::Delivered, std::memory_order_relaxed);
+    } else {
+        //An error which is being stored is delivered at the next flush
+        termination = Termination::None;
+    }
+    if(merged_.size() <= 0 && Termination::None == termination) {
+        return 0;
+    }
+    UNRX4_TRACE_DRAIN("UNRX4ShardedSubject::flush", this, merged_.size());
+    const T* values = merged_.cbegin();
+    unrx4::size_t size = merged_.size();
+    ParallelFor(
+        static_cast<int32>(numShards_), [this, values, size, termination](int32 index) {
+            Shard& shard = shards_[index];
+            //Observers are called outside the lock, which subscribing and unsubscribing take
+            {
+                FScopeLock lock(&shard.lock_);
+                shard.snapshot_.resize(shard.observers_.size());
+                FMemory::Memcpy(shard.snapshot_.begin(), shard.observers_.cbegin(), sizeof(observer_type*) * shard.observers_.size());
+            }
+            const void* previous = unrx4::sharded::flushing();
+            unrx4::sharded::flushing() = this;
+            for(observer_type* observer: shard.snapshot_) {
+                for(unrx4::size_t j = 0; j < size; ++j) {
+                    observer->next(values[j]);
+                }
+                if(Termination::Error == termination) {
+                    observer->error(errorCode_);
+                } else if(Termination::Completed == termination) {
+                    observer->completed();
+                }
+            }
+            unrx4::sharded::flushing() = previous;
+        },
+        numShards_ <= 1);
+    return size;
+}
+
+template<class T>
+unrx4::u32 UNRX4ShardedSubject<T>::numShards() const
+{
+    return numShards_;
+}
+
+template<class T>
+unrx4::size_t UNRX4ShardedSubject<T>::numObservers() const
+{
+    unrx4::size_t size = 0;
+    for(unrx4::u32 i = 0; i < numShards_; ++i) {
+        size += shards_[i].observers_.size();
+    }
+    return size;
+}
+
+template<class T>
+bool UNRX4ShardedSubject<T>::tryPush(Shard& shard, T& value)
+{
+    unrx4::size_t position = shard.enqueue_.load(std::memory_order_relaxed);
+    for(;;) {
+        Cell& cell = shard.cells_[position & mask_];
+        unrx4::size_t sequence = cell.sequence_.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if(0 == diff) {
+            if(shard.enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                new(cell.value_) T(std::move(value));
+                cell.sequence_.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if(diff < 0) {
+            return false;
+        } else {
+            position = shard.enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template<class T>
+bool UNRX4ShardedSubject<T>::tryPop(Shard& shard, T& value)
+{
+    //Only the flushing thread pops
+    unrx4::size_t position = shard.dequeue_;
+    Cell& cell = shard.cells_[position & mask_];
+    if(cell.sequence_.load(std::memory_order_acquire) != (position + 1)) {
+        return false;
+    }
+    T* item = reinterpret_cast<T*>(cell.value_);
+    value = std::move(*item);
+    item->~T();
+    cell.sequence_.store(position + mask_ + 1, std::memory_order_release);
+    shard.dequeue_ = position + 1;
+    return true;
+}
@@ -0,0 +1,337 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4SharedMemory.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4SharedMemory.h"
+#if !UE_BUILD_SHIPPING
+#    include <Async/Async.h>
+#    include <HAL/IConsoleManager.h>
+#endif
+
+static_assert(2 == ATOMIC_LLONG_LOCK_FREE && 2 == ATOMIC_INT_LOCK_FREE, "Shared counters should be lock free to work across processes.");
+
+namespace
+{
+    constexpr uint32 unrx4_internal_access_ = FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write;
+}
+
+UNRX4SharedRing::UNRX4SharedRing()
+    : region_(nullptr)
+    , header_(nullptr)
+    , slots_(nullptr)
+    , mask_(0)
+    , position_(0)
+    , slotSize_(0)
+    , payloadSize_(0)
+{
+}
+
+UNRX4SharedRing::~UNRX4SharedRing()
+{
+    close();
+}
+
+bool UNRX4SharedRing::create(const TCHAR* name, unrx4::u64 type, unrx4::u32 payloadSize, unrx4::size_t capacity)
+{
+    close();
+    unrx4::u64 count = 2;
+    while(count < capacity) {
+        count <<= 1;
+    }
+    unrx4::u32 size = slotSize(payloadSize);
+    region_ = FPlatformMemory::MapNamedSharedMemoryRegion(name, true, unrx4_internal_access_, headerSize() + count * size);
+    if(nullptr == region_) {
+        return false;
+    }
+    unrx4::u8* memory = reinterpret_cast<unrx4::u8*>(region_->GetAddress());
+    FMemory::Memzero(memory, headerSize() + count * size);
+    header_ = new(memory) UNRX4SharedRingHeader();
+    header_->magic_ = UNRX4SharedRingHeader::Magic;
+    header_->version_ = UNRX4SharedRingHeader::Version;
+    header_->slotSize_ = size;
+    header_->payloadSize_ = payloadSize;
+    header_->type_ = type;
+    header_->capacity_ = count;
+    header_->state_.store(UNRX4SharedRingHeader::Open, std::memory_order_relaxed);
+    header_->errorCode_.store(0, std::memory_order_relaxed);
+    header_->head_.store(0, std::memory_order_relaxed);
+    header_->overruns_.store(0, std::memory_order_relaxed);
+    slots_ = memory + headerSize();
+    mask_ = count - 1;
+    position_ = 0;
+    slotSize_ = size;
+    payloadSize_ = payloadSize;
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+}
+
+bool UNRX4SharedRing::open(const TCHAR* name, unrx4::u64 type, unrx4::u32 payloadSize)
+{
+    close();
+    //Map the header to know the capacity, then map the whole ring
+    FSharedMemoryRegion* region = FPlatformMemory::MapNamedSharedMemoryRegion(name, false, unrx4_internal_access_, headerSize());
+    if(nullptr == region) {
+        return false;
+    }
+    UNRX4SharedRingHeader header;
+    FMemory::Memcpy(&header, region->GetAddress(), sizeof(UNRX4SharedRingHeader));
+    FPlatformMemory::UnmapNamedSharedMemoryRegion(region);
+    if(UNRX4SharedRingHeader::Magic != header.magic_ || UNRX4SharedRingHeader::Version != header.version_ || type != header.type_ || payloadSize != header.payloadSize_) {
+        UE_LOG(LogTemp, Warning, TEXT("UNRX4SharedRing: %s is not a ring of the type"), name);
+        return false;
+    }
+    region_ = FPlatformMemory::MapNamedSharedMemoryRegion(name, false, unrx4_internal_access_, headerSize() + header.capacity_ * header.slotSize_);
+    if(nullptr == region_) {
+        return false;
+    }
+    unrx4::u8* memory = reinterpret_cast<unrx4::u8*>(region_->GetAddress());
+    header_ = reinterpret_cast<UNRX4SharedRingHeader*>(memory);
+    slots_ = memory + headerSize();
+    mask_ = header.capacity_ - 1;
+    slotSize_ = header.slotSize_;
+    payloadSize_ = payloadSize;
+    //Start from the oldest record which is still in the ring
+    unrx4::u64 head = header_->head_.load(std::memory_order_acquire);
+    position_ = header.capacity_ < head ? head - header.capacity_ : 0;
+    return true;
+}
+
+void UNRX4SharedRing::close()
+{
+    if(nullptr != region_) {
+        FPlatformMemory::UnmapNamedSharedMemoryRegion(region_);
+    }
+    region_ = nullptr;
+    header_ = nullptr;
+    slots_ = nullptr;
+    mask_ = 0;
+    position_ = 0;
+}
+
+bool UNRX4SharedRing::isOpen() const
+{
+    return nullptr != header_;
+}
+
+void UNRX4SharedRing::write(const void* payload)
+{
+    //Sequence 0 marks a slot being written, readers of the slot retry as an overrun
+    std::atomic<unrx4::u64>* slot = sequence(position_);
+    slot->store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    FMemory::Memcpy(reinterpret_cast<unrx4::u8*>(slot) + sizeof(unrx4::u64), payload, payloadSize_);
+    ++position_;
+    slot->store(position_, std::memory_order_release);
+    header_->head_.store(position_, std::memory_order_release);
+}
+
+UNRX4SharedRing::Result UNRX4SharedRing::read(void* payload)
+{
+    unrx4::u64 head = header_->head_.load(std::memory_order_acquire);
+    if(head == position_) {
+        return Result::Empty;
+    }
+    unrx4::u64 capacity = mask_ + 1;
+    if(capacity < (head - position_)) {
+        addOverruns(head - capacity - position_);
+        position_ = head - capacity;
+    }
+    std::atomic<unrx4::u64>* slot = sequence(position_);
+    unrx4::u64 expected = position_ + 1;
+    ++position_;
+    if(expected != slot->load(std::memory_order_acquire)) {
+        addOverruns(1);
+        return Result::Overrun;
+    }
+    FMemory::Memcpy(payload, reinterpret_cast<const unrx4::u8*>(slot) + sizeof(unrx4::u64), payloadSize_);
+    //The producer may have lapped the reader while copying
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(expected != slot->load(std::memory_order_relaxed)) {
+        addOverruns(1);
+        return Result::Overrun;
+    }
+    return Result::Record;
+}
+
+void UNRX4SharedRing::setState(UNRX4SharedRingHeader::State state, unrx4::error_code_type errorCode)
+{
+    header_->errorCode_.store(static_cast<unrx4::s32>(errorCode), std::memory_order_relaxed);
+    header_->state_.store(state, std::memory_order_release);
+}
+
+UNRX4SharedRingHeader::State UNRX4SharedRing::state() const
+{
+    return static_cast<UNRX4SharedRingHeader::State>(header_->state_.load(std::memory_order_acquire));
+}
+
+unrx4::error_code_type UNRX4SharedRing::errorCode() const
+{
+    return static_cast<unrx4::error_code_type>(header_->errorCode_.load(std::memory_order_relaxed));
+}
+
+unrx4::u64 UNRX4SharedRing::written() const
+{
+    return nullptr != header_ ? header_->head_.load(std::memory_order_relaxed) : 0;
+}
+
+unrx4::u64 UNRX4SharedRing::overruns() const
+{
+    return nullptr != header_ ? header_->overruns_.load(std::memory_order_relaxed) : 0;
+}
+
+unrx4::size_t UNRX4SharedRing::capacity() const
+{
+    return nullptr != header_ ? static_cast<unrx4::size_t>(mask_ + 1) : 0;
+}
+
+unrx4::u32 UNRX4SharedRing::slotSize(unrx4::u32 payloadSize)
+{
+    return static_cast<unrx4::u32>(sizeof(unrx4::u64)) + ((payloadSize + 7U) & ~7U);
+}
+
+unrx4::size_t UNRX4SharedRing::headerSize()
+{
+    return (sizeof(UNRX4SharedRingHeader) + 63) & ~static_cast<unrx4::size_t>(63);
+}
+
+std::atomic<unrx4::u64>* UNRX4SharedRing::sequence(unrx4::u64 position) const
+{
+    return reinterpret_cast<std::atomic<unrx4::u64>*>(slots_ + (position & mask_) * slotSize_);
+}
+
+void UNRX4SharedRing::addOverruns(unrx4::u64 count)
+{
+    //Only the consumer writes, the producer reads the counter for statistics
+    header_->overruns_.store(header_->overruns_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+    struct UNRX4SharedSample
+    {
+        unrx4::u64 sequence_;
+        double time_;
+    };
+    constexpr unrx4::u64 UNRX4SharedSampleType = unrx4::sharedmemory::typeId("UNRX4SharedSample.1");
+
+    /**
+     * @brief Count received samples and gaps in their sequence
+     */
+    class UNRX4SharedSampleObserver: public UNRX4IObserver<UNRX4SharedSample>
+    {
+    public:
+        UNRX4SharedSampleObserver()
+            : received_(0)
+            , gaps_(0)
+            , next_(0)
+            , terminated_(false)
+        {
+        }
+
+        virtual void next(UNRX4SharedSample value) override
+        {
+            if(next_ != value.sequence_) {
+                ++gaps_;
+            }
+            next_ = value.sequence_ + 1;
+            ++received_;
+        }
+
+        virtual void error(unrx4::error_code_type) override
+        {
+            terminated_ = true;
+        }
+
+        virtual void completed() override
+        {
+            terminated_ = true;
+        }
+
+        unrx4::u64 received_;
+        unrx4::u64 gaps_;
+        unrx4::u64 next_;
+        bool terminated_;
+    };
+
+    /**
+     * @brief Write samples on a thread, run unrx4.SharedMemory.Consume in another process meanwhile
+     */
+    FAutoConsoleCommand unrx4_internal_produceSharedCommand_(
+        TEXT("unrx4.SharedMemory.Produce"),
+        TEXT("Write samples into a shared ring over some seconds, then complete. unrx4.SharedMemory.Produce [name=UNRX4SharedSample] [records=1000000] [seconds=10]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+            FString name = 0 < args.Num() ? args[0] : FString(TEXT("UNRX4SharedSample"));
+            unrx4::s32 records = 1 < args.Num() ? FMath::Max(FCString::Atoi(*args[1]), 1) : 1000000;
+            float seconds = 2 < args.Num() ? FMath::Max(FCString::Atof(*args[2]), 0.1f) : 10.0f;
+            Async(EAsyncExecution::Thread, [name, records, seconds]() {
+                unrx4_unique_ptr<UNRX4SharedMemorySink<UNRX4SharedSample>> sink = UNRX4SharedMemory::toSharedMemory<UNRX4SharedSample>(*name, UNRX4SharedSampleType);
+                if(!sink->isOpen()) {
+                    UE_LOG(LogTemp, Warning, TEXT("unrx4.SharedMemory.Produce cannot create %s"), *name);
+                    return;
+                }
+                //Write in bursts of one millisecond, then the consumer has time to open the ring
+                double start = FPlatformTime::Seconds();
+                unrx4::s32 bursts = FMath::Max(static_cast<unrx4::s32>(seconds * 1000.0f), 1);
+                unrx4::s32 burst = FMath::Max(records / bursts, 1);
+                for(unrx4::s32 i = 0; i < records;) {
+                    for(unrx4::s32 end = FMath::Min(i + burst, records); i < end; ++i) {
+                        sink->next(UNRX4SharedSample{static_cast<unrx4::u64>(i), FPlatformTime::Seconds() - start});
+                    }
+                    FPlatformProcess::Sleep(0.001f);
+                }
+                sink->completed();
+                //Keep the ring until the consumer has read the termination
+                FPlatformProcess::Sleep(1.0f);
+                UE_LOG(LogTemp, Log, TEXT("unrx4.SharedMemory.Produce %s written:%llu overruns:%llu"), *name, sink->written(), sink->overruns());
+            });
+        }));
+
+    /**
+     * @brief Poll samples on a thread until the producer completes
+     */
+    FAutoConsoleCommand unrx4_internal_consumeSharedCommand_(
+        TEXT("unrx4.SharedMemory.Consume"),
+        TEXT("Poll a shared ring written by unrx4.SharedMemory.Produce in another process. unrx4.SharedMemory.Consume [name=UNRX4SharedSample] [timeout=30]"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+            FString name = 0 < args.Num() ? args[0] : FString(TEXT("UNRX4SharedSample"));
+            float timeout = 1 < args.Num() ? FMath::Max(FCString::Atof(*args[1]), 0.1f) : 30.0f;
+            Async(EAsyncExecution::Thread, [name, timeout]() {
+                unrx4_unique_ptr<UNRX4ObservableSharedMemory<UNRX4SharedSample>> source = UNRX4SharedMemory::fromSharedMemory<UNRX4SharedSample>(*name, UNRX4SharedSampleType);
+                if(!source->isOpen()) {
+                    UE_LOG(LogTemp, Warning, TEXT("unrx4.SharedMemory.Consume cannot open %s"), *name);
+                    return;
+                }
+                UNRX4SharedSampleObserver observer;
+                source->subscribe(&observer);
+                double end = FPlatformTime::Seconds() + timeout;
+                while(!observer.terminated_ && FPlatformTime::Seconds() < end) {
+                    if(source->poll() <= 0) {
+                        FPlatformProcess::Sleep(0.001f);
+                    }
+                }
+                source->unsubscribe(&observer);
+                UE_LOG(LogTemp, Log, TEXT("unrx4.SharedMemory.Consume %s received:%llu gaps:%llu overruns:%llu completed:%d"),
+                       *name,
+                       observer.received_,
+                       observer.gaps_,
+                       source->overruns(),
+                       observer.terminated_ ? 1 : 0);
+            });
+        }));
+} // namespace
+#endif
@@ -0,0 +1,398 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4SharedMemory.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4EventBus.h"
+#include "UNRX4IObservable.h"
+#include "UNRX4IObserver.h"
+#include <atomic>
+#include <type_traits>
+
+struct FSharedMemoryRegion;
+
+namespace unrx4
+{
+namespace sharedmemory
+{
+    /**
+     * @brief Id of a record layout from a name which both processes agree on, e.g. the type name with a version
+     *
+     * Type ids of the event bus hash function signatures, which differ between compilers, then processes built by different compilers cannot share them.
+     */
+    constexpr unrx4::u64 typeId(const char* name)
+    {
+        return unrx4::eventbus::hash(name);
+    }
+} // namespace sharedmemory
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Header at the top of a shared ring, followed by slots of a sequence and a payload
+ */
+struct UNRX4SharedRingHeader
+{
+    static constexpr unrx4::u32 Magic = 0x52534E55U; //UNSR
+    static constexpr unrx4::u32 Version = 1;
+
+    enum State : unrx4::u32
+    {
+        Open = 0,
+        Completed,
+        Error,
+    };
+
+    unrx4::u32 magic_;
+    unrx4::u32 version_;
+    unrx4::u32 slotSize_;
+    unrx4::u32 payloadSize_;
+    unrx4::u64 type_;
+    unrx4::u64 capacity_;
+    std::atomic<unrx4::u32> state_;
+    std::atomic<unrx4::s32> errorCode_;
+    alignas(64) std::atomic<unrx4::u64> head_;     //!< Records written by the producer
+    alignas(64) std::atomic<unrx4::u64> overruns_; //!< Records lost by the consumer
+};
+
+//-------------------
+/**
+ * @brief Lock-free single-producer ring of fixed size records in a named shared memory region
+ *
+ * The producer never waits, it overwrites the oldest records if the consumer falls behind.
+ * Each slot carries the sequence of its record, so the consumer detects records overwritten while it reads them, and counts them as overruns.
+ * One process creates the ring and writes, and one other process opens the ring and reads.
+ */
+UNREACTIVE4_API
+class UNRX4SharedRing
+{
+public:
+    static constexpr unrx4::size_t DefaultCapacity = 4096;
+
+    enum class Result
+    {
+        Empty,
+        Record,
+        Overrun,
+    };
+
+    UNRX4SharedRing();
+    ~UNRX4SharedRing();
+
+    /**
+     * @param capacity ... The number of records, rounded up to a power of two
+     */
+    bool create(const TCHAR* name, unrx4::u64 type, unrx4::u32 payloadSize, unrx4::size_t capacity);
+    bool open(const TCHAR* name, unrx4::u64 type, unrx4::u32 payloadSize);
+    void close();
+    bool isOpen() const;
+
+    void write(const void* payload);
+
+    /**
+     * @brief Read the next record into payload, records lost since the last read are added to overruns
+     */
+    Result read(void* payload);
+
+    void setState(UNRX4SharedRingHeader::State state, unrx4::error_code_type errorCode = 0);
+    UNRX4SharedRingHeader::State state() const;
+    unrx4::error_code_type errorCode() const;
+
+    unrx4::u64 written() const;
+    unrx4::u64 overruns() const;
+    unrx4::size_t capacity() const;
+
+private:
+    UNRX4SharedRing(const UNRX4SharedRing&) = delete;
+    UNRX4SharedRing& operator=(const UNRX4SharedRing&) = delete;
+
+    static unrx4::u32 slotSize(unrx4::u32 payloadSize);
+    static unrx4::size_t headerSize();
+    std::atomic<unrx4::u64>* sequence(unrx4::u64 position) const;
+    void addOverruns(unrx4::u64 count);
+
+    FSharedMemoryRegion* region_;
+    UNRX4SharedRingHeader* header_;
+    unrx4::u8* slots_;
+    unrx4::u64 mask_;
+    unrx4::u64 position_;
+    unrx4::u32 slotSize_;
+    unrx4::u32 payloadSize_;
+};
+
+//-------------------
+/**
+ * @brief Observer which writes values into a shared ring, for a consumer in another process
+ */
+template<class T>
+class UNRX4SharedMemorySink: public UNRX4IObserver<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Shared values should be trivially copyable.");
+
+public:
+    /**
+     * @param type ... Id of the record layout, which the consumer opens the ring with
+     */
+    UNRX4SharedMemorySink(const TCHAR* name, unrx4::u64 type, unrx4::size_t capacity);
+    virtual ~UNRX4SharedMemorySink();
+
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    bool isOpen() const;
+    unrx4::u64 written() const;
+
+    /**
+     * @brief Records the consumer has lost
+     */
+    unrx4::u64 overruns() const;
+
+private:
+    UNRX4SharedRing ring_;
+};
+
+template<class T>
+UNRX4SharedMemorySink<T>::UNRX4SharedMemorySink(const TCHAR* name, unrx4::u64 type, unrx4::size_t capacity)
+{
+    ring_.create(name, type, static_cast<unrx4::u32>(sizeof(T)), capacity);
+}
+
+template<class T>
+UNRX4SharedMemorySink<T>::~UNRX4SharedMemorySink()
+{
+}
+
+template<class T>
+void UNRX4SharedMemorySink<T>::next(T value)
+{
+    if(ring_.isOpen()) {
+        ring_.write(&value);
+    }
+}
+
+template<class T>
+void UNRX4SharedMemorySink<T>::error(unrx4::error_code_type errorCode)
+{
+    if(ring_.isOpen()) {
+        ring_.setState(UNRX4SharedRingHeader::Error, errorCode);
+    }
+}
+
+template<class T>
+void UNRX4SharedMemorySink<T>::completed()
+{
+    if(ring_.isOpen()) {
+        ring_.setState(UNRX4SharedRingHeader::Completed);
+    }
+}
+
+template<class T>
+bool UNRX4SharedMemorySink<T>::isOpen() const
+{
+    return ring_.isOpen();
+}
+
+template<class T>
+unrx4::u64 UNRX4SharedMemorySink<T>::written() const
+{
+    return ring_.written();
+}
+
+template<class T>
+unrx4::u64 UNRX4SharedMemorySink<T>::overruns() const
+{
+    return ring_.overruns();
+}
+
+//-------------------
+/**
+ * @brief Source which emits records of a shared ring written by another process, when polled
+ */
+template<class T>
+class UNRX4ObservableSharedMemory: public UNRX4IObservable<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Shared values should be trivially copyable.");
+
+public:
+    using observer_type = UNRX4IObserver<T>;
+
+    /**
+     * @param type ... Id of the record layout, which should equal to the one of the producer
+     */
+    UNRX4ObservableSharedMemory(const TCHAR* name, unrx4::u64 type);
+    virtual ~UNRX4ObservableSharedMemory();
+
+    virtual void subscribe(UNRX4IObserver<T>* observer) override;
+    virtual void unsubscribe(UNRX4IObserver<T>* observer) override;
+    virtual void next(T value) override;
+    virtual void error(unrx4::error_code_type errorCode) override;
+    virtual void completed() override;
+
+    /**
+     * @brief Emit available records, and the termination once the producer has terminated and all records are read
+     * @return The number of emitted records
+     */
+    unrx4::size_t poll(unrx4::size_t maxRecords = 0xFFFFFFFFU);
+
+    bool isOpen() const;
+    unrx4::u64 overruns() const;
+
+private:
+    UNRX4SharedRing ring_;
+    UNRX4Array<observer_type*> observers_;
+    bool terminated_;
+};
+
+template<class T>
+UNRX4ObservableSharedMemory<T>::UNRX4ObservableSharedMemory(const TCHAR* name, unrx4::u64 type)
+    : terminated_(false)
+{
+    ring_.open(name, type, static_cast<unrx4::u32>(sizeof(T)));
+}
+
+template<class T>
+UNRX4ObservableSharedMemory<T>::~UNRX4ObservableSharedMemory()
+{
+}
+
+template<class T>
+void UNRX4ObservableSharedMemory<T>::subscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.push_back(observer);
+}
+
+template<class T>
+void UNRX4ObservableSharedMemory<T>::unsubscribe(UNRX4IObserver<T>* observer)
+{
+    observers_.remove(observer);
+}
+
+template<class T>
+void UNRX4ObservableSharedMemory<T>::next(T value)
+{
+    //An observer can unsubscribe itself while being called
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->next(value);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+void UNRX4ObservableSharedMemory<T>::error(unrx4::error_code_type errorCode)
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->error(errorCode);
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+void UNRX4ObservableSharedMemory<T>::completed()
+{
+    for(unrx4::size_t i = 0; i < observers_.size();) {
+        observer_type* observer = observers_[i];
+        observer->completed();
+        if(i < observers_.size() && observer == observers_[i]) {
+            ++i;
+        }
+    }
+}
+
+template<class T>
+unrx4::size_t UNRX4ObservableSharedMemory<T>::poll(unrx4::size_t maxRecords)
+{
+    if(!ring_.isOpen() || terminated_) {
+        return 0;
+    }
+    //The state is read before records, then records written before the termination are not missed
+    UNRX4SharedRingHeader::State state = ring_.state();
+    unrx4::size_t count = 0;
+    T value;
+    while(count < maxRecords) {
+        UNRX4SharedRing::Result result = ring_.read(&value);
+        if(UNRX4SharedRing::Result::Empty == result) {
+            break;
+        }
+        if(UNRX4SharedRing::Result::Record == result) {
+            next(value);
+            ++count;
+        }
+    }
+    if(count < maxRecords && UNRX4SharedRingHeader::Open != state) {
+        terminated_ = true;
+        if(UNRX4SharedRingHeader::Error == state) {
+            error(ring_.errorCode());
+        } else {
+            completed();
+        }
+    }
+    return count;
+}
+
+template<class T>
+bool UNRX4ObservableSharedMemory<T>::isOpen() const
+{
+    return ring_.isOpen();
+}
+
+template<class T>
+unrx4::u64 UNRX4ObservableSharedMemory<T>::overruns() const
+{
+    return ring_.overruns();
+}
+
+//-------------------
+/**
+ * @brief Factories of shared memory transport
+ */
+class UNRX4SharedMemory
+{
+public:
+    /**
+     * @brief Create a named ring, then subscribe the returned sink to a source
+     * @param type ... Id of the record layout, e.g. unrx4::sharedmemory::typeId("FMySample.1")
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4SharedMemorySink<T>> toSharedMemory(const TCHAR* name, unrx4::u64 type, unrx4::size_t capacity = UNRX4SharedRing::DefaultCapacity);
+
+    /**
+     * @brief Open a named ring created by another process, then poll the returned source
+     * @param type ... Id of the record layout, which should equal to the one of the producer
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4ObservableSharedMemory<T>> fromSharedMemory(const TCHAR* name, unrx4::u64 type);
+};
+
+template<class T>
+unrx4_unique_ptr<UNRX4SharedMemorySink<T>> UNRX4SharedMemory::toSharedMemory(const TCHAR* name, unrx4::u64 type, unrx4::size_t capacity)
+{
+    return unrx4_make_unique<UNRX4SharedMemorySink<T>>(name, type, capacity);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4ObservableSharedMemory<T>> UNRX4SharedMemory::fromSharedMemory(const TCHAR* name, unrx4::u64 type)
+{
+    return unrx4_make_unique<UNRX4ObservableSharedMemory<T>>(name, type);
+}
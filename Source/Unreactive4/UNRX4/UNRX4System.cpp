@@ -19,19 +19,46 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
 #include "UNRX4System.h"
 #include "UNRX4ImmediateScheduler.h"
 #include "UNRX4CurrentThreadScheduler.h"
+#include "UNRX4PriorityScheduler.h"
+#include "UNRX4ThreadPoolScheduler.h"
+#include "UNRX4ObjectSubscription.h"
+#include "UNRX4EventBus.h"
+#include "UNRX4ReactiveProperty.h"
+#include "UNRX4Computed.h"
+#include "UNRX4PipelineArena.h"
+#include <Misc/CoreDelegates.h>
+#include <UObject/UObjectGlobals.h>
+#include "UNRX4Trace.h"
 
 //-------------------
+//The system is defined first, then it is destroyed after the statics below, which free their buffers to its allocator
+UNRX4System UNRX4System::instance_;
+
 static UNRX4ImmediateScheduler unrx4_internal_immediateScheduler_;
 static UNRX4CurrentThreadScheduler unrx4_internal_currentThreadScheduuler_;
-
-UNRX4System UNRX4System::instance_;
+static UNRX4PriorityScheduler unrx4_internal_priorityScheduler_;
+static UNRX4ThreadPoolScheduler unrx4_internal_threadPoolScheduler_;
+static UNRX4ObjectSubscriptions unrx4_internal_objectSubscriptions_;
+static UNRX4EventBus unrx4_internal_eventBus_;
+static UNRX4ReactiveProperties unrx4_internal_reactiveProperties_;
+static UNRX4SignalGraph unrx4_internal_signalGraph_;
 
 UNRX4System::UNRX4System()
+    : pipelineBlocks_(nullptr)
+    , numPipelineBlocks_(0)
+    , ownerThread_(FPlatformTLS::GetCurrentThreadId())
+    , remoteFrees_(nullptr)
 {
 }
 
 UNRX4System::~UNRX4System()
 {
+    while(nullptr != pipelineBlocks_) {
+        PooledBlock* block = pipelineBlocks_;
+        pipelineBlocks_ = block->next_;
+        FMemory::Free(block);
+    }
+    numPipelineBlocks_ = 0;
 }
 
 UNRX4System& UNRX4System::getInstance()
@@ -39,14 +66,113 @@ UNRX4System& UNRX4System::getInstance()
     return instance_;
 }
 
+void UNRX4System::initialize()
+{
+    //Prune before unreachable objects are purged, observers owned by them are still alive then
+    postReachabilityAnalysisHandle_ = FCoreUObjectDelegates::PostReachabilityAnalysis.AddRaw(this, &UNRX4System::onPostReachabilityAnalysis);
+    frameArena_.initialize(UNRX4FrameArena::DefaultCapacity);
+    endFrameHandle_ = FCoreDelegates::OnEndFrame.AddRaw(this, &UNRX4System::endFrame);
+}
+
+void UNRX4System::terminate()
+{
+    FCoreUObjectDelegates::PostReachabilityAnalysis.Remove(postReachabilityAnalysisHandle_);
+    postReachabilityAnalysisHandle_.Reset();
+    FCoreDelegates::OnEndFrame.Remove(endFrameHandle_);
+    endFrameHandle_.Reset();
+    unrx4_internal_threadPoolScheduler_.wait();
+    unrx4_internal_objectSubscriptions_.clear();
+    unrx4_internal_eventBus_.clear();
+    unrx4_internal_reactiveProperties_.clear();
+    unrx4_internal_signalGraph_.clear();
+    unrx4_internal_currentThreadScheduuler_.run();
+    reclaimRemoteFrees();
+}
+
 void* UNRX4System::allocate(size_t size)
 {
-    return allocator_.allocate(size);
+    void* ptr;
+    if(ownerThread_ == FPlatformTLS::GetCurrentThreadId()) {
+        reclaimRemoteFrees();
+        ptr = allocator_.allocate(size);
+    } else {
+        //Other threads, e.g. continuations of UNRX4ObservableFromFuture, allocate from the heap
+        ptr = reinterpret_cast<unrx4::u8*>(FMemory::Malloc(HeapHeaderSize + size, HeapHeaderSize)) + HeapHeaderSize;
+        unrx4::setBlockTag(ptr, unrx4::BlockTag::Heap);
+    }
+    UNRX4_TRACE_ALLOCATE(ptr, size);
+    return ptr;
 }
 
 void UNRX4System::deallocate(void* ptr)
 {
-    allocator_.deallocate(ptr);
+    if(nullptr == ptr) {
+        return;
+    }
+    switch(unrx4::getBlockTag(ptr)) {
+    case unrx4::BlockTag::General:
+        UNRX4_TRACE_DEALLOCATE(ptr);
+        if(ownerThread_ == FPlatformTLS::GetCurrentThreadId()) {
+            allocator_.deallocate(ptr);
+        } else {
+            //Every block of the small allocator has room for a link
+            RemoteFree* block = reinterpret_cast<RemoteFree*>(ptr);
+            block->next_ = remoteFrees_.load(std::memory_order_relaxed);
+            while(!remoteFrees_.compare_exchange_weak(block->next_, block, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        break;
+    case unrx4::BlockTag::Heap:
+        UNRX4_TRACE_DEALLOCATE(ptr);
+        FMemory::Free(reinterpret_cast<unrx4::u8*>(ptr) - HeapHeaderSize);
+        break;
+    default:
+        //Transient and pipeline blocks are released with their frames and arenas
+        break;
+    }
+}
+
+void* UNRX4System::allocateTransient(unrx4::size_t size)
+{
+    return frameArena_.allocate(size);
+}
+
+void UNRX4System::endFrame()
+{
+    unrx4_internal_eventBus_.dispatch();
+    unrx4_internal_reactiveProperties_.flush();
+    unrx4_internal_priorityScheduler_.run();
+    unrx4_internal_currentThreadScheduuler_.run();
+    frameArena_.endFrame();
+}
+
+void* UNRX4System::acquirePipelineBlock()
+{
+    {
+        FScopeLock lock(&pipelineBlockLock_);
+        if(nullptr != pipelineBlocks_) {
+            PooledBlock* block = pipelineBlocks_;
+            pipelineBlocks_ = block->next_;
+            --numPipelineBlocks_;
+            return block;
+        }
+    }
+    return FMemory::Malloc(UNRX4PipelineArena::BlockSize, UNRX4PipelineArena::Alignment);
+}
+
+void UNRX4System::releasePipelineBlock(void* block)
+{
+    {
+        FScopeLock lock(&pipelineBlockLock_);
+        if(numPipelineBlocks_ < MaxPooledPipelineBlocks) {
+            PooledBlock* pooled = reinterpret_cast<PooledBlock*>(block);
+            pooled->next_ = pipelineBlocks_;
+            pipelineBlocks_ = pooled;
+            ++numPipelineBlocks_;
+            return;
+        }
+    }
+    FMemory::Free(block);
 }
 
 UNRX4ImmediateScheduler& UNRX4System::immediateScheduler()
@@ -59,3 +185,50 @@ UNRX4CurrentThreadScheduler& UNRX4System::currentThreadScheduler()
     return unrx4_internal_currentThreadScheduuler_;
 }
 
+UNRX4PriorityScheduler& UNRX4System::priorityScheduler()
+{
+    return unrx4_internal_priorityScheduler_;
+}
+
+UNRX4ThreadPoolScheduler& UNRX4System::threadPoolScheduler()
+{
+    return unrx4_internal_threadPoolScheduler_;
+}
+
+UNRX4ObjectSubscriptions& UNRX4System::objectSubscriptions()
+{
+    return unrx4_internal_objectSubscriptions_;
+}
+
+UNRX4EventBus& UNRX4System::eventBus()
+{
+    return unrx4_internal_eventBus_;
+}
+
+UNRX4ReactiveProperties& UNRX4System::reactiveProperties()
+{
+    return unrx4_internal_reactiveProperties_;
+}
+
+UNRX4SignalGraph& UNRX4System::signalGraph()
+{
+    return unrx4_internal_signalGraph_;
+}
+
+void UNRX4System::reclaimRemoteFrees()
+{
+    if(nullptr == remoteFrees_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    RemoteFree* block = remoteFrees_.exchange(nullptr, std::memory_order_acquire);
+    while(nullptr != block) {
+        RemoteFree* next = block->next_;
+        allocator_.deallocate(block);
+        block = next;
+    }
+}
+
+void UNRX4System::onPostReachabilityAnalysis()
+{
+    unrx4_internal_objectSubscriptions_.prune();
+}
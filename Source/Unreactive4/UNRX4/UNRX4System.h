@@ -18,10 +18,18 @@ IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMA
  */
 // clang-format on
 #include "UNRX4.h"
+#include "UNRX4FrameArena.h"
+#include <atomic>
 
 //-------------------
 class UNRX4ImmediateScheduler;
 class UNRX4CurrentThreadScheduler;
+class UNRX4PriorityScheduler;
+class UNRX4ThreadPoolScheduler;
+class UNRX4ObjectSubscriptions;
+class UNRX4EventBus;
+class UNRX4ReactiveProperties;
+class UNRX4SignalGraph;
 
 UNREACTIVE4_API
 class UNRX4System
@@ -29,11 +37,46 @@ class UNRX4System
 public:
     static UNRX4System& getInstance();
 
+    /**
+     * @brief Hook engine callbacks, call this at startup of the module
+     */
+    void initialize();
+    void terminate();
+
+    /**
+     * @brief Allocate from the small allocator without locking on the thread which owns the system, or from the heap on other threads
+     */
     void* allocate(unrx4::size_t size);
+
+    /**
+     * @brief Blocks of the small allocator freed on other threads are queued, then the owning thread returns them on its next allocation
+     */
     void deallocate(void* ptr);
 
+    /**
+     * @brief Allocate from the frame arena, which keeps blocks beyond its capacity until their frame is released
+     */
+    void* allocateTransient(unrx4::size_t size);
+
+    /**
+     * @brief Dispatch events of the bus, flush reactive properties, drain the priority and current thread schedulers, then release the oldest frame of the arena
+     */
+    void endFrame();
+
+    /**
+     * @brief Get a block of UNRX4PipelineArena::BlockSize bytes from the pool
+     */
+    void* acquirePipelineBlock();
+    void releasePipelineBlock(void* block);
+
     UNRX4ImmediateScheduler& immediateScheduler();
     UNRX4CurrentThreadScheduler& currentThreadScheduler();
+    UNRX4PriorityScheduler& priorityScheduler();
+    UNRX4ThreadPoolScheduler& threadPoolScheduler();
+    UNRX4ObjectSubscriptions& objectSubscriptions();
+    UNRX4EventBus& eventBus();
+    UNRX4ReactiveProperties& reactiveProperties();
+    UNRX4SignalGraph& signalGraph();
 
 private:
     UNRX4System(const UNRX4System&) = delete;
@@ -44,5 +87,27 @@ private:
     UNRX4System();
     ~UNRX4System();
 
+    void onPostReachabilityAnalysis();
+    void reclaimRemoteFrees();
+
+    FDelegateHandle postReachabilityAnalysisHandle_;
+    FDelegateHandle endFrameHandle_;
+    UNRX4FrameArena frameArena_;
+
+    static constexpr unrx4::size_t MaxPooledPipelineBlocks = 64;
+    struct PooledBlock
+    {
+        PooledBlock* next_;
+    };
+    FCriticalSection pipelineBlockLock_;
+    PooledBlock* pipelineBlocks_;
+    unrx4::size_t numPipelineBlocks_;
+    static constexpr unrx4::size_t HeapHeaderSize = 16;
+    struct RemoteFree
+    {
+        RemoteFree* next_;
+    };
+    unrx4::u32 ownerThread_;
+    std::atomic<RemoteFree*> remoteFrees_;
     UNRX4SmallAllocater allocator_;
 };
@@ -0,0 +1,67 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ThreadPoolScheduler.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4ThreadPoolScheduler.h"
+#include <Async/Async.h>
+
+UNRX4ThreadPoolScheduler::UNRX4ThreadPoolScheduler()
+    : pending_(0)
+{
+}
+
+UNRX4ThreadPoolScheduler::~UNRX4ThreadPoolScheduler()
+{
+    wait();
+}
+
+void UNRX4ThreadPoolScheduler::schedule(UNRX4Action action)
+{
+    pending_.fetch_add(1, std::memory_order_relaxed);
+#if UNRX4_PROFILER_ENABLED
+    //The stream current on the scheduling thread is carried to the worker
+    unrx4::u32 stream = UNRX4Profiler::currentStream();
+    if(UNRX4Profiler::InvalidStream == stream) {
+        stream = profile_.id();
+    }
+    unrx4::u64 scheduled = FPlatformTime::Cycles64();
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, action = std::move(action), stream, scheduled]() {
+        UNRX4Profiler::recordLatency(stream, FPlatformTime::Cycles64() - scheduled);
+        unrx4::u32 previous = UNRX4Profiler::exchangeCurrentStream(stream);
+        action();
+        UNRX4Profiler::exchangeCurrentStream(previous);
+        pending_.fetch_sub(1, std::memory_order_release);
+    });
+#else
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [this, action = std::move(action)]() {
+        action();
+        pending_.fetch_sub(1, std::memory_order_release);
+    });
+#endif
+}
+
+void UNRX4ThreadPoolScheduler::wait()
+{
+    while(0 < pending_.load(std::memory_order_acquire)) {
+        FPlatformProcess::Yield();
+    }
+}
+
+unrx4::s32 UNRX4ThreadPoolScheduler::pending() const
+{
+    return pending_.load(std::memory_order_relaxed);
+}
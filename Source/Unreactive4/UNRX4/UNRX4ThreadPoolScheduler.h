@@ -0,0 +1,51 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4ThreadPoolScheduler.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4IScheduler.h"
+#include "UNRX4Profiler.h"
+#include <atomic>
+
+/**
+ * @brief Run actions on background threads of the task graph
+ */
+class UNRX4ThreadPoolScheduler: public UNRX4IScheduler
+{
+public:
+    UNRX4ThreadPoolScheduler();
+    virtual ~UNRX4ThreadPoolScheduler();
+    virtual void schedule(UNRX4Action action) override;
+    virtual bool isThreadSafe() const override { return true; }
+
+    /**
+     * @brief Block until all scheduled actions finish
+     */
+    void wait();
+
+    /**
+     * @brief The number of actions which have not finished
+     */
+    unrx4::s32 pending() const;
+
+private:
+    UNRX4ThreadPoolScheduler(const UNRX4ThreadPoolScheduler&) = delete;
+    UNRX4ThreadPoolScheduler& operator=(const UNRX4ThreadPoolScheduler&) = delete;
+
+    std::atomic<unrx4::s32> pending_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4ThreadPoolScheduler");
+};
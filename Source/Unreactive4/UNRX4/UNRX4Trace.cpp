@@ -0,0 +1,97 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Trace.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Trace.h"
+
+#if UNRX4_TRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(UNRX4Channel)
+
+UE_TRACE_EVENT_BEGIN(UNRX4, Dispatch)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, Observable)
+    UE_TRACE_EVENT_FIELD(uint32, Subscribers)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(UNRX4, OperatorStage)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, Stage)
+    UE_TRACE_EVENT_FIELD(uint32, Subscribers)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(UNRX4, Drain)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, Scheduler)
+    UE_TRACE_EVENT_FIELD(uint32, Actions)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(UNRX4, Allocate)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, Address)
+    UE_TRACE_EVENT_FIELD(uint64, Size)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(UNRX4, Deallocate)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, Address)
+UE_TRACE_EVENT_END()
+
+namespace unrx4
+{
+namespace trace
+{
+    void dispatch(const void* observable, u32 subscribers)
+    {
+        UE_TRACE_LOG(UNRX4, Dispatch, UNRX4Channel)
+            << Dispatch.Cycle(FPlatformTime::Cycles64())
+            << Dispatch.Observable(reinterpret_cast<uint64>(observable))
+            << Dispatch.Subscribers(subscribers);
+    }
+
+    void operatorStage(const void* stage, u32 subscribers)
+    {
+        UE_TRACE_LOG(UNRX4, OperatorStage, UNRX4Channel)
+            << OperatorStage.Cycle(FPlatformTime::Cycles64())
+            << OperatorStage.Stage(reinterpret_cast<uint64>(stage))
+            << OperatorStage.Subscribers(subscribers);
+    }
+
+    void drain(const void* scheduler, u32 actions)
+    {
+        UE_TRACE_LOG(UNRX4, Drain, UNRX4Channel)
+            << Drain.Cycle(FPlatformTime::Cycles64())
+            << Drain.Scheduler(reinterpret_cast<uint64>(scheduler))
+            << Drain.Actions(actions);
+    }
+
+    void allocate(const void* ptr, size_t size)
+    {
+        UE_TRACE_LOG(UNRX4, Allocate, UNRX4Channel)
+            << Allocate.Cycle(FPlatformTime::Cycles64())
+            << Allocate.Address(reinterpret_cast<uint64>(ptr))
+            << Allocate.Size(static_cast<uint64>(size));
+    }
+
+    void deallocate(const void* ptr)
+    {
+        UE_TRACE_LOG(UNRX4, Deallocate, UNRX4Channel)
+            << Deallocate.Cycle(FPlatformTime::Cycles64())
+            << Deallocate.Address(reinterpret_cast<uint64>(ptr));
+    }
+} // namespace trace
+} // namespace unrx4
+#endif
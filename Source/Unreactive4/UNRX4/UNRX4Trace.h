@@ -0,0 +1,89 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Trace.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4.h"
+
+/**
+ * @brief Set UNRX4_TRACE_ENABLED to 0 to strip every trace point of the reactive system
+ */
+#ifndef UNRX4_TRACE_ENABLED
+#    if defined(UE_TRACE_ENABLED) && UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+#        define UNRX4_TRACE_ENABLED 1
+#    else
+#        define UNRX4_TRACE_ENABLED 0
+#    endif
+#endif
+
+#if UNRX4_TRACE_ENABLED
+#    include <Trace/Trace.h>
+#    include <ProfilingDebugging/CpuProfilerTrace.h>
+
+UE_TRACE_CHANNEL_EXTERN(UNRX4Channel, UNREACTIVE4_API)
+
+namespace unrx4
+{
+namespace trace
+{
+    /**
+     * @brief Emit a dispatch event, which identifies an observable and how many observers it has
+     */
+    UNREACTIVE4_API void dispatch(const void* observable, u32 subscribers);
+
+    /**
+     * @brief Emit an operator stage event
+     */
+    UNREACTIVE4_API void operatorStage(const void* stage, u32 subscribers);
+
+    /**
+     * @brief Emit an event of draining a scheduler
+     */
+    UNREACTIVE4_API void drain(const void* scheduler, u32 actions);
+
+    UNREACTIVE4_API void allocate(const void* ptr, size_t size);
+    UNREACTIVE4_API void deallocate(const void* ptr);
+} // namespace trace
+} // namespace unrx4
+
+#    define UNRX4_TRACE_SCOPE(NameStr) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(NameStr, UNRX4Channel)
+
+#    define UNRX4_TRACE_DISPATCH(NameStr, Observable, Subscribers) \
+        UNRX4_TRACE_SCOPE(NameStr); \
+        unrx4::trace::dispatch((Observable), static_cast<unrx4::u32>(Subscribers))
+
+#    define UNRX4_TRACE_OPERATOR(NameStr, Stage, Subscribers) \
+        UNRX4_TRACE_SCOPE(NameStr); \
+        unrx4::trace::operatorStage((Stage), static_cast<unrx4::u32>(Subscribers))
+
+#    define UNRX4_TRACE_DRAIN(NameStr, Scheduler, Actions) \
+        UNRX4_TRACE_SCOPE(NameStr); \
+        unrx4::trace::drain((Scheduler), static_cast<unrx4::u32>(Actions))
+
+#    define UNRX4_TRACE_ALLOCATE(Ptr, Size) unrx4::trace::allocate((Ptr), (Size))
+#    define UNRX4_TRACE_DEALLOCATE(Ptr) unrx4::trace::deallocate((Ptr))
+
+#else
+
+#    define UNRX4_TRACE_SCOPE(NameStr)
+#    define UNRX4_TRACE_DISPATCH(NameStr, Observable, Subscribers)
+#    define UNRX4_TRACE_OPERATOR(NameStr, Stage, Subscribers)
+#    define UNRX4_TRACE_DRAIN(NameStr, Scheduler, Actions)
+#    define UNRX4_TRACE_ALLOCATE(Ptr, Size)
+#    define UNRX4_TRACE_DEALLOCATE(Ptr)
+
+#endif
@@ -0,0 +1,37 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4UMG.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4UMG.h"
+#include <Components/ProgressBar.h>
+#include <Components/TextBlock.h>
+#include <Components/Widget.h>
+
+void UNRX4UMG::bindText(UTextBlock* widget, UNRX4ReactiveProperty<FText>& property)
+{
+    bind(widget, property, &UTextBlock::SetText);
+}
+
+void UNRX4UMG::bindPercent(UProgressBar* widget, UNRX4ReactiveProperty<float>& property)
+{
+    bind(widget, property, &UProgressBar::SetPercent);
+}
+
+void UNRX4UMG::bindVisibility(UWidget* widget, UNRX4ReactiveProperty<ESlateVisibility>& property)
+{
+    bind(widget, property, &UWidget::SetVisibility);
+}
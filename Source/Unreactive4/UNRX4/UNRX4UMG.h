@@ -0,0 +1,119 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4UMG.h
+ * @author t-sakai
+ */
+// clang-format on
+#include <UObject/WeakObjectPtrTemplates.h>
+#include "UNRX4ObjectSubscription.h"
+#include "UNRX4ReactiveProperty.h"
+#include "UNRX4System.h"
+#include <utility>
+
+class UWidget;
+class UTextBlock;
+class UProgressBar;
+enum class ESlateVisibility : uint8;
+
+namespace unrx4
+{
+namespace umg
+{
+    /**
+     * @brief Write a value with a member function of the widget
+     */
+    template<class W, class C, class R, class... Args, class T>
+    void set(W* widget, R (C::*setter)(Args...), const T& value)
+    {
+        (widget->*setter)(value);
+    }
+
+    /**
+     * @brief Write a value with a callable of (W*, const T&)
+     */
+    template<class W, class F, class T>
+    void set(W* widget, F& setter, const T& value)
+    {
+        setter(widget, value);
+    }
+} // namespace umg
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Observer which writes values into a widget, while the widget is alive
+ */
+template<class W, class T, class F>
+class UNRX4WidgetBinding: public UNRX4IObserver<T>
+{
+public:
+    UNRX4WidgetBinding(W* widget, F setter)
+        : widget_(widget)
+        , setter_(std::move(setter))
+    {
+    }
+
+    virtual void next(T value) override
+    {
+        W* widget = widget_.Get();
+        if(nullptr != widget) {
+            unrx4::umg::set(widget, setter_, value);
+        }
+    }
+
+    virtual void error(unrx4::error_code_type) override
+    {
+    }
+
+    virtual void completed() override
+    {
+    }
+
+private:
+    TWeakObjectPtr<W> widget_;
+    F setter_;
+};
+
+//-------------------
+/**
+ * @brief Bind reactive properties to widgets, instead of attribute bindings which are evaluated every tick
+ *
+ * A widget is written once with the current value, then once per frame only if the value has changed.
+ * Bindings are released after the widget has been garbage collected, or when the property is destroyed.
+ */
+UNREACTIVE4_API
+class UNRX4UMG
+{
+public:
+    /**
+     * @param setter ... A member function of W, or a callable of (W*, const T&)
+     */
+    template<class W, class T, class Equal, class F>
+    static void bind(W* widget, UNRX4ReactiveProperty<T, Equal>& property, F setter);
+
+    static void bindText(UTextBlock* widget, UNRX4ReactiveProperty<FText>& property);
+    static void bindPercent(UProgressBar* widget, UNRX4ReactiveProperty<float>& property);
+    static void bindVisibility(UWidget* widget, UNRX4ReactiveProperty<ESlateVisibility>& property);
+};
+
+template<class W, class T, class Equal, class F>
+void UNRX4UMG::bind(W* widget, UNRX4ReactiveProperty<T, Equal>& property, F setter)
+{
+    UNRX4_ASSERT(nullptr != widget);
+    unrx4::umg::set(widget, setter, property.get());
+    unrx4_unique_ptr<UNRX4IObserver<T>> binding(unrx4_construct<UNRX4WidgetBinding<W, T, F>>(widget, std::move(setter)));
+    UNRX4System::getInstance().objectSubscriptions().subscribe(widget, static_cast<UNRX4IObservable<T>*>(&property), std::move(binding));
+}
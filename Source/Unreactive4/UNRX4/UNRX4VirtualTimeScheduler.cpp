@@ -0,0 +1,167 @@
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4VirtualTimeScheduler.cpp
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4VirtualTimeScheduler.h"
+#include "UNRX4Trace.h"
+
+UNRX4VirtualTimeScheduler::UNRX4VirtualTimeScheduler(unrx4::time_point start)
+    : now_(start.GetTicks())
+    , sequence_(0)
+{
+}
+
+UNRX4VirtualTimeScheduler::~UNRX4VirtualTimeScheduler()
+{
+}
+
+unrx4::time_point UNRX4VirtualTimeScheduler::now() const
+{
+    return FDateTime(now_);
+}
+
+void UNRX4VirtualTimeScheduler::schedule(UNRX4Action action)
+{
+    scheduleAt(std::move(action), FDateTime(now_));
+}
+
+void UNRX4VirtualTimeScheduler::schedule(UNRX4Action action, FTimespan delay)
+{
+    scheduleAt(std::move(action), FDateTime(now_) + delay);
+}
+
+void UNRX4VirtualTimeScheduler::scheduleAt(UNRX4Action action, unrx4::time_point due)
+{
+    if(!action) {
+        return;
+    }
+    Entry entry;
+    //Actions cannot run in the past
+    entry.due_ = FMath::Max(due.GetTicks(), now_);
+    entry.sequence_ = sequence_++;
+    entry.action_ = std::move(action);
+#if UNRX4_PROFILER_ENABLED
+    entry.stream_ = UNRX4Profiler::currentStream();
+    if(UNRX4Profiler::InvalidStream == entry.stream_) {
+        entry.stream_ = profile_.id();
+    }
+    entry.scheduled_ = FPlatformTime::Cycles64();
+#endif
+    heap_.push_back(std::move(entry));
+    siftUp(heap_.size() - 1);
+}
+
+unrx4::u32 UNRX4VirtualTimeScheduler::advanceTo(unrx4::time_point time)
+{
+    unrx4::s64 ticks = time.GetTicks();
+    unrx4::u32 count = runUntil(ticks);
+    now_ = FMath::Max(now_, ticks);
+    return count;
+}
+
+unrx4::u32 UNRX4VirtualTimeScheduler::advanceBy(FTimespan span)
+{
+    return advanceTo(FDateTime(now_) + span);
+}
+
+unrx4::u32 UNRX4VirtualTimeScheduler::run()
+{
+    return runUntil(TNumericLimits<unrx4::s64>::Max());
+}
+
+unrx4::size_t UNRX4VirtualTimeScheduler::size() const
+{
+    return heap_.size();
+}
+
+bool UNRX4VirtualTimeScheduler::less(const Entry& x0, const Entry& x1)
+{
+    if(x0.due_ != x1.due_) {
+        return x0.due_ < x1.due_;
+    }
+    return x0.sequence_ < x1.sequence_;
+}
+
+unrx4::u32 UNRX4VirtualTimeScheduler::runUntil(unrx4::s64 ticks)
+{
+    UNRX4_TRACE_DRAIN("UNRX4VirtualTimeScheduler::run", this, heap_.size());
+    unrx4::u32 count = 0;
+    while(0 < heap_.size() && heap_[0].due_ <= ticks) {
+        Entry entry;
+        pop(entry);
+        now_ = entry.due_;
+#if UNRX4_PROFILER_ENABLED
+        UNRX4Profiler::recordLatency(entry.stream_, FPlatformTime::Cycles64() - entry.scheduled_);
+        unrx4::u32 previous = UNRX4Profiler::exchangeCurrentStream(entry.stream_);
+        entry.action_();
+        UNRX4Profiler::exchangeCurrentStream(previous);
+#else
+        entry.action_();
+#endif
+        ++count;
+    }
+    return count;
+}
+
+void UNRX4VirtualTimeScheduler::pop(Entry& entry)
+{
+    UNRX4_ASSERT(0 < heap_.size());
+    entry = std::move(heap_[0]);
+    unrx4::size_t last = heap_.size() - 1;
+    if(0 < last) {
+        heap_[0] = std::move(heap_[last]);
+    }
+    heap_.pop_back();
+    if(0 < heap_.size()) {
+        siftDown(0);
+    }
+}
+
+void UNRX4VirtualTimeScheduler::siftUp(unrx4::size_t index)
+{
+    Entry entry = std::move(heap_[index]);
+    while(0 < index) {
+        unrx4::size_t parent = (index - 1) >> 1;
+        if(!less(entry, heap_[parent])) {
+            break;
+        }
+        heap_[index] = std::move(heap_[parent]);
+        index = parent;
+    }
+    heap_[index] = std::move(entry);
+}
+
+void UNRX4VirtualTimeScheduler::siftDown(unrx4::size_t index)
+{
+    unrx4::size_t size = heap_.size();
+    Entry entry = std::move(heap_[index]);
+    for(;;) {
+        unrx4::size_t child = (index << 1) + 1;
+        if(size <= child) {
+            break;
+        }
+        if((child + 1) < size && less(heap_[child + 1], heap_[child])) {
+            ++child;
+        }
+        if(!less(heap_[child], entry)) {
+            break;
+        }
+        heap_[index] = std::move(heap_[child]);
+        index = child;
+    }
+    heap_[index] = std::move(entry);
+}
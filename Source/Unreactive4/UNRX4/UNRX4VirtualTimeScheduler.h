@@ -0,0 +1,87 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4VirtualTimeScheduler.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4Container.h"
+#include "UNRX4IScheduler.h"
+#include "UNRX4Profiler.h"
+
+//-------------------
+/**
+ * @brief Scheduler with a virtual clock, which only advances when told to
+ *
+ * Actions run in order of due times, and in order of scheduling for equal due times.
+ * The clock jumps to the due time of each action before running it, so timed sources replay deterministically and as fast as possible.
+ * Latencies for the profiler are in real cycles from scheduling, which include the time until the clock is advanced.
+ */
+class UNRX4VirtualTimeScheduler: public UNRX4IScheduler
+{
+public:
+    explicit UNRX4VirtualTimeScheduler(unrx4::time_point start = FDateTime(0));
+    virtual ~UNRX4VirtualTimeScheduler();
+
+    virtual unrx4::time_point now() const override;
+
+    /**
+     * @brief Schedule an action at the current virtual time
+     */
+    virtual void schedule(UNRX4Action action) override;
+    void schedule(UNRX4Action action, FTimespan delay);
+    void scheduleAt(UNRX4Action action, unrx4::time_point due);
+
+    /**
+     * @brief Run actions due until the time, then set the clock to the time
+     * @return The number of actions which ran
+     */
+    unrx4::u32 advanceTo(unrx4::time_point time);
+    unrx4::u32 advanceBy(FTimespan span);
+
+    /**
+     * @brief Run actions until the queue is empty, including actions scheduled by them
+     */
+    unrx4::u32 run();
+
+    unrx4::size_t size() const;
+
+private:
+    UNRX4VirtualTimeScheduler(const UNRX4VirtualTimeScheduler&) = delete;
+    UNRX4VirtualTimeScheduler& operator=(const UNRX4VirtualTimeScheduler&) = delete;
+
+    struct Entry
+    {
+        unrx4::s64 due_;
+        unrx4::u64 sequence_;
+        UNRX4Action action_;
+#if UNRX4_PROFILER_ENABLED
+        unrx4::u32 stream_;
+        unrx4::u64 scheduled_;
+#endif
+    };
+
+    static bool less(const Entry& x0, const Entry& x1);
+
+    unrx4::u32 runUntil(unrx4::s64 ticks);
+    void pop(Entry& entry);
+    void siftUp(unrx4::size_t index);
+    void siftDown(unrx4::size_t index);
+
+    UNRX4Array<Entry> heap_;
+    unrx4::s64 now_;
+    unrx4::u64 sequence_;
+    UNRX4_PROFILE_STREAM(profile_, "UNRX4VirtualTimeScheduler");
+};
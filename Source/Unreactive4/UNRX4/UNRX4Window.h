@@ -0,0 +1,486 @@
+#pragma once
+// clang-format off
+/*
+Copyright (c) 2021 Takuro Sakai
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+/**
+ * @file UNRX4Window.h
+ * @author t-sakai
+ */
+// clang-format on
+#include "UNRX4IScheduler.h"
+#include "UNRX4Numeric.h"
+#include <type_traits>
+
+//-------------------
+/**
+ * @brief Aggregates of values in a window
+ *
+ * Minimum and maximum are zero for an empty window.
+ */
+template<class T>
+struct UNRX4WindowStats
+{
+    using traits_type = UNRX4NumericTraits<T>;
+    using accumulate_type = typename traits_type::accumulate_type;
+
+    unrx4::size_t count_;
+    accumulate_type sum_;
+    T min_;
+    T max_;
+
+    UNRX4WindowStats();
+    void reset();
+    void add(const T& value);
+    accumulate_type average() const;
+};
+
+template<class T>
+UNRX4WindowStats<T>::UNRX4WindowStats()
+    : count_(0)
+    , sum_(traits_type::zero())
+    , min_{}
+    , max_{}
+{
+}
+
+template<class T>
+void UNRX4WindowStats<T>::reset()
+{
+    count_ = 0;
+    sum_ = traits_type::zero();
+    min_ = T{};
+    max_ = T{};
+}
+
+template<class T>
+void UNRX4WindowStats<T>::add(const T& value)
+{
+    sum_ = traits_type::add(sum_, value);
+    min_ = 0 < count_ ? traits_type::minimum(min_, value) : value;
+    max_ = 0 < count_ ? traits_type::maximum(max_, value) : value;
+    ++count_;
+}
+
+template<class T>
+typename UNRX4WindowStats<T>::accumulate_type UNRX4WindowStats<T>::average() const
+{
+    return 0 < count_ ? traits_type::divide(sum_, count_) : traits_type::zero();
+}
+
+namespace unrx4
+{
+namespace window
+{
+    /**
+     * @brief The clock of the scheduler, or the monotonic platform clock, which does not jump with daylight saving time or clock adjustments
+     */
+    inline unrx4::time_point now(const UNRX4IScheduler* scheduler)
+    {
+        return nullptr != scheduler ? scheduler->now() : FDateTime(static_cast<unrx4::s64>(FPlatformTime::Seconds() * ETimespan::TicksPerSecond));
+    }
+} // namespace window
+} // namespace unrx4
+
+//-------------------
+/**
+ * @brief Emit stats of each count values, windows do not overlap
+ */
+template<class T>
+class UNRX4WindowCount: public UNRX4Operator<UNRX4WindowCount<T>, T, UNRX4WindowStats<T>>
+{
+    using base_type = UNRX4Operator<UNRX4WindowCount<T>, T, UNRX4WindowStats<T>>;
+    friend base_type;
+
+public:
+    UNRX4WindowCount(UNRX4IObservable<T>* source, unrx4::size_t count);
+
+private:
+    void onNext(const T& value);
+    void onCompleted();
+
+    unrx4::size_t count_;
+    UNRX4WindowStats<T> stats_;
+};
+
+template<class T>
+UNRX4WindowCount<T>::UNRX4WindowCount(UNRX4IObservable<T>* source, unrx4::size_t count)
+    : base_type(source)
+    , count_(0 < count ? count : 1)
+{
+}
+
+template<class T>
+void UNRX4WindowCount<T>::onNext(const T& value)
+{
+    stats_.add(value);
+    if(count_ <= stats_.count_) {
+        this->emit(stats_);
+        stats_.reset();
+    }
+}
+
+template<class T>
+void UNRX4WindowCount<T>::onCompleted()
+{
+    if(0 < stats_.count_) {
+        this->emit(stats_);
+        stats_.reset();
+    }
+    this->completed();
+}
+
+//-------------------
+/**
+ * @brief Emit stats of each span of time, windows do not overlap
+ *
+ * A window closes at the first value or tick after its span, then empty windows are emitted too, so that rates can drop to zero.
+ * Spans which elapsed without any value or tick are not emitted.
+ */
+template<class T>
+class UNRX4WindowTime: public UNRX4Operator<UNRX4WindowTime<T>, T, UNRX4WindowStats<T>>
+{
+    using base_type = UNRX4Operator<UNRX4WindowTime<T>, T, UNRX4WindowStats<T>>;
+    friend base_type;
+
+public:
+    /**
+     * @param scheduler ... The clock, the monotonic platform clock if null
+     */
+    UNRX4WindowTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler);
+
+    /**
+     * @brief Close the window if its span has elapsed, call this every frame for sources which can stop emitting
+     */
+    void tick();
+
+private:
+    void onNext(const T& value);
+    void onCompleted();
+    void close(unrx4::time_point now);
+
+    FTimespan span_;
+    UNRX4IScheduler* scheduler_;
+    unrx4::time_point end_;
+    bool open_;
+    UNRX4WindowStats<T> stats_;
+};
+
+template<class T>
+UNRX4WindowTime<T>::UNRX4WindowTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler)
+    : base_type(source)
+    , span_(span)
+    , scheduler_(scheduler)
+    , open_(false)
+{
+}
+
+template<class T>
+void UNRX4WindowTime<T>::tick()
+{
+    unrx4::time_point now = unrx4::window::now(scheduler_);
+    if(open_ && end_ <= now) {
+        close(now);
+    }
+}
+
+template<class T>
+void UNRX4WindowTime<T>::onNext(const T& value)
+{
+    unrx4::time_point now = unrx4::window::now(scheduler_);
+    if(!open_) {
+        open_ = true;
+        end_ = now + span_;
+    } else if(end_ <= now) {
+        close(now);
+    }
+    stats_.add(value);
+}
+
+template<class T>
+void UNRX4WindowTime<T>::onCompleted()
+{
+    if(0 < stats_.count_) {
+        this->emit(stats_);
+        stats_.reset();
+    }
+    open_ = false;
+    this->completed();
+}
+
+template<class T>
+void UNRX4WindowTime<T>::close(unrx4::time_point now)
+{
+    this->emit(stats_);
+    stats_.reset();
+    //Keep windows aligned to spans unless whole spans have elapsed
+    end_ = end_ + span_;
+    if(end_ <= now) {
+        end_ = now + span_;
+    }
+}
+
+//-------------------
+/**
+ * @brief Emit stats of the last count values every skip values, windows overlap if skip is less than count
+ *
+ * Values are kept in a ring buffer, and the sum is updated incrementally.
+ * Minimum and maximum are the fronts of monotonic deques, then every value costs amortized O(1) regardless of count.
+ * Until count values arrive, stats are of the values so far.
+ */
+template<class T>
+class UNRX4SlidingWindow: public UNRX4Operator<UNRX4SlidingWindow<T>, T, UNRX4WindowStats<T>>
+{
+    using traits_type = UNRX4NumericTraits<T>;
+    using base_type = UNRX4Operator<UNRX4SlidingWindow<T>, T, UNRX4WindowStats<T>>;
+    friend base_type;
+
+    static_assert(std::is_same<T, typename traits_type::scalar_type>::value, "Monotonic deques need ordered values, vectors are not supported.");
+
+public:
+    UNRX4SlidingWindow(UNRX4IObservable<T>* source, unrx4::size_t count, unrx4::size_t skip);
+
+private:
+    struct Entry
+    {
+        unrx4::u64 sequence_;
+        T value_;
+    };
+
+    void onNext(const T& value);
+    void onCompleted();
+
+    unrx4::size_t skip_;
+    unrx4::size_t pending_;
+    unrx4::size_t evicted_;
+    unrx4::u64 sequence_;
+    typename traits_type::accumulate_type sum_;
+    UNRX4RingBuffer<T> values_;
+    UNRX4RingBuffer<Entry> minimums_;
+    UNRX4RingBuffer<Entry> maximums_;
+};
+
+template<class T>
+UNRX4SlidingWindow<T>::UNRX4SlidingWindow(UNRX4IObservable<T>* source, unrx4::size_t count, unrx4::size_t skip)
+    : base_type(source)
+    , skip_(0 < skip ? skip : 1)
+    , pending_(0)
+    , evicted_(0)
+    , sequence_(0)
+    , sum_(traits_type::zero())
+    , values_(0 < count ? count : 1)
+    , minimums_(0 < count ? count : 1)
+    , maximums_(0 < count ? count : 1)
+{
+}
+
+template<class T>
+void UNRX4SlidingWindow<T>::onNext(const T& value)
+{
+    unrx4::size_t capacity = values_.capacity();
+    if(values_.full()) {
+        sum_ = traits_type::subtract(sum_, values_.front());
+        values_.pop_front();
+        unrx4::u64 oldest = sequence_ - capacity;
+        if(!minimums_.empty() && minimums_.front().sequence_ <= oldest) {
+            minimums_.pop_front();
+        }
+        if(!maximums_.empty() && maximums_.front().sequence_ <= oldest) {
+            maximums_.pop_front();
+        }
+        ++evicted_;
+    }
+    values_.push_back(value);
+    sum_ = traits_type::add(sum_, value);
+    if(capacity <= evicted_) {
+        //Recompute the sum once per window against rounding errors of floats, O(1) amortized
+        evicted_ = 0;
+        sum_ = traits_type::zero();
+        for(unrx4::size_t i = 0; i < values_.size(); ++i) {
+            sum_ = traits_type::add(sum_, values_[i]);
+        }
+    }
+    while(!minimums_.empty() && !(minimums_.back().value_ < value)) {
+        minimums_.pop_back();
+    }
+    minimums_.push_back({sequence_, value});
+    while(!maximums_.empty() && !(value < maximums_.back().value_)) {
+        maximums_.pop_back();
+    }
+    maximums_.push_back({sequence_, value});
+    ++sequence_;
+
+    ++pending_;
+    if(skip_ <= pending_) {
+        pending_ = 0;
+        UNRX4WindowStats<T> stats;
+        stats.count_ = values_.size();
+        stats.sum_ = sum_;
+        stats.min_ = minimums_.front().value_;
+        stats.max_ = maximums_.front().value_;
+        this->emit(stats);
+    }
+}
+
+template<class T>
+void UNRX4SlidingWindow<T>::onCompleted()
+{
+    values_.clear();
+    minimums_.clear();
+    maximums_.clear();
+    sum_ = traits_type::zero();
+    pending_ = 0;
+    evicted_ = 0;
+    this->completed();
+}
+
+//-------------------
+/**
+ * @brief Collect values of each span of time into batches
+ *
+ * The buffer is reused, then batches are valid only while being emitted. Empty batches are not emitted.
+ */
+template<class T>
+class UNRX4BufferTime: public UNRX4Operator<UNRX4BufferTime<T>, T, UNRX4Batch<T>>
+{
+    using base_type = UNRX4Operator<UNRX4BufferTime<T>, T, UNRX4Batch<T>>;
+    friend base_type;
+
+public:
+    static constexpr unrx4::size_t DefaultCapacity = 1024;
+
+    /**
+     * @param scheduler ... The clock, the monotonic platform clock if null
+     * @param capacity ... The maximum number of values in a buffer, a full buffer is emitted before its span elapses
+     */
+    UNRX4BufferTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler, unrx4::size_t capacity = DefaultCapacity);
+
+    /**
+     * @brief Emit the buffer if its span has elapsed
+     */
+    void tick();
+
+private:
+    void onNext(const T& value);
+    void onCompleted();
+    void flush();
+
+    FTimespan span_;
+    UNRX4IScheduler* scheduler_;
+    unrx4::size_t capacity_;
+    unrx4::time_point end_;
+    UNRX4Array<T> values_;
+};
+
+template<class T>
+UNRX4BufferTime<T>::UNRX4BufferTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler, unrx4::size_t capacity)
+    : base_type(source)
+    , span_(span)
+    , scheduler_(scheduler)
+    , capacity_(0 < capacity ? capacity : 1)
+{
+    //Buffers never grow beyond the capacity, then allocate once
+    values_.reserve(capacity_);
+}
+
+template<class T>
+void UNRX4BufferTime<T>::tick()
+{
+    if(0 < values_.size() && end_ <= unrx4::window::now(scheduler_)) {
+        flush();
+    }
+}
+
+template<class T>
+void UNRX4BufferTime<T>::onNext(const T& value)
+{
+    unrx4::time_point now = unrx4::window::now(scheduler_);
+    if(0 < values_.size() && end_ <= now) {
+        flush();
+    }
+    if(values_.size() <= 0) {
+        end_ = now + span_;
+    }
+    values_.push_back(value);
+    if(capacity_ <= values_.size()) {
+        flush();
+    }
+}
+
+template<class T>
+void UNRX4BufferTime<T>::onCompleted()
+{
+    if(0 < values_.size()) {
+        flush();
+    }
+    this->completed();
+}
+
+template<class T>
+void UNRX4BufferTime<T>::flush()
+{
+    this->emit(UNRX4Batch<T>(values_.cbegin(), static_cast<int32>(values_.size())));
+    values_.clear();
+}
+
+//-------------------
+/**
+ * @brief Factories of windowing operators for rolling metrics
+ *
+ * Stages are owned by the caller, and subscribe their source while they have observers.
+ */
+class UNRX4Window
+{
+public:
+    template<class T>
+    static unrx4_unique_ptr<UNRX4WindowCount<T>> window(UNRX4IObservable<T>* source, unrx4::size_t count);
+
+    /**
+     * @param scheduler ... The clock, the monotonic platform clock if null
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4WindowTime<T>> window(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler = nullptr);
+
+    template<class T>
+    static unrx4_unique_ptr<UNRX4SlidingWindow<T>> slidingWindow(UNRX4IObservable<T>* source, unrx4::size_t count, unrx4::size_t skip = 1);
+
+    /**
+     * @param scheduler ... The clock, the monotonic platform clock if null
+     * @param capacity ... The maximum number of values in a buffer, a full buffer is emitted before its span elapses
+     */
+    template<class T>
+    static unrx4_unique_ptr<UNRX4BufferTime<T>> bufferTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler = nullptr, unrx4::size_t capacity = UNRX4BufferTime<T>::DefaultCapacity);
+};
+
+template<class T>
+unrx4_unique_ptr<UNRX4WindowCount<T>> UNRX4Window::window(UNRX4IObservable<T>* source, unrx4::size_t count)
+{
+    return unrx4_make_unique<UNRX4WindowCount<T>>(source, count);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4WindowTime<T>> UNRX4Window::window(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler)
+{
+    return unrx4_make_unique<UNRX4WindowTime<T>>(source, span, scheduler);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4SlidingWindow<T>> UNRX4Window::slidingWindow(UNRX4IObservable<T>* source, unrx4::size_t count, unrx4::size_t skip)
+{
+    return unrx4_make_unique<UNRX4SlidingWindow<T>>(source, count, skip);
+}
+
+template<class T>
+unrx4_unique_ptr<UNRX4BufferTime<T>> UNRX4Window::bufferTime(UNRX4IObservable<T>* source, FTimespan span, UNRX4IScheduler* scheduler, unrx4::size_t capacity)
+{
+    return unrx4_make_unique<UNRX4BufferTime<T>>(source, span, scheduler, capacity);
+}
@@ -2,5 +2,20 @@
 
 #include "Unreactive4.h"
 #include "Modules/ModuleManager.h"
+#include "UNRX4/UNRX4System.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Unreactive4, "Unreactive4" );
+class FUnreactive4Module : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		UNRX4System::getInstance().initialize();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		UNRX4System::getInstance().terminate();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FUnreactive4Module, Unreactive4, "Unreactive4" );